@@ -0,0 +1,163 @@
+/// @file
+/// Counts the heap allocations of building, copying, reading and freeing a
+/// bank, with and without an arena.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sf2cute.hpp>
+
+using namespace sf2cute;
+
+/// The number of heap allocations since the start of the program.
+static std::atomic<size_t> num_heap_allocations(0);
+
+/// Counts a heap allocation.
+void * operator new(size_t size) {
+  num_heap_allocations++;
+  void * memory = malloc(size != 0 ? size : 1);
+  if (memory == nullptr) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+/// Frees a heap allocation.
+void operator delete(void * memory) noexcept {
+  free(memory);
+}
+
+/// Frees a heap allocation.
+void operator delete(void * memory, size_t) noexcept {
+  free(memory);
+}
+
+/// Counts a heap allocation of an array.
+void * operator new[](size_t size) {
+  return operator new(size);
+}
+
+/// Frees a heap allocation of an array.
+void operator delete[](void * memory) noexcept {
+  operator delete(memory);
+}
+
+/// Frees a heap allocation of an array.
+void operator delete[](void * memory, size_t) noexcept {
+  operator delete(memory);
+}
+
+/// Builds a bank with the specified number of zones.
+/// @param arena the arena of the bank, or nullptr.
+/// @param num_instruments the number of instruments, each with one preset.
+/// @param num_zones the number of zones per preset and per instrument.
+/// @return the bank.
+SoundFont MakeBank(std::shared_ptr<SFArena> arena, size_t num_instruments, size_t num_zones) {
+  SoundFont sf2(std::move(arena));
+  std::vector<std::shared_ptr<SFSample>> samples;
+  for (size_t index = 0; index < num_instruments; index++) {
+    samples.push_back(sf2.NewSample("Sample " + std::to_string(index),
+      std::vector<int16_t>(64, int16_t(index)), 0, 64, 44100, 60, 0));
+  }
+
+  std::vector<std::shared_ptr<SFInstrument>> instruments;
+  for (size_t index = 0; index < num_instruments; index++) {
+    std::vector<SFInstrumentZone> zones;
+    for (size_t zone = 0; zone < num_zones; zone++) {
+      zones.push_back(SFInstrumentZone(samples[(index + zone) % samples.size()],
+        std::vector<SFGeneratorItem>{ SFGeneratorItem(SFGenerator::kPan, int16_t(zone)) },
+        std::vector<SFModulatorItem>{ SFModulatorItem(SFModulator(0), SFGenerator::kPan,
+          int16_t(zone), SFModulator(0), SFTransform::kLinear) }));
+    }
+    instruments.push_back(sf2.NewInstrument("Instrument " + std::to_string(index), std::move(zones)));
+  }
+
+  for (size_t index = 0; index < num_instruments; index++) {
+    std::vector<SFPresetZone> zones;
+    for (size_t zone = 0; zone < num_zones; zone++) {
+      zones.push_back(SFPresetZone(instruments[(index + zone) % instruments.size()]));
+    }
+    sf2.NewPreset("Preset " + std::to_string(index), uint16_t(index % 128), uint16_t(index / 128),
+      std::move(zones));
+  }
+  return sf2;
+}
+
+/// Prints the allocations and the time of an operation.
+/// @param name the name of the operation.
+/// @param num_allocations the number of heap allocations.
+/// @param seconds the elapsed time, in seconds.
+void PrintRow(const std::string & name, size_t num_allocations, double seconds) {
+  std::cout << std::setw(22) << name << std::setw(14) << num_allocations
+    << std::setw(12) << std::fixed << std::setprecision(3) << seconds * 1000 << std::endl;
+}
+
+/// Counts the heap allocations of building, copying, reading and freeing a bank.
+/// @param argc Number of arguments.
+/// @param argv Argument vector: number of instruments, number of zones per instrument.
+/// @return 0 on success.
+int main(int argc, char * argv[]) {
+  const size_t num_instruments = argc > 1 ? strtoul(argv[1], nullptr, 10) : 500;
+  const size_t num_zones = argc > 2 ? strtoul(argv[2], nullptr, 10) : 50;
+
+  try {
+    std::cout << num_instruments * num_zones * 2 << " zones" << std::endl;
+    std::cout << std::setw(22) << "operation" << std::setw(14) << "allocations"
+      << std::setw(12) << "ms" << std::endl;
+
+    std::string image;
+    for (int use_arena = 0; use_arena <= 1; use_arena++) {
+      const std::string suffix = use_arena ? " (arena)" : "";
+      const auto make_arena = [use_arena]() {
+        return use_arena ? std::make_shared<SFArena>() : std::shared_ptr<SFArena>();
+      };
+
+      size_t count = num_heap_allocations;
+      auto start = std::chrono::steady_clock::now();
+      std::unique_ptr<SoundFont> sf2(new SoundFont(MakeBank(make_arena(), num_instruments, num_zones)));
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      PrintRow("build" + suffix, num_heap_allocations - count, elapsed.count());
+
+      count = num_heap_allocations;
+      start = std::chrono::steady_clock::now();
+      std::unique_ptr<SoundFont> copy(new SoundFont(*sf2));
+      elapsed = std::chrono::steady_clock::now() - start;
+      PrintRow("copy" + suffix, num_heap_allocations - count, elapsed.count());
+
+      if (image.empty()) {
+        std::ostringstream out;
+        sf2->Write(out);
+        image = out.str();
+      }
+
+      count = num_heap_allocations;
+      start = std::chrono::steady_clock::now();
+      std::istringstream in(image);
+      std::unique_ptr<SoundFont> read(new SoundFont(SoundFont::Read(in, make_arena())));
+      elapsed = std::chrono::steady_clock::now() - start;
+      PrintRow("read" + suffix, num_heap_allocations - count, elapsed.count());
+
+      start = std::chrono::steady_clock::now();
+      sf2.reset();
+      copy.reset();
+      read.reset();
+      elapsed = std::chrono::steady_clock::now() - start;
+      PrintRow("free" + suffix, 0, elapsed.count());
+    }
+    return 0;
+  }
+  catch (const std::exception & e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
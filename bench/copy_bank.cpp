@@ -0,0 +1,90 @@
+/// @file
+/// Measures the time to copy a SoundFont against the number of zones.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sf2cute.hpp>
+
+using namespace sf2cute;
+
+/// Builds a bank with the specified number of zones.
+/// @param num_instruments the number of instruments, each with one preset.
+/// @param num_zones the number of zones per preset and per instrument.
+/// @param num_samples the number of samples.
+/// @return the bank.
+SoundFont MakeBank(size_t num_instruments, size_t num_zones, size_t num_samples) {
+  SoundFont sf2;
+  std::vector<std::shared_ptr<SFSample>> samples;
+  for (size_t index = 0; index < num_samples; index++) {
+    samples.push_back(sf2.NewSample("Sample " + std::to_string(index),
+      std::vector<int16_t>(64, int16_t(index)), 0, 64, 44100, 60, 0));
+  }
+
+  std::vector<std::shared_ptr<SFInstrument>> instruments;
+  for (size_t index = 0; index < num_instruments; index++) {
+    std::shared_ptr<SFInstrument> instrument = sf2.NewInstrument("Instrument " + std::to_string(index));
+    for (size_t zone = 0; zone < num_zones; zone++) {
+      instrument->AddZone(SFInstrumentZone(samples[(index * num_zones + zone) % samples.size()],
+        std::vector<SFGeneratorItem>{ SFGeneratorItem(SFGenerator::kPan, int16_t(zone)) },
+        std::vector<SFModulatorItem>{}));
+    }
+    instruments.push_back(std::move(instrument));
+  }
+
+  for (size_t index = 0; index < num_instruments; index++) {
+    std::vector<SFPresetZone> zones;
+    for (size_t zone = 0; zone < num_zones; zone++) {
+      zones.push_back(SFPresetZone(instruments[(index + zone) % instruments.size()]));
+    }
+    sf2.NewPreset("Preset " + std::to_string(index), uint16_t(index % 128), uint16_t(index / 128),
+      std::move(zones));
+  }
+  return sf2;
+}
+
+/// Measures the time to copy a SoundFont against the number of zones.
+/// @param argc Number of arguments.
+/// @param argv Argument vector: number of instruments, number of samples, number of runs.
+/// @return 0 on success.
+int main(int argc, char * argv[]) {
+  const size_t num_instruments = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000;
+  const size_t num_samples = argc > 2 ? strtoul(argv[2], nullptr, 10) : 1000;
+  const int repeat = argc > 3 ? atoi(argv[3]) : 5;
+
+  try {
+    std::cout << std::setw(12) << "zones" << std::setw(14) << "copy ms"
+      << std::setw(14) << "ns/zone" << std::endl;
+
+    for (size_t num_zones = 1; num_instruments * num_zones * 2 <= 400000; num_zones *= 2) {
+      const SoundFont sf2 = MakeBank(num_instruments, num_zones, num_samples);
+      const size_t total_zones = num_instruments * num_zones * 2;
+
+      double best = 0;
+      for (int round = 0; round < repeat; round++) {
+        const auto start = std::chrono::steady_clock::now();
+        const SoundFont copy(sf2);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (round == 0 || elapsed.count() < best) {
+          best = elapsed.count();
+        }
+      }
+
+      std::cout << std::setw(12) << total_zones
+        << std::setw(14) << std::fixed << std::setprecision(3) << best * 1000
+        << std::setw(14) << std::setprecision(1) << best * 1e9 / total_zones << std::endl;
+    }
+    return 0;
+  }
+  catch (const std::exception & e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,109 @@
+/// @file
+/// Measures the time to find presets, instruments and samples, and checks
+/// that lookups follow renamed, renumbered and assigned elements.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sf2cute.hpp>
+
+using namespace sf2cute;
+
+/// Builds a bank with the specified number of elements.
+/// @param num_elements the number of presets, instruments and samples.
+/// @return the bank.
+SoundFont MakeBank(size_t num_elements) {
+  SoundFont sf2;
+  for (size_t index = 0; index < num_elements; index++) {
+    std::shared_ptr<SFSample> sample = sf2.NewSample("Sample " + std::to_string(index),
+      std::vector<int16_t>(8, int16_t(index)), 0, 8, 44100, 60, 0);
+    std::shared_ptr<SFInstrument> instrument = sf2.NewInstrument("Instrument " + std::to_string(index),
+      std::vector<SFInstrumentZone>{ SFInstrumentZone(sample) });
+    sf2.NewPreset("Preset " + std::to_string(index), uint16_t(index % 128), uint16_t(index / 128),
+      std::vector<SFPresetZone>{ SFPresetZone(instrument) });
+  }
+  return sf2;
+}
+
+/// Checks that lookups find owned elements after they are renamed, renumbered and assigned.
+/// @return true if every lookup finds the expected element.
+bool CheckEditedLookups() {
+  SoundFont sf2 = MakeBank(4);
+  const std::shared_ptr<SFPreset> preset = sf2.presets()[1];
+  const std::shared_ptr<SFInstrument> instrument = sf2.instruments()[2];
+  const std::shared_ptr<SFSample> sample = sf2.samples()[3];
+
+  // Build the lookup tables before editing.
+  bool ok = sf2.FindPreset(0, 1) == preset && sf2.FindInstrument(instrument->name()) == instrument &&
+    sf2.FindSample(sample->name()) == sample;
+
+  // Rename and renumber.
+  preset->set_name("Renamed");
+  preset->set_bank(7);
+  preset->set_preset_number(8);
+  instrument->set_name("Renamed");
+  sample->set_name("Renamed");
+  ok = ok && sf2.FindPreset("Renamed") == preset && sf2.FindPreset(7, 8) == preset &&
+    sf2.FindPreset(0, 1) == nullptr && sf2.FindInstrument("Renamed") == instrument &&
+    sf2.FindSample("Renamed") == sample;
+
+  // Assign, then renumber the assigned preset.
+  *preset = SFPreset("Assigned", 9, 99);
+  preset->set_bank(100);
+  *instrument = SFInstrument("Assigned");
+  *sample = SFSample("Assigned", std::vector<int16_t>(8, 0), 0, 8, 44100, 60, 0);
+  ok = ok && sf2.Contains(*preset) && sf2.FindPreset(100, 9) == preset &&
+    sf2.FindPreset("Assigned") == preset && sf2.FindPreset("Renamed") == nullptr &&
+    sf2.Contains(*instrument) && sf2.FindInstrument("Assigned") == instrument &&
+    sf2.Contains(*sample) && sf2.FindSample("Assigned") == sample;
+  return ok;
+}
+
+/// Measures the time to find presets, instruments and samples.
+/// @param argc Number of arguments.
+/// @param argv Argument vector: number of elements, number of runs.
+/// @return 0 if every lookup finds the expected element.
+int main(int argc, char * argv[]) {
+  const size_t num_elements = argc > 1 ? strtoul(argv[1], nullptr, 10) : 10000;
+  const int repeat = argc > 2 ? atoi(argv[2]) : 5;
+
+  try {
+    const SoundFont sf2 = MakeBank(num_elements);
+
+    double best = 0;
+    bool found = true;
+    for (int round = 0; round < repeat; round++) {
+      const auto start = std::chrono::steady_clock::now();
+      for (size_t index = 0; index < num_elements; index++) {
+        found = found &&
+          sf2.FindPreset(uint16_t(index / 128), uint16_t(index % 128)) == sf2.presets()[index] &&
+          sf2.FindInstrument("Instrument " + std::to_string(index)) == sf2.instruments()[index] &&
+          sf2.FindSample("Sample " + std::to_string(index)) == sf2.samples()[index];
+      }
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      if (round == 0 || elapsed.count() < best) {
+        best = elapsed.count();
+      }
+    }
+
+    std::cout << "Elements: " << num_elements << std::endl;
+    std::cout << "Lookups:  " << std::fixed << std::setprecision(1)
+      << best * 1e9 / (3 * num_elements) << " ns each" << std::endl;
+
+    const bool edited = CheckEditedLookups();
+    std::cout << "Found: " << (found ? "yes" : "no") << std::endl;
+    std::cout << "Found after edits: " << (edited ? "yes" : "no") << std::endl;
+    return found && edited ? 0 : 1;
+  }
+  catch (const std::exception & e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,452 @@
+/// @file
+/// Measures the write throughput, allocations and memory usage of every chunk
+/// of a synthesized SoundFont.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include <sf2cute.hpp>
+
+#include "../src/sf2cute/file_layout.hpp"
+#include "../src/sf2cute/file_writer.hpp"
+#include "../src/sf2cute/riff.hpp"
+
+using namespace sf2cute;
+
+namespace {
+
+/// The size of the header prepended to every allocation to remember its size.
+constexpr size_t kAllocationHeaderSize = alignof(max_align_t);
+
+/// The number of allocations.
+std::atomic<size_t> g_num_allocations(0);
+
+/// The number of allocated bytes.
+std::atomic<size_t> g_allocated_bytes(0);
+
+/// The number of bytes currently allocated.
+std::atomic<size_t> g_live_bytes(0);
+
+/// The highest number of bytes allocated at once.
+std::atomic<size_t> g_peak_live_bytes(0);
+
+/// Allocates a block and records it.
+/// @param size the size of the block.
+/// @return the block, or nullptr if the allocation fails.
+void * TrackedAllocate(size_t size) noexcept {
+  char * block = static_cast<char *>(malloc(kAllocationHeaderSize + size));
+  if (block == nullptr) {
+    return nullptr;
+  }
+  memcpy(block, &size, sizeof(size));
+
+  g_num_allocations++;
+  g_allocated_bytes += size;
+  const size_t live_bytes = g_live_bytes += size;
+  size_t peak_live_bytes = g_peak_live_bytes;
+  while (live_bytes > peak_live_bytes &&
+      !g_peak_live_bytes.compare_exchange_weak(peak_live_bytes, live_bytes)) {
+  }
+  return block + kAllocationHeaderSize;
+}
+
+/// Releases a block allocated by TrackedAllocate.
+/// @param ptr the block.
+void TrackedRelease(void * ptr) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  char * block = static_cast<char *>(ptr) - kAllocationHeaderSize;
+  size_t size;
+  memcpy(&size, block, sizeof(size));
+  g_live_bytes -= size;
+  free(block);
+}
+
+/// Allocates a block, or throws std::bad_alloc.
+/// @param size the size of the block.
+/// @return the block.
+void * TrackedNew(size_t size) {
+  void * ptr = TrackedAllocate(size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+} // namespace
+
+void * operator new(size_t size) {
+  return TrackedNew(size);
+}
+
+void * operator new[](size_t size) {
+  return TrackedNew(size);
+}
+
+void * operator new(size_t size, const std::nothrow_t &) noexcept {
+  return TrackedAllocate(size);
+}
+
+void * operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return TrackedAllocate(size);
+}
+
+void operator delete(void * ptr) noexcept {
+  TrackedRelease(ptr);
+}
+
+void operator delete[](void * ptr) noexcept {
+  TrackedRelease(ptr);
+}
+
+void operator delete(void * ptr, size_t) noexcept {
+  TrackedRelease(ptr);
+}
+
+void operator delete[](void * ptr, size_t) noexcept {
+  TrackedRelease(ptr);
+}
+
+void operator delete(void * ptr, const std::nothrow_t &) noexcept {
+  TrackedRelease(ptr);
+}
+
+void operator delete[](void * ptr, const std::nothrow_t &) noexcept {
+  TrackedRelease(ptr);
+}
+
+namespace {
+
+/// The BankParameters struct represents the shape of a synthesized bank.
+struct BankParameters {
+  /// The number of presets. Every preset has its own instrument.
+  size_t num_presets = 128;
+
+  /// The number of zones per preset and per instrument.
+  size_t num_zones = 8;
+
+  /// The number of generators per zone.
+  size_t num_generators = 8;
+
+  /// The number of modulators per zone.
+  size_t num_modulators = 2;
+
+  /// The number of samples.
+  size_t num_samples = 64;
+
+  /// The length of each sample, in sample data points.
+  size_t sample_length = 256 * 1024;
+
+  /// The number of measurements of each chunk.
+  int repeat = 5;
+};
+
+/// The Measurement struct represents the cost of a measured operation.
+struct Measurement {
+  /// The shortest time, in seconds.
+  double seconds = 0;
+
+  /// The number of allocations per run.
+  size_t num_allocations = 0;
+
+  /// The number of allocated bytes per run.
+  size_t allocated_bytes = 0;
+
+  /// The highest number of bytes allocated at once, above the level at the start of the run.
+  size_t peak_bytes = 0;
+
+  /// The growth of the peak resident set size, in kilobytes.
+  long peak_rss_growth = 0;
+};
+
+/// The SinkBuffer class represents a stream buffer that reads and discards its output.
+///
+/// The output is copied to a small scratch buffer, so that the measured
+/// throughput includes reading the serialized bytes, as writing to a file would.
+class SinkBuffer : public std::streambuf {
+protected:
+  /// Discards a character.
+  /// @param ch the character.
+  /// @return the character.
+  virtual int_type overflow(int_type ch) override {
+    return traits_type::not_eof(ch);
+  }
+
+  /// Copies characters to the scratch buffer and discards them.
+  /// @param s the characters.
+  /// @param count the number of characters.
+  /// @return the number of characters.
+  virtual std::streamsize xsputn(const char_type * s, std::streamsize count) override {
+    for (std::streamsize offset = 0; offset < count; offset += sizeof(scratch_)) {
+      const size_t length = std::min(size_t(count - offset), sizeof(scratch_));
+      memcpy(scratch_, s + offset, length);
+    }
+    return count;
+  }
+
+private:
+  /// The scratch buffer.
+  char scratch_[64 * 1024];
+};
+
+/// Returns the peak resident set size of the process.
+/// @return the peak resident set size in kilobytes, or 0 if unknown.
+long PeakRSS() {
+#if defined(__unix__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#if defined(__APPLE__)
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+#else
+  return 0;
+#endif
+}
+
+/// Runs an operation several times and measures it.
+/// @param repeat the number of runs.
+/// @param operation the operation.
+/// @return the measurement.
+template <typename Operation>
+Measurement Measure(int repeat, Operation operation) {
+  Measurement measurement;
+  const long start_rss = PeakRSS();
+  for (int round = 0; round < repeat; round++) {
+    const size_t start_allocations = g_num_allocations;
+    const size_t start_allocated_bytes = g_allocated_bytes;
+    const size_t start_live_bytes = g_live_bytes;
+    g_peak_live_bytes = start_live_bytes;
+
+    const auto start = std::chrono::steady_clock::now();
+    operation();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (round == 0 || elapsed.count() < measurement.seconds) {
+      measurement.seconds = elapsed.count();
+    }
+    measurement.num_allocations = g_num_allocations - start_allocations;
+    measurement.allocated_bytes = g_allocated_bytes - start_allocated_bytes;
+    measurement.peak_bytes = g_peak_live_bytes - start_live_bytes;
+  }
+  measurement.peak_rss_growth = PeakRSS() - start_rss;
+  return measurement;
+}
+
+/// Builds a bank with the specified shape.
+/// @param parameters the shape of the bank.
+/// @return the bank.
+SoundFont MakeBank(const BankParameters & parameters) {
+  // Every generator type except the link generators.
+  std::vector<SFGenerator> generator_types;
+  for (size_t op = 0; op < SFGeneratorSet::kCapacity; op++) {
+    if (SFGenerator(op) != SFGenerator::kInstrument && SFGenerator(op) != SFGenerator::kSampleID) {
+      generator_types.push_back(SFGenerator(op));
+    }
+  }
+  const size_t num_generators = std::min(parameters.num_generators, generator_types.size());
+
+  std::vector<SFGeneratorItem> generators;
+  for (size_t index = 0; index < num_generators; index++) {
+    generators.push_back(SFGeneratorItem(generator_types[index], GenAmountType(int16_t(index))));
+  }
+
+  // Modulators with distinct keys.
+  std::vector<SFModulatorItem> modulators;
+  for (size_t index = 0; index < parameters.num_modulators; index++) {
+    modulators.push_back(SFModulatorItem(SFModulator(uint16_t(index / generator_types.size())),
+      generator_types[index % generator_types.size()], int16_t(index),
+      SFModulator(0), SFTransform::kLinear));
+  }
+
+  SoundFont sf2;
+  std::vector<std::shared_ptr<SFSample>> samples;
+  for (size_t index = 0; index < parameters.num_samples; index++) {
+    std::vector<int16_t> data(parameters.sample_length);
+    for (size_t datapoint = 0; datapoint < data.size(); datapoint++) {
+      data[datapoint] = static_cast<int16_t>((datapoint * 31 + index) & 0x7fff);
+    }
+    samples.push_back(sf2.NewSample("Sample " + std::to_string(index), std::move(data),
+      0, uint32_t(parameters.sample_length), 44100, 60, 0));
+  }
+
+  std::vector<std::shared_ptr<SFInstrument>> instruments;
+  for (size_t index = 0; index < parameters.num_presets; index++) {
+    std::shared_ptr<SFInstrument> instrument = sf2.NewInstrument("Instrument " + std::to_string(index));
+    for (size_t zone = 0; zone < parameters.num_zones && !samples.empty(); zone++) {
+      instrument->AddZone(SFInstrumentZone(samples[(index + zone) % samples.size()],
+        generators, modulators));
+    }
+    instruments.push_back(std::move(instrument));
+  }
+
+  for (size_t index = 0; index < parameters.num_presets; index++) {
+    std::vector<SFPresetZone> zones;
+    for (size_t zone = 0; zone < parameters.num_zones; zone++) {
+      zones.push_back(SFPresetZone(instruments[(index + zone) % instruments.size()],
+        generators, modulators));
+    }
+    sf2.NewPreset("Preset " + std::to_string(index), uint16_t(index % 128), uint16_t(index / 128),
+      std::move(zones));
+  }
+  return sf2;
+}
+
+/// Prints the header of the result table.
+void PrintHeader() {
+  std::cout << std::left << std::setw(10) << "chunk"
+    << std::right << std::setw(14) << "bytes"
+    << std::setw(12) << "ms"
+    << std::setw(12) << "MiB/s"
+    << std::setw(12) << "allocs"
+    << std::setw(14) << "alloc bytes"
+    << std::setw(14) << "peak bytes"
+    << std::setw(12) << "rss +KiB" << std::endl;
+}
+
+/// Prints a row of the result table.
+/// @param name the name of the measured chunk or phase.
+/// @param size the number of bytes produced, or 0 if not applicable.
+/// @param measurement the measurement.
+void PrintRow(const std::string & name, size_t size, const Measurement & measurement) {
+  std::cout << std::left << std::setw(10) << name
+    << std::right << std::setw(14) << size
+    << std::setw(12) << std::fixed << std::setprecision(3) << measurement.seconds * 1000
+    << std::setw(12) << std::setprecision(1)
+    << (size != 0 && measurement.seconds > 0 ? size / (1024.0 * 1024.0) / measurement.seconds : 0.0)
+    << std::setw(12) << measurement.num_allocations
+    << std::setw(14) << measurement.allocated_bytes
+    << std::setw(14) << measurement.peak_bytes
+    << std::setw(12) << measurement.peak_rss_growth << std::endl;
+}
+
+/// Measures every chunk of the specified chunk list.
+/// @param chunks the chunks.
+/// @param repeat the number of runs.
+void MeasureChunks(const std::vector<std::unique_ptr<RIFFChunkInterface>> & chunks, int repeat) {
+  for (const auto & chunk : chunks) {
+    const RIFFListChunk * list = dynamic_cast<const RIFFListChunk *>(chunk.get());
+    if (list != nullptr && list->name() != "INFO") {
+      MeasureChunks(list->subchunks(), repeat);
+      continue;
+    }
+
+    SinkBuffer buffer;
+    std::ostream out(&buffer);
+    const Measurement measurement = Measure(repeat, [&]() { chunk->Write(out); });
+    PrintRow(chunk->name(), chunk->size(), measurement);
+  }
+}
+
+/// Prints the usage.
+/// @param name the name of the program.
+void PrintUsage(const char * name) {
+  std::cerr << "Usage: " << name << " [options]" << std::endl
+    << "  --presets N         number of presets and instruments" << std::endl
+    << "  --zones N           zones per preset and per instrument" << std::endl
+    << "  --generators N      generators per zone" << std::endl
+    << "  --modulators N      modulators per zone" << std::endl
+    << "  --samples N         number of samples" << std::endl
+    << "  --sample-length N   sample data points per sample" << std::endl
+    << "  --repeat N          runs per measurement (the fastest is reported)" << std::endl;
+}
+
+} // namespace
+
+/// Measures the write throughput, allocations and memory usage of every chunk.
+/// @param argc Number of arguments.
+/// @param argv Argument vector.
+/// @return 0 on success.
+int main(int argc, char * argv[]) {
+  BankParameters parameters;
+  for (int index = 1; index < argc; index++) {
+    const std::string option = argv[index];
+    if (index + 1 >= argc) {
+      PrintUsage(argv[0]);
+      return 1;
+    }
+    const size_t value = strtoul(argv[++index], nullptr, 10);
+    if (option == "--presets") {
+      parameters.num_presets = value;
+    }
+    else if (option == "--zones") {
+      parameters.num_zones = value;
+    }
+    else if (option == "--generators") {
+      parameters.num_generators = value;
+    }
+    else if (option == "--modulators") {
+      parameters.num_modulators = value;
+    }
+    else if (option == "--samples") {
+      parameters.num_samples = value;
+    }
+    else if (option == "--sample-length") {
+      parameters.sample_length = value;
+    }
+    else if (option == "--repeat") {
+      parameters.repeat = std::max(1, int(value));
+    }
+    else {
+      PrintUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  try {
+    std::cout << "presets=" << parameters.num_presets
+      << " zones=" << parameters.num_zones
+      << " generators=" << parameters.num_generators
+      << " modulators=" << parameters.num_modulators
+      << " samples=" << parameters.num_samples
+      << " sample-length=" << parameters.sample_length << std::endl;
+
+    std::unique_ptr<SoundFont> sf2;
+    const Measurement build = Measure(1, [&]() {
+      sf2.reset(new SoundFont(MakeBank(parameters)));
+    });
+
+    SoundFontWriter writer(*sf2);
+    SoundFontLayout layout;
+    std::unique_ptr<RIFF> riff;
+    const Measurement plan = Measure(parameters.repeat, [&]() {
+      riff = writer.MakeRIFF(layout);
+    });
+
+    SinkBuffer buffer;
+    std::ostream out(&buffer);
+    const Measurement write = Measure(parameters.repeat, [&]() { sf2->Write(out); });
+
+    PrintHeader();
+    PrintRow("(bank)", 0, build);
+    PrintRow("(layout)", 0, plan);
+    MeasureChunks(riff->chunks(), parameters.repeat);
+    PrintRow("(write)", riff->size(), write);
+    std::cout << "Peak RSS: " << PeakRSS() << " KiB" << std::endl;
+    return 0;
+  }
+  catch (const std::exception & e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
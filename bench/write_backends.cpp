@@ -0,0 +1,165 @@
+/// @file
+/// Compares the write throughput of the stream and positional-write backends.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sf2cute.hpp>
+
+using namespace sf2cute;
+
+/// Builds a bank with the specified number of samples and zones.
+/// @param num_samples the number of samples.
+/// @param sample_length the length of each sample, in sample data points.
+/// @param num_instruments the number of instruments, each with one zone per sample.
+/// @return the bank.
+SoundFont MakeBank(size_t num_samples, size_t sample_length, size_t num_instruments) {
+  SoundFont sf2;
+  std::vector<std::shared_ptr<SFSample>> samples;
+  for (size_t index = 0; index < num_samples; index++) {
+    std::vector<int16_t> data(sample_length);
+    for (size_t datapoint = 0; datapoint < sample_length; datapoint++) {
+      data[datapoint] = static_cast<int16_t>((datapoint * 31 + index) & 0x7fff);
+    }
+    samples.push_back(sf2.NewSample("Sample " + std::to_string(index), std::move(data),
+      0, uint32_t(sample_length), 44100, 60, 0));
+  }
+
+  for (size_t index = 0; index < num_instruments; index++) {
+    std::shared_ptr<SFInstrument> instrument = sf2.NewInstrument("Instrument " + std::to_string(index));
+    for (const auto & sample : samples) {
+      instrument->AddZone(SFInstrumentZone(sample,
+        std::vector<SFGeneratorItem>{ SFGeneratorItem(SFGenerator::kSampleModes, uint16_t(SampleMode::kLoopContinuously)) },
+        std::vector<SFModulatorItem>{}));
+    }
+    sf2.NewPreset(instrument->name(), uint16_t(index % 128), uint16_t(index / 128),
+      std::vector<SFPresetZone>{ SFPresetZone(instrument) });
+  }
+  return sf2;
+}
+
+/// Writes the bank several times and returns the best time.
+/// @param sf2 the bank.
+/// @param filename the name of the file to write to.
+/// @param options the options for writing.
+/// @param repeat the number of writes.
+/// @return the shortest time, in seconds.
+double MeasureWrite(SoundFont & sf2, const std::string & filename,
+    const SFWriteOptions & options, int repeat) {
+  double best = 0;
+  for (int round = 0; round < repeat; round++) {
+    const auto start = std::chrono::steady_clock::now();
+    sf2.Write(filename, options);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (round == 0 || elapsed.count() < best) {
+      best = elapsed.count();
+    }
+  }
+  return best;
+}
+
+/// Reads a whole file.
+/// @param filename the name of the file.
+/// @return the file contents.
+std::string ReadFile(const std::string & filename) {
+  std::ifstream in(filename, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+/// The HighByteEncoder class keeps the high byte of each datapoint.
+///
+/// It stands in for a real codec, so that the encoded sample pool can have
+/// any length, including an odd one, without an external library.
+class HighByteEncoder : public SFSampleEncoder {
+public:
+  /// @copydoc SFSampleEncoder::Encode()
+  virtual std::vector<char> Encode(const SFSample & sample) const override {
+    std::vector<int16_t> datapoints = sample.data().ToVector();
+    std::vector<char> stream;
+    for (const int16_t datapoint : datapoints) {
+      stream.push_back(static_cast<char>(datapoint >> 8));
+    }
+    return stream;
+  }
+};
+
+/// Checks that both backends write the same SF3 file when the encoded
+/// sample pool has an odd length, and thus a padding byte.
+/// @param directory the directory to write to.
+/// @return true if both backends produce the same file.
+bool CheckOddEncodedPool(const std::string & directory) {
+  SoundFont sf2;
+  std::shared_ptr<SFInstrument> instrument = sf2.NewInstrument("Odd Pool");
+  for (size_t length : { 5, 6 }) {
+    std::shared_ptr<SFSample> sample = sf2.NewSample("Sample " + std::to_string(length),
+      std::vector<int16_t>(length, 0x1234), 0, uint32_t(length), 44100, 60, 0);
+    instrument->AddZone(SFInstrumentZone(sample));
+  }
+  sf2.NewPreset(instrument->name(), 0, 0, std::vector<SFPresetZone>{ SFPresetZone(instrument) });
+
+  SFWriteOptions stream_options;
+  stream_options.sample_encoder = std::make_shared<HighByteEncoder>();
+  const std::string stream_filename = directory + "/bench_odd_stream.sf3";
+  sf2.Write(stream_filename, stream_options);
+
+  SFWriteOptions positional_options = stream_options;
+  positional_options.positional_write = true;
+  const std::string positional_filename = directory + "/bench_odd_positional.sf3";
+  sf2.Write(positional_filename, positional_options);
+
+  return ReadFile(stream_filename) == ReadFile(positional_filename);
+}
+
+/// Compares the write throughput of the stream and positional-write backends.
+/// @param argc Number of arguments.
+/// @param argv Argument vector: output directory, number of samples,
+/// sample length, number of instruments, number of threads.
+/// @return 0 if both backends produce the same files.
+int main(int argc, char * argv[]) {
+  const std::string directory = argc > 1 ? argv[1] : ".";
+  const size_t num_samples = argc > 2 ? strtoul(argv[2], nullptr, 10) : 256;
+  const size_t sample_length = argc > 3 ? strtoul(argv[3], nullptr, 10) : 512 * 1024;
+  const size_t num_instruments = argc > 4 ? strtoul(argv[4], nullptr, 10) : 64;
+  const unsigned int num_threads = argc > 5 ? unsigned(strtoul(argv[5], nullptr, 10)) : 0;
+  const int kRepeat = 3;
+
+  try {
+    SoundFont sf2 = MakeBank(num_samples, sample_length, num_instruments);
+
+    SFWriteOptions stream_options;
+    const std::string stream_filename = directory + "/bench_stream.sf2";
+    const double stream_time = MeasureWrite(sf2, stream_filename, stream_options, kRepeat);
+
+    SFWriteOptions positional_options;
+    positional_options.positional_write = true;
+    positional_options.num_threads = num_threads;
+    const std::string positional_filename = directory + "/bench_positional.sf2";
+    const double positional_time = MeasureWrite(sf2, positional_filename, positional_options, kRepeat);
+
+    const std::string stream_data = ReadFile(stream_filename);
+    const bool identical = stream_data == ReadFile(positional_filename);
+    const double megabytes = stream_data.size() / (1024.0 * 1024.0);
+
+    std::cout << "File size: " << megabytes << " MiB" << std::endl;
+    std::cout << "ostream:    " << stream_time * 1000 << " ms, "
+      << megabytes / stream_time << " MiB/s" << std::endl;
+    std::cout << "positional: " << positional_time * 1000 << " ms, "
+      << megabytes / positional_time << " MiB/s" << std::endl;
+    std::cout << "Identical: " << (identical ? "yes" : "no") << std::endl;
+
+    const bool odd_pool_identical = CheckOddEncodedPool(directory);
+    std::cout << "Identical with an odd SF3 pool: " << (odd_pool_identical ? "yes" : "no") << std::endl;
+    return identical && odd_pool_identical ? 0 : 1;
+  }
+  catch (const std::exception & e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -53,7 +53,7 @@ void PrintSoundFont(const sf2cute::SoundFont & sf2) {
 
       // Generators:
       for (const auto & generator : preset->global_zone().generators()) {
-        printf("    -> Generator %p\n", &generator);
+        printf("    -> Generator %d\n", static_cast<int>(generator.op()));
       }
 
       // Modulators:
@@ -77,7 +77,7 @@ void PrintSoundFont(const sf2cute::SoundFont & sf2) {
 
       // Generators:
       for (const auto & generator : preset_zone->generators()) {
-        printf("    -> Generator %p\n", &generator);
+        printf("    -> Generator %d\n", static_cast<int>(generator.op()));
       }
 
       // Modulators:
@@ -103,7 +103,7 @@ void PrintSoundFont(const sf2cute::SoundFont & sf2) {
 
       // Generators:
       for (const auto & generator : instrument->global_zone().generators()) {
-        printf("  -> Generator %p\n", &generator);
+        printf("  -> Generator %d\n", static_cast<int>(generator.op()));
       }
 
       // Modulators:
@@ -126,7 +126,7 @@ void PrintSoundFont(const sf2cute::SoundFont & sf2) {
 
         // Generators:
         for (const auto & generator : instrument_zone->generators()) {
-          printf("      -> Generator %p\n", &generator);
+          printf("      -> Generator %d\n", static_cast<int>(generator.op()));
         }
 
         // Modulators:
@@ -0,0 +1,50 @@
+/// @file
+/// Reads SoundFont 2 file using SF2cute.
+
+#include <memory>
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+
+#include <sf2cute.hpp>
+
+using namespace sf2cute;
+
+/// Reads SoundFont 2 file using SF2cute, and writes it again if requested.
+/// @param argc Number of arguments.
+/// @param argv Argument vector: the input filename and an optional output filename.
+/// @return 0 if the SoundFont file is successfully read.
+int main(int argc, char * argv[]) {
+  if (argc < 2) {
+    std::cerr << "Usage: read_sf2 input.sf2 [output.sf2]" << std::endl;
+    return 1;
+  }
+
+  try {
+    // Read SoundFont file.
+    SoundFont sf2 = SoundFont::Read(argv[1]);
+
+    // Print the summary.
+    std::cout << "Bank Name: " << sf2.bank_name() << std::endl;
+    std::cout << "Presets: " << sf2.presets().size() << std::endl;
+    std::cout << "Instruments: " << sf2.instruments().size() << std::endl;
+    std::cout << "Samples: " << sf2.samples().size() << std::endl;
+
+    // Write SoundFont file.
+    if (argc >= 3) {
+      sf2.Write(argv[2]);
+    }
+    return 0;
+  }
+  catch (const std::fstream::failure & e) {
+    // File I/O error.
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  catch (const std::exception & e) {
+    // Other errors.
+    // For example: Not a SoundFont 2 file.
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -8,9 +8,15 @@
 
 #include "sf2cute/version.hpp"
 #include "sf2cute/types.hpp"
+#include "sf2cute/arena.hpp"
 #include "sf2cute/modulator.hpp"
+#include "sf2cute/sample_source.hpp"
+#include "sf2cute/sample_data.hpp"
+#include "sf2cute/sample_store.hpp"
 #include "sf2cute/sample.hpp"
+#include "sf2cute/sample_encoder.hpp"
 #include "sf2cute/generator_item.hpp"
+#include "sf2cute/generator_set.hpp"
 #include "sf2cute/modulator_key.hpp"
 #include "sf2cute/modulator_item.hpp"
 #include "sf2cute/zone.hpp"
@@ -18,6 +24,9 @@
 #include "sf2cute/instrument.hpp"
 #include "sf2cute/preset_zone.hpp"
 #include "sf2cute/preset.hpp"
+#include "sf2cute/write_options.hpp"
+#include "sf2cute/shard_manifest.hpp"
+#include "sf2cute/optimization_report.hpp"
 #include "sf2cute/file.hpp"
 
 #endif // SF2CUTE_SF2CUTE_HPP_
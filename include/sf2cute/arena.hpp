@@ -0,0 +1,197 @@
+/// @file
+/// SoundFont 2 Arena class header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_ARENA_HPP_
+#define SF2CUTE_ARENA_HPP_
+
+#include <stddef.h>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace sf2cute {
+
+/// The SFArena class represents a monotonic memory resource for the nodes of a SoundFont.
+///
+/// The presets, instruments and samples of a SoundFont created with an
+/// arena, together with their zones and modulators, are carved out of large
+/// blocks instead of being allocated one by one. Freeing a node returns
+/// nothing to the arena; the blocks are released all at once, when the arena
+/// and every node allocated from it are gone.
+///
+/// @remarks An arena must not be used to allocate from two threads at the
+/// same time. The nodes may be freed from any thread.
+class SFArena {
+public:
+  /// The default size of a block, in terms of bytes.
+  static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+  /// The Scope class makes an arena the source of the zones and modulators
+  /// allocated by the current thread, while the scope is alive.
+  class Scope {
+  public:
+    /// Makes an arena the current arena.
+    /// @param arena the arena, or nullptr to allocate from the heap.
+    explicit Scope(const std::shared_ptr<SFArena> & arena) noexcept;
+
+    /// Restores the previous arena.
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope & operator=(const Scope &) = delete;
+
+  private:
+    /// The arena that was current before the scope.
+    const std::shared_ptr<SFArena> * previous_;
+  };
+
+  /// The Allocator class template allocates from an arena, for std::allocate_shared.
+  /// @tparam T the type of the allocated objects.
+  template <class T>
+  class Allocator {
+  public:
+    /// The type of the allocated objects.
+    using value_type = T;
+
+    /// Constructs a new Allocator using the specified arena.
+    /// @param arena the arena.
+    explicit Allocator(std::shared_ptr<SFArena> arena) noexcept :
+        arena_(std::move(arena)) {
+    }
+
+    /// Constructs a new Allocator using the arena of another allocator.
+    /// @param origin an Allocator object.
+    template <class U>
+    Allocator(const Allocator<U> & origin) noexcept :
+        arena_(origin.arena()) {
+    }
+
+    /// Returns the arena.
+    /// @return the arena.
+    const std::shared_ptr<SFArena> & arena() const noexcept {
+      return arena_;
+    }
+
+    /// Allocates storage for objects.
+    /// @param n the number of objects.
+    /// @return a pointer to the storage.
+    T * allocate(size_t n) {
+      return static_cast<T *>(arena_->Allocate(sizeof(T) * n));
+    }
+
+    /// Frees storage, which is a no-op for an arena.
+    void deallocate(T *, size_t) noexcept {
+    }
+
+    /// Returns true if two allocators use the same arena.
+    template <class U>
+    bool operator==(const Allocator<U> & other) const noexcept {
+      return arena_ == other.arena();
+    }
+
+    /// Returns true if two allocators use different arenas.
+    template <class U>
+    bool operator!=(const Allocator<U> & other) const noexcept {
+      return arena_ != other.arena();
+    }
+
+  private:
+    /// The arena, kept alive by every object allocated from it.
+    std::shared_ptr<SFArena> arena_;
+  };
+
+  /// Constructs a new SFArena.
+  /// @param block_size the size of a block, in terms of bytes.
+  explicit SFArena(size_t block_size = kDefaultBlockSize);
+
+  SFArena(const SFArena &) = delete;
+  SFArena & operator=(const SFArena &) = delete;
+
+  /// Destructs the SFArena, releasing every block.
+  ~SFArena();
+
+  /// Returns the size of a block.
+  /// @return the size of a block, in terms of bytes.
+  size_t block_size() const noexcept {
+    return block_size_;
+  }
+
+  /// Returns the number of allocations served by the arena.
+  /// @return the number of allocations.
+  size_t num_allocations() const noexcept {
+    return num_allocations_;
+  }
+
+  /// Returns the number of blocks.
+  /// @return the number of blocks allocated from the heap.
+  size_t num_blocks() const noexcept {
+    return blocks_.size();
+  }
+
+  /// Returns the size of the memory handed out by the arena.
+  /// @return the total size of the allocations, in terms of bytes.
+  size_t allocated_size() const noexcept {
+    return allocated_size_;
+  }
+
+  /// Allocates memory from the arena.
+  /// @param size the size of the memory, in terms of bytes.
+  /// @return a pointer to the memory, aligned for any fundamental type.
+  /// @throws std::bad_alloc A block could not be allocated.
+  void * Allocate(size_t size);
+
+  /// Returns the current arena of the thread.
+  /// @return the arena of the innermost scope, or nullptr if there is none.
+  static const std::shared_ptr<SFArena> & current() noexcept;
+
+  /// Allocates a node from the current arena, or from the heap without a current arena.
+  /// @param size the size of the node, in terms of bytes.
+  /// @return a pointer to the node.
+  /// @throws std::bad_alloc The memory could not be allocated.
+  /// @see SFArena::Scope
+  static void * AllocateNode(size_t size);
+
+  /// Frees a node allocated by AllocateNode.
+  /// @param node a pointer to the node, or nullptr.
+  static void DeallocateNode(void * node) noexcept;
+
+  /// Creates a shared object, from an arena if any.
+  /// @param arena the arena, or nullptr to use std::make_shared.
+  /// @param args the arguments of the constructor.
+  /// @return the object.
+  /// @remarks The zones and modulators built by the constructor are allocated from the arena too.
+  template <class T, class... Args>
+  static std::shared_ptr<T> MakeShared(const std::shared_ptr<SFArena> & arena, Args && ... args) {
+    if (arena == nullptr) {
+      return std::make_shared<T>(std::forward<Args>(args)...);
+    }
+
+    Scope scope(arena);
+    return std::allocate_shared<T>(Allocator<T>(arena), std::forward<Args>(args)...);
+  }
+
+private:
+  /// The size of a block.
+  size_t block_size_;
+
+  /// The blocks.
+  std::vector<std::unique_ptr<char[]>> blocks_;
+
+  /// The next free byte in the last block.
+  char * next_;
+
+  /// The number of free bytes in the last block.
+  size_t available_;
+
+  /// The number of allocations.
+  size_t num_allocations_;
+
+  /// The total size of the allocations.
+  size_t allocated_size_;
+};
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_ARENA_HPP_
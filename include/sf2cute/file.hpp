@@ -6,14 +6,23 @@
 #ifndef SF2CUTE_FILE_HPP_
 #define SF2CUTE_FILE_HPP_
 
+#include <stddef.h>
+#include <stdint.h>
 #include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <utility>
 #include <functional>
-#include <vector>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "types.hpp"
+#include "arena.hpp"
+#include "write_options.hpp"
+#include "shard_manifest.hpp"
+#include "optimization_report.hpp"
 
 namespace sf2cute {
 
@@ -26,6 +35,10 @@ class SoundFont;
 
 /// The SoundFont class represents a SoundFont file.
 class SoundFont {
+  friend class SFPreset;
+  friend class SFInstrument;
+  friend class SFSample;
+
 public:
   /// Maximum length of text fields of INFO chunk (excluding the terminator byte), in terms of bytes.
   static constexpr std::string::size_type kInfoTextMaxLength = 256 - 1;
@@ -33,12 +46,24 @@ public:
   /// Constructs a new empty SoundFont.
   SoundFont();
 
+  /// Constructs a new empty SoundFont whose elements are allocated from an arena.
+  /// @param arena the arena, or nullptr to allocate every element separately.
+  /// @remarks NewPreset, NewInstrument and NewSample allocate the elements,
+  /// their zones and modulators from the arena. Elements created elsewhere
+  /// and added by AddPreset, AddInstrument or AddSample keep their own memory,
+  /// but zones added to them afterwards come from the arena.
+  explicit SoundFont(std::shared_ptr<SFArena> arena);
+
   /// Constructs a new copy of specified SoundFont.
   /// @param origin a SoundFont object.
+  /// @remarks The sample data is shared with the origin until either side modifies it.
+  /// A copy of a SoundFont with an arena is allocated from a new arena of its own.
   SoundFont(const SoundFont & origin);
 
   /// Copy-assigns a new value to the SoundFont, replacing its current contents.
   /// @param origin a SoundFont object.
+  /// @remarks The sample data is shared with the origin until either side modifies it.
+  /// The copied elements are allocated from the arena of this SoundFont, if any.
   SoundFont & operator=(const SoundFont & origin);
 
   /// Acquires the contents of specified SoundFont.
@@ -52,9 +77,19 @@ public:
   /// Destructs the SoundFont.
   ~SoundFont() = default;
 
+  /// Returns the arena of the SoundFont.
+  /// @return the arena that the elements are allocated from, or nullptr if there is none.
+  const std::shared_ptr<SFArena> & arena() const noexcept {
+    return arena_;
+  }
+
   /// Returns the list of presets.
   /// @return the list of presets assigned to the SoundFont.
+  /// @remarks The presets removed since the last call are closed up first. A
+  /// reference to the list taken before a removal holds nullptr in place of
+  /// the removed preset until the list is requested again.
   const std::vector<std::shared_ptr<SFPreset>> & presets() const noexcept {
+    CompactLists();
     return presets_;
   }
 
@@ -65,7 +100,7 @@ public:
   template<typename ... Args>
   std::shared_ptr<SFPreset> NewPreset(Args && ... args) {
     std::shared_ptr<SFPreset> preset =
-      std::make_shared<SFPreset>(std::forward<Args>(args)...);
+      SFArena::MakeShared<SFPreset>(arena_, std::forward<Args>(args)...);
     AddPreset(preset);
     return std::move(preset);
   }
@@ -77,6 +112,7 @@ public:
 
   /// Removes a preset from the SoundFont.
   /// @param position the preset to remove.
+  /// @remarks The removal takes constant time.
   void RemovePreset(
       std::vector<std::shared_ptr<SFPreset>>::const_iterator position);
 
@@ -87,6 +123,19 @@ public:
       std::vector<std::shared_ptr<SFPreset>>::const_iterator first,
       std::vector<std::shared_ptr<SFPreset>>::const_iterator last);
 
+  /// Removes a preset from the SoundFont.
+  /// @param preset the preset to remove. Nothing happens if the SoundFont does not own it.
+  /// @remarks The removal takes constant time. The preset leaves a hole in
+  /// the list, which is closed up the next time the list is requested.
+  void RemovePreset(const std::shared_ptr<SFPreset> & preset);
+
+  /// Removes presets from the SoundFont.
+  /// @param presets the presets to remove. The presets that the SoundFont does not own are ignored.
+  /// @remarks The presets are found through their stored positions, and the
+  /// list is compacted in a single pass, so the time is linear in the
+  /// size of the list and of the argument.
+  void RemovePresets(const std::vector<std::shared_ptr<SFPreset>> & presets);
+
   /// Removes presets from the SoundFont.
   /// @param predicate unary predicate which returns true if the preset should be removed.
   void RemovePresetIf(
@@ -95,9 +144,34 @@ public:
   /// Removes all of the presets.
   void ClearPresets() noexcept;
 
+  /// Returns true if the SoundFont owns a preset.
+  /// @param preset the preset.
+  /// @return true if the preset is in the list of this SoundFont.
+  /// @remarks The check takes constant time.
+  bool Contains(const SFPreset & preset) const noexcept;
+
+  /// Finds a preset by its bank and preset number.
+  /// @param bank the bank number.
+  /// @param preset_number the preset number.
+  /// @return the first preset in the list with the numbers, or nullptr if there is none.
+  /// @remarks The lookup is a hash table lookup. The table is built by the
+  /// first lookup and kept up to date afterwards. Concurrent lookups are
+  /// safe, but a lookup must not run concurrently with a modification.
+  std::shared_ptr<SFPreset> FindPreset(uint16_t bank, uint16_t preset_number) const;
+
+  /// Finds a preset by its name.
+  /// @param name the name of the preset.
+  /// @return the first preset in the list with the name, or nullptr if there is none.
+  /// @remarks The lookup is a hash table lookup, like the lookup by numbers.
+  std::shared_ptr<SFPreset> FindPreset(const std::string & name) const;
+
   /// Returns the list of instruments.
   /// @return the list of instruments assigned to the SoundFont.
+  /// @remarks The instruments removed since the last call are closed up first. A
+  /// reference to the list taken before a removal holds nullptr in place of
+  /// the removed instrument until the list is requested again.
   const std::vector<std::shared_ptr<SFInstrument>> & instruments() const noexcept {
+    CompactLists();
     return instruments_;
   }
 
@@ -108,7 +182,7 @@ public:
   template<typename ... Args>
   std::shared_ptr<SFInstrument> NewInstrument(Args && ... args) {
     std::shared_ptr<SFInstrument> instrument =
-      std::make_shared<SFInstrument>(std::forward<Args>(args)...);
+      SFArena::MakeShared<SFInstrument>(arena_, std::forward<Args>(args)...);
     AddInstrument(instrument);
     return std::move(instrument);
   }
@@ -120,6 +194,7 @@ public:
 
   /// Removes an instrument from the SoundFont.
   /// @param position the instrument to remove.
+  /// @remarks The removal takes constant time.
   void RemoveInstrument(
       std::vector<std::shared_ptr<SFInstrument>>::const_iterator position);
 
@@ -130,6 +205,19 @@ public:
       std::vector<std::shared_ptr<SFInstrument>>::const_iterator first,
       std::vector<std::shared_ptr<SFInstrument>>::const_iterator last);
 
+  /// Removes an instrument from the SoundFont.
+  /// @param instrument the instrument to remove. Nothing happens if the SoundFont does not own it.
+  /// @remarks The removal takes constant time. The instrument leaves a hole in
+  /// the list, which is closed up the next time the list is requested.
+  void RemoveInstrument(const std::shared_ptr<SFInstrument> & instrument);
+
+  /// Removes instruments from the SoundFont.
+  /// @param instruments the instruments to remove. The instruments that the SoundFont does not own are ignored.
+  /// @remarks The instruments are found through their stored positions, and the
+  /// list is compacted in a single pass, so the time is linear in the
+  /// size of the list and of the argument.
+  void RemoveInstruments(const std::vector<std::shared_ptr<SFInstrument>> & instruments);
+
   /// Removes instruments from the SoundFont.
   /// @param predicate unary predicate which returns true if the instrument should be removed.
   void RemoveInstrumentIf(
@@ -138,9 +226,25 @@ public:
   /// Removes all of the instruments.
   void ClearInstruments() noexcept;
 
+  /// Returns true if the SoundFont owns an instrument.
+  /// @param instrument the instrument.
+  /// @return true if the instrument is in the list of this SoundFont.
+  /// @remarks The check takes constant time.
+  bool Contains(const SFInstrument & instrument) const noexcept;
+
+  /// Finds an instrument by its name.
+  /// @param name the name of the instrument.
+  /// @return the first instrument in the list with the name, or nullptr if there is none.
+  /// @remarks The lookup is a hash table lookup, like FindPreset.
+  std::shared_ptr<SFInstrument> FindInstrument(const std::string & name) const;
+
   /// Returns the list of samples.
   /// @return the list of samples assigned to the SoundFont.
+  /// @remarks The samples removed since the last call are closed up first. A
+  /// reference to the list taken before a removal holds nullptr in place of
+  /// the removed sample until the list is requested again.
   const std::vector<std::shared_ptr<SFSample>> & samples() const noexcept {
+    CompactLists();
     return samples_;
   }
 
@@ -151,7 +255,7 @@ public:
   template<typename ... Args>
   std::shared_ptr<SFSample> NewSample(Args && ... args) {
     std::shared_ptr<SFSample> sample =
-      std::make_shared<SFSample>(std::forward<Args>(args)...);
+      SFArena::MakeShared<SFSample>(arena_, std::forward<Args>(args)...);
     AddSample(sample);
     return std::move(sample);
   }
@@ -163,6 +267,7 @@ public:
 
   /// Removes a sample from the SoundFont.
   /// @param position the sample to remove.
+  /// @remarks The removal takes constant time.
   void RemoveSample(
       std::vector<std::shared_ptr<SFSample>>::const_iterator position);
 
@@ -173,6 +278,19 @@ public:
       std::vector<std::shared_ptr<SFSample>>::const_iterator first,
       std::vector<std::shared_ptr<SFSample>>::const_iterator last);
 
+  /// Removes a sample from the SoundFont.
+  /// @param sample the sample to remove. Nothing happens if the SoundFont does not own it.
+  /// @remarks The removal takes constant time. The sample leaves a hole in
+  /// the list, which is closed up the next time the list is requested.
+  void RemoveSample(const std::shared_ptr<SFSample> & sample);
+
+  /// Removes samples from the SoundFont.
+  /// @param samples the samples to remove. The samples that the SoundFont does not own are ignored.
+  /// @remarks The samples are found through their stored positions, and the
+  /// list is compacted in a single pass, so the time is linear in the
+  /// size of the list and of the argument.
+  void RemoveSamples(const std::vector<std::shared_ptr<SFSample>> & samples);
+
   /// Removes samples from the SoundFont.
   /// @param predicate unary predicate which returns true if the sample should be removed.
   void RemoveSampleIf(
@@ -181,6 +299,18 @@ public:
   /// Removes all of the samples.
   void ClearSamples() noexcept;
 
+  /// Returns true if the SoundFont owns a sample.
+  /// @param sample the sample.
+  /// @return true if the sample is in the list of this SoundFont.
+  /// @remarks The check takes constant time.
+  bool Contains(const SFSample & sample) const noexcept;
+
+  /// Finds a sample by its name.
+  /// @param name the name of the sample.
+  /// @return the first sample in the list with the name, or nullptr if there is none.
+  /// @remarks The lookup is a hash table lookup, like FindPreset.
+  std::shared_ptr<SFSample> FindSample(const std::string & name) const;
+
   /// Returns the target sound engine.
   /// @return the target sound engine name.
   const std::string & sound_engine() const noexcept {
@@ -390,6 +520,49 @@ public:
     software_.clear();
   }
 
+  /// Reads a SoundFont from a file.
+  /// @param filename the name of the file to read from.
+  /// @return the SoundFont read from the file.
+  /// @throws std::runtime_error The file is not a valid SoundFont.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  static SoundFont Read(const std::string & filename);
+
+  /// Reads a SoundFont from an input stream.
+  /// @param in the input stream to read from.
+  /// @return the SoundFont read from the stream.
+  /// @throws std::runtime_error The stream does not contain a valid SoundFont.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  static SoundFont Read(std::istream & in);
+
+  /// @copydoc SoundFont::Read(std::istream &)
+  static SoundFont Read(std::istream && in);
+
+  /// Reads a SoundFont from a file, allocating its elements from an arena.
+  /// @param filename the name of the file to read from.
+  /// @param arena the arena of the new SoundFont.
+  /// @return the SoundFont read from the file.
+  /// @throws std::runtime_error The file is not a valid SoundFont.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  static SoundFont Read(const std::string & filename, std::shared_ptr<SFArena> arena);
+
+  /// Reads a SoundFont from an input stream, allocating its elements from an arena.
+  /// @param in the input stream to read from.
+  /// @param arena the arena of the new SoundFont.
+  /// @return the SoundFont read from the stream.
+  /// @throws std::runtime_error The stream does not contain a valid SoundFont.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  static SoundFont Read(std::istream & in, std::shared_ptr<SFArena> arena);
+
+  /// Reads a SoundFont from a file, mapping it into memory.
+  /// @param filename the name of the file to read from.
+  /// @return the SoundFont read from the file.
+  /// @throws std::runtime_error The file is not a valid SoundFont.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  /// @remarks The sample data is not loaded; each sample views the
+  /// mapped sample pool until SFSample::ModifyData or SFSample::set_data is called.
+  /// The file must not be modified while any of its samples is alive.
+  static SoundFont ReadMapped(const std::string & filename);
+
   /// Writes the SoundFont to a file.
   /// @param filename the name of the file to write to.
   /// @throws std::logic_error The SoundFont has a structural error.
@@ -403,6 +576,107 @@ public:
   /// @copydoc SoundFont::Write(std::ostream &)
   void Write(std::ostream && out);
 
+  /// Writes the SoundFont to a file using the specified options.
+  /// @param filename the name of the file to write to.
+  /// @param options the options for writing.
+  /// @throws std::logic_error The SoundFont has a structural error.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  void Write(const std::string & filename, const SFWriteOptions & options);
+
+  /// Writes the SoundFont to an output stream using the specified options.
+  /// @param out the output stream to write to.
+  /// @param options the options for writing.
+  void Write(std::ostream & out, const SFWriteOptions & options);
+
+  /// @copydoc SoundFont::Write(std::ostream &, const SFWriteOptions &)
+  void Write(std::ostream && out, const SFWriteOptions & options);
+
+  /// Returns the length of the file that Write would produce.
+  /// @return the length of the file, in terms of bytes.
+  /// @throws std::logic_error The SoundFont has a structural error.
+  size_t GetWriteSize();
+
+  /// Writes the SoundFont to a preallocated buffer.
+  /// @param buffer a pointer to the buffer to write to.
+  /// @param size the length of the buffer, in terms of bytes.
+  /// @return the length of the written file, in terms of bytes.
+  /// @throws std::logic_error The SoundFont has a structural error,
+  /// or the buffer is smaller than GetWriteSize().
+  /// @throws std::ios_base::failure An I/O error occurred while reading a sample source.
+  /// @remarks The records are stored straight into the buffer, without an output stream.
+  size_t WriteTo(char * buffer, size_t size);
+
+  /// Writes the SoundFont to a new vector.
+  /// @return the file image, allocated once at its exact size.
+  /// @throws std::logic_error The SoundFont has a structural error.
+  /// @throws std::ios_base::failure An I/O error occurred while reading a sample source.
+  std::vector<char> WriteToVector();
+
+  /// Returns the size of the sample datapoints that deduplication saves.
+  /// @return the number of bytes that SFWriteOptions::deduplicate_samples
+  /// removes from the sample pool.
+  /// @throws std::logic_error The SoundFont has a structural error.
+  /// @throws std::ios_base::failure An I/O error occurred while reading a sample source.
+  /// @remarks The samples of the same length are hashed, as they are when writing.
+  size_t GetDuplicateSampleSize() const;
+
+  /// Keeps the data of every sample compressed in memory until it is written.
+  /// @remarks Samples added afterwards are not compressed; call
+  /// SFSample::CompressData or this function again for them.
+  /// @see SFSampleData::Compress
+  void CompressSamples();
+
+  /// Removes the generators that do not change the sound.
+  ///
+  /// A generator of a local zone is removed when it equals the generator of
+  /// the global zone, or the default value when the global zone lacks it.
+  /// A key or velocity range of a local zone is kept when it equals the
+  /// range of the global zone. A generator of a global zone is removed when it equals the default
+  /// value, and a global zone left empty is removed. The default value of a
+  /// preset generator is no change, since it is added to the instrument value.
+  /// @return the removed generators and global zones.
+  SFOptimizationReport RemoveRedundantGenerators();
+
+  /// Moves the generators and modulators shared by the zones of each preset
+  /// and instrument into its global zone.
+  ///
+  /// A generator goes to the global zone with the value that most zones
+  /// have, and only the zones with another value keep their own generator.
+  /// A modulator goes to the global zone only when every zone has it. The
+  /// sound does not change, and nothing is moved unless it saves records.
+  /// @return the hoisted generators and modulators.
+  /// @remarks The key and velocity ranges are left in the zones.
+  SFOptimizationReport HoistToGlobalZones();
+
+  /// Splits the SoundFont into SoundFonts that each fit in a SoundFont file.
+  /// @return the shards, in the order of their presets.
+  /// @throws std::logic_error A preset does not fit in a file by itself,
+  /// or the SoundFont has a structural error.
+  /// @remarks The presets are packed into shards in order. Each shard has
+  /// its own copy of the instruments and samples its presets refer to, and
+  /// the sample data is shared with this SoundFont. Instruments and samples
+  /// that no preset refers to are kept after the presets, in the last shard
+  /// or in new shards when it is full.
+  std::vector<SoundFont> Split() const;
+
+  /// Writes the SoundFont to as many files as needed to stay within the limits of a file.
+  /// @param filename the name of the SoundFont file; the shards are named by
+  /// inserting the shard number before the extension ("bank-1.sf2", "bank-2.sf2", ...).
+  /// @return the manifest of which shard file contains each preset.
+  /// @throws std::logic_error A preset does not fit in a file by itself,
+  /// or the SoundFont has a structural error.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  SFShardManifest WriteSharded(const std::string & filename);
+
+  /// Writes the SoundFont to as many files as needed using the specified options.
+  /// @param filename the name of the SoundFont file.
+  /// @param options the options for writing each shard.
+  /// @return the manifest of which shard file contains each preset.
+  /// @throws std::logic_error A preset does not fit in a file by itself,
+  /// or the SoundFont has a structural error.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  SFShardManifest WriteSharded(const std::string & filename, const SFWriteOptions & options);
+
 private:
   /// The default value of the target sound engine.
   static constexpr auto kDefaultTargetSoundEngine = "EMU8000";
@@ -411,60 +685,126 @@ private:
   static constexpr auto kDefaultBankName = "Unnamed";
 
   /// Sets backward references of every children elements.
+  /// @remarks The holes left by removed elements are closed up first.
   void SetBackwardReferences() noexcept;
 
+  /// Closes up the holes left by removed elements, if any.
+  void CompactLists() const noexcept {
+    if (has_removed_elements_.load(std::memory_order_acquire)) {
+      CompactListsNow();
+    }
+  }
+
+  /// Closes up the holes left by removed elements in every list.
+  void CompactListsNow() const noexcept;
+
+  /// Updates the index of the presets from the specified position.
+  /// @param first the first preset whose position may have changed.
+  void ReindexPresets(
+      std::vector<std::shared_ptr<SFPreset>>::const_iterator first) noexcept;
+
+  /// Updates the index of the instruments from the specified position.
+  /// @param first the first instrument whose position may have changed.
+  void ReindexInstruments(
+      std::vector<std::shared_ptr<SFInstrument>>::const_iterator first) noexcept;
+
+  /// Updates the index of the samples from the specified position.
+  /// @param first the first sample whose position may have changed.
+  void ReindexSamples(
+      std::vector<std::shared_ptr<SFSample>>::const_iterator first) noexcept;
+
+  /// Builds the lookup tables, unless they are up to date.
+  /// @remarks The caller must hold index_mutex_.
+  void BuildIndex() const;
+
+  /// Drops the lookup tables, which are rebuilt by the next lookup.
+  void InvalidateIndex() noexcept;
+
+  /// Adds a preset to the lookup tables, if they are built.
+  /// @param preset a preset of this SoundFont.
+  /// @remarks The tables are dropped if they cannot grow.
+  void IndexElement(const SFPreset & preset) noexcept;
+
+  /// Removes a preset from the lookup tables, if they are built.
+  /// @param preset a preset of this SoundFont.
+  void UnindexElement(const SFPreset & preset) noexcept;
+
+  /// Adds an instrument to the lookup tables, if they are built.
+  /// @param instrument an instrument of this SoundFont.
+  /// @remarks The tables are dropped if they cannot grow.
+  void IndexElement(const SFInstrument & instrument) noexcept;
+
+  /// Removes an instrument from the lookup tables, if they are built.
+  /// @param instrument an instrument of this SoundFont.
+  void UnindexElement(const SFInstrument & instrument) noexcept;
+
+  /// Adds a sample to the lookup tables, if they are built.
+  /// @param sample a sample of this SoundFont.
+  /// @remarks The tables are dropped if they cannot grow.
+  void IndexElement(const SFSample & sample) noexcept;
+
+  /// Removes a sample from the lookup tables, if they are built.
+  /// @param sample a sample of this SoundFont.
+  void UnindexElement(const SFSample & sample) noexcept;
+
+  /// Returns the first element of a list among the entries of a lookup table.
+  /// @param list the list of presets, instruments or samples of this SoundFont.
+  /// @param index the lookup table of the list.
+  /// @param key the key to look up.
+  /// @return the element with the lowest position, or nullptr if the key is not found.
+  template <typename T, typename Key>
+  static std::shared_ptr<T> FindElement(const std::vector<std::shared_ptr<T>> & list,
+      const std::unordered_multimap<Key, const T *> & index,
+      const Key & key);
+
+  /// Removes elements from a list, keeping the order of the other elements.
+  /// @param list the list of presets, instruments or samples of this SoundFont.
+  /// @param elements the elements to remove.
+  template <typename T>
+  void RemoveElements(std::vector<std::shared_ptr<T>> & list,
+      const std::vector<std::shared_ptr<T>> & elements);
+
+  /// Closes up the holes left by removed elements, keeping the order of the other elements.
+  /// @param list the list of presets, instruments or samples of this SoundFont.
+  template <typename T>
+  static void CloseUp(std::vector<std::shared_ptr<T>> & list) noexcept;
+
   /// Repairs references in the copied children elements.
   /// @param origin a SoundFont object used to construct this SoundFont object.
   void RepairReferences(const SoundFont & origin);
 
-  /// Corrects the instrument pointer in a copied preset.
-  /// @param preset the preset to be corrected.
-  /// @param instrument_map a map containing original instruments as keys and copied instruments as map values.
-  static void RepairPresetReference(
-      SFPreset & preset,
-      const std::unordered_map<std::shared_ptr<SFInstrument>,
-      std::shared_ptr<SFInstrument>> & instrument_map);
-
-  /// Corrects the instrument pointer in a copied preset zone.
-  /// @param preset_zone the preset zone to be corrected.
-  /// @param instrument_map a map containing original instruments as keys and copied instruments as map values.
-  static void RepairPresetZoneReference(
-      SFPresetZone & preset_zone,
-      const std::unordered_map<std::shared_ptr<SFInstrument>,
-      std::shared_ptr<SFInstrument>> & instrument_map);
-
-  /// Corrects the sample pointer in a copied instrument.
-  /// @param instrument the instrument to be corrected.
-  /// @param sample_map a map containing original samples as keys and copied samples as map values.
-  static void RepairInstrumentReference(
-      SFInstrument & instrument,
-      const std::unordered_map<std::shared_ptr<SFSample>,
-      std::shared_ptr<SFSample>> & sample_map);
-
-  /// Corrects the sample pointer in a copied instrument zone.
-  /// @param instrument_zone the instrument zone to be corrected.
-  /// @param sample_map a map containing original samples as keys and copied samples as map values.
-  static void RepairInstrumentZoneReference(
-      SFInstrumentZone & instrument_zone,
-      const std::unordered_map<std::shared_ptr<SFSample>,
-      std::shared_ptr<SFSample>> & sample_map);
-
-  /// Corrects the sample link in a copied sample.
-  /// @param sample the sample to be corrected.
-  /// @param sample_map a map containing original samples as keys and copied samples as map values.
-  static void RepairSampleReference(
-      SFSample & sample,
-      const std::unordered_map<std::shared_ptr<SFSample>,
-      std::shared_ptr<SFSample>> & sample_map);
-
-  /// The list of presets.
-  std::vector<std::shared_ptr<SFPreset>> presets_;
-
-  /// The list of instruments.
-  std::vector<std::shared_ptr<SFInstrument>> instruments_;
-
-  /// The list of samples.
-  std::vector<std::shared_ptr<SFSample>> samples_;
+  /// The arena of the elements.
+  std::shared_ptr<SFArena> arena_;
+
+  /// The list of presets. A removed preset leaves nullptr until the list is closed up.
+  mutable std::vector<std::shared_ptr<SFPreset>> presets_;
+
+  /// The list of instruments. A removed instrument leaves nullptr until the list is closed up.
+  mutable std::vector<std::shared_ptr<SFInstrument>> instruments_;
+
+  /// The list of samples. A removed sample leaves nullptr until the list is closed up.
+  mutable std::vector<std::shared_ptr<SFSample>> samples_;
+
+  /// True if a list may have holes left by removed elements.
+  mutable std::atomic<bool> has_removed_elements_;
+
+  /// The mutex that lets concurrent lookups build the lookup tables once.
+  mutable std::mutex index_mutex_;
+
+  /// True if the lookup tables are built.
+  mutable bool indexed_;
+
+  /// The presets by their bank and preset number, as (bank << 16) | preset_number.
+  mutable std::unordered_multimap<uint32_t, const SFPreset *> preset_number_index_;
+
+  /// The presets by their name.
+  mutable std::unordered_multimap<std::string, const SFPreset *> preset_name_index_;
+
+  /// The instruments by their name.
+  mutable std::unordered_multimap<std::string, const SFInstrument *> instrument_name_index_;
+
+  /// The samples by their name.
+  mutable std::unordered_multimap<std::string, const SFSample *> sample_name_index_;
 
   /// The target sound engine name.
   std::string sound_engine_;
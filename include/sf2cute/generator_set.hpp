@@ -0,0 +1,234 @@
+/// @file
+/// SoundFont 2 Generator set class header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_GENERATOR_SET_HPP_
+#define SF2CUTE_GENERATOR_SET_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <array>
+#include <iterator>
+
+#include "types.hpp"
+#include "generator_item.hpp"
+
+namespace sf2cute {
+
+/// The SFGeneratorSet class represents the generators of a zone.
+///
+/// The amounts are stored in a flat array indexed by SFGenerator, and a
+/// bitmask tells which generators are present. Setting, finding and
+/// removing a generator take constant time and never allocate.
+///
+/// The generators are always iterated in the order required by the
+/// generator chunk (see SFGeneratorItem::Compare), so they can be written
+/// as they are without sorting.
+class SFGeneratorSet {
+public:
+  /// Unsigned integer type for the number of generators.
+  using size_type = size_t;
+
+  /// The number of generator types that can be stored.
+  static constexpr size_type kCapacity = static_cast<size_type>(SFGenerator::kEndOper);
+
+  /// The const_iterator class represents a read-only iterator over the present generators,
+  /// in the order required by the generator chunk.
+  class const_iterator {
+  public:
+    /// The iterator category.
+    using iterator_category = std::forward_iterator_tag;
+
+    /// The type of a generator.
+    using value_type = SFGeneratorItem;
+
+    /// The type of the distance between iterators.
+    using difference_type = ptrdiff_t;
+
+    /// The pointer type to a generator.
+    using pointer = const SFGeneratorItem *;
+
+    /// The reference type to a generator.
+    using reference = const SFGeneratorItem &;
+
+    /// Constructs a new past-the-end iterator.
+    const_iterator() noexcept :
+        set_(nullptr),
+        position_(kCapacity) {
+    }
+
+    /// Returns the current generator.
+    /// @return the current generator.
+    reference operator*() const noexcept {
+      return item_;
+    }
+
+    /// Returns the current generator.
+    /// @return a pointer to the current generator.
+    pointer operator->() const noexcept {
+      return &item_;
+    }
+
+    /// Advances the iterator to the next generator.
+    /// @return this iterator.
+    const_iterator & operator++() noexcept {
+      position_++;
+      Seek();
+      return *this;
+    }
+
+    /// Advances the iterator to the next generator.
+    /// @return the iterator before the increment.
+    const_iterator operator++(int) noexcept {
+      const_iterator it = *this;
+      ++*this;
+      return it;
+    }
+
+    /// Indicates two iterators point to the same generator.
+    /// @param x the first iterator to be compared.
+    /// @param y the second iterator to be compared.
+    /// @return true if the iterators point to the same generator.
+    friend bool operator==(const const_iterator & x, const const_iterator & y) noexcept {
+      return x.position_ == y.position_;
+    }
+
+    /// Indicates two iterators point to different generators.
+    /// @param x the first iterator to be compared.
+    /// @param y the second iterator to be compared.
+    /// @return true if the iterators point to different generators.
+    friend bool operator!=(const const_iterator & x, const const_iterator & y) noexcept {
+      return x.position_ != y.position_;
+    }
+
+  private:
+    friend class SFGeneratorSet;
+
+    /// Constructs a new iterator pointing to the first generator at or after the specified position.
+    /// @param set the generator set.
+    /// @param position the position in the canonical order to start from.
+    const_iterator(const SFGeneratorSet * set, size_type position) noexcept :
+        set_(set),
+        position_(position) {
+      Seek();
+    }
+
+    /// Moves to the first present generator at or after the current position.
+    void Seek() noexcept {
+      while (position_ < kCapacity) {
+        const size_type index = kCanonicalOrder[position_];
+        if ((set_->mask_ & (uint64_t(1) << index)) != 0) {
+          item_ = SFGeneratorItem(SFGenerator(index), set_->amounts_[index]);
+          break;
+        }
+        position_++;
+      }
+    }
+
+    /// The generator set.
+    const SFGeneratorSet * set_;
+
+    /// The position of the current generator in the canonical order.
+    size_type position_;
+
+    /// The current generator.
+    SFGeneratorItem item_;
+  };
+
+  /// Constructs a new empty SFGeneratorSet.
+  SFGeneratorSet() noexcept;
+
+  /// Returns the number of generators.
+  /// @return the number of present generators.
+  size_type size() const noexcept;
+
+  /// Returns true if there are no generators.
+  /// @return true if there are no generators.
+  bool empty() const noexcept {
+    return mask_ == 0;
+  }
+
+  /// Returns an iterator to the first generator.
+  /// @return an iterator to the first generator.
+  const_iterator begin() const noexcept {
+    return const_iterator(this, 0);
+  }
+
+  /// Returns an iterator past the last generator.
+  /// @return an iterator past the last generator.
+  const_iterator end() const noexcept {
+    return const_iterator();
+  }
+
+  /// Returns true if the specified generator is present.
+  /// @param op the type of the generator.
+  /// @return true if the generator is present.
+  bool Contains(SFGenerator op) const noexcept {
+    return IsValid(op) && (mask_ & Bit(op)) != 0;
+  }
+
+  /// Finds the specified generator.
+  /// @param op the type of the generator.
+  /// @return the position of the generator, or end() if no such generator is found.
+  const_iterator Find(SFGenerator op) const noexcept {
+    return Contains(op) ?
+        const_iterator(this, kCanonicalPosition[static_cast<size_type>(op)]) : end();
+  }
+
+  /// Returns the amount of the specified generator.
+  /// @param op the type of the generator.
+  /// @return the amount, or zero if the generator is not present.
+  GenAmountType amount(SFGenerator op) const noexcept {
+    return Contains(op) ? amounts_[static_cast<size_type>(op)] : GenAmountType();
+  }
+
+  /// Sets a generator, overwriting an existing generator of the same type.
+  /// @param generator the generator.
+  /// @throws std::invalid_argument The generator type is not valid.
+  void Set(const SFGeneratorItem & generator);
+
+  /// Removes the specified generator.
+  /// @param op the type of the generator.
+  void Remove(SFGenerator op) noexcept {
+    if (IsValid(op)) {
+      mask_ &= ~Bit(op);
+    }
+  }
+
+  /// Removes all of the generators.
+  void Clear() noexcept {
+    mask_ = 0;
+  }
+
+  /// Returns true if the specified generator type can be stored.
+  /// @param op the type of the generator.
+  /// @return true if the generator type is valid.
+  static bool IsValid(SFGenerator op) noexcept {
+    return static_cast<size_type>(op) < kCapacity;
+  }
+
+private:
+  /// The generator types in the order required by the generator chunk.
+  static const std::array<uint8_t, kCapacity> kCanonicalOrder;
+
+  /// The position of each generator type in kCanonicalOrder.
+  static const std::array<uint8_t, kCapacity> kCanonicalPosition;
+
+  /// Returns the bit of the specified generator in the mask.
+  /// @param op the type of the generator.
+  /// @return the bit of the generator.
+  static uint64_t Bit(SFGenerator op) noexcept {
+    return uint64_t(1) << static_cast<size_type>(op);
+  }
+
+  /// The bitmask of present generators, indexed by SFGenerator.
+  uint64_t mask_;
+
+  /// The amounts of generators, indexed by SFGenerator.
+  std::array<GenAmountType, kCapacity> amounts_;
+};
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_GENERATOR_SET_HPP_
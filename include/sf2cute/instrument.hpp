@@ -6,6 +6,7 @@
 #ifndef SF2CUTE_INSTRUMENT_HPP_
 #define SF2CUTE_INSTRUMENT_HPP_
 
+#include <stddef.h>
 #include <algorithm>
 #include <memory>
 #include <utility>
@@ -27,6 +28,8 @@ class SoundFont;
 class SFInstrument {
   friend class SFInstrumentZone;
   friend class SoundFont;
+  friend class SFRIFFPgenChunk;
+  friend class SoundFontSharder;
 
 public:
   /// Maximum length of instrument name (excluding the terminator byte), in terms of bytes.
@@ -59,6 +62,7 @@ public:
 
   /// Copy-assigns a new value to the SFInstrument, replacing its current contents.
   /// @param origin a SFInstrument object.
+  /// @remarks This object stays in its SoundFont, if any, at the same position.
   SFInstrument & operator=(const SFInstrument & origin);
 
   /// Acquires the contents of specified SFInstrument.
@@ -67,6 +71,7 @@ public:
 
   /// Move-assigns a new value to the SFInstrument, replacing its current contents.
   /// @param origin a SFInstrument object.
+  /// @remarks This object stays in its SoundFont, if any, at the same position.
   SFInstrument & operator=(SFInstrument && origin) noexcept;
 
   /// Destructs the SFInstrument.
@@ -88,9 +93,7 @@ public:
 
   /// Sets the name of this instrument.
   /// @param name the name of this instrument.
-  void set_name(std::string name) {
-    name_ = std::move(name);
-  }
+  void set_name(std::string name);
 
   /// Returns the list of instrument zones.
   /// @return the list of instrument zones assigned to the instruemnt.
@@ -166,8 +169,10 @@ public:
 private:
   /// Sets the parent file.
   /// @param parent_file the parent file.
-  void set_parent_file(SoundFont & parent_file) noexcept {
+  /// @param file_index the index of the instrument in the parent file.
+  void set_parent_file(SoundFont & parent_file, size_t file_index) noexcept {
     parent_file_ = &parent_file;
+    file_index_ = file_index;
   }
 
   /// Resets the parent file.
@@ -189,6 +194,9 @@ private:
 
   /// The parent file.
   SoundFont * parent_file_;
+
+  /// The index of the instrument in the parent file, valid while the instrument has a parent file.
+  size_t file_index_;
 };
 
 } // namespace sf2cute
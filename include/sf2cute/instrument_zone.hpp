@@ -26,6 +26,7 @@ class SoundFont;
 /// @see "7.6 The IBAG Sub-chunk". In SoundFont Technical Specification 2.04.
 class SFInstrumentZone : public SFZone {
   friend class SFInstrument;
+  friend class SoundFont;
 
 public:
   /// Constructs a new empty SFInstrumentZone.
@@ -6,10 +6,12 @@
 #ifndef SF2CUTE_MODULATOR_ITEM_HPP_
 #define SF2CUTE_MODULATOR_ITEM_HPP_
 
+#include <stddef.h>
 #include <stdint.h>
 #include <algorithm>
 
 #include "types.hpp"
+#include "arena.hpp"
 #include "modulator.hpp"
 #include "modulator_key.hpp"
 
@@ -56,6 +58,20 @@ public:
   /// Destructs the SFModulatorItem.
   ~SFModulatorItem() = default;
 
+  /// Allocates a modulator, from the current arena if any.
+  /// @param size the size of the modulator.
+  /// @return a pointer to the modulator.
+  /// @see SFArena::Scope
+  static void * operator new(size_t size) {
+    return SFArena::AllocateNode(size);
+  }
+
+  /// Frees a modulator.
+  /// @param pointer a pointer to the modulator.
+  static void operator delete(void * pointer) noexcept {
+    SFArena::DeallocateNode(pointer);
+  }
+
   /// Returns the unique key of the modulator.
   /// @return the unique key of the modulator.
   /// @remarks Using source_op(), destination_op() or amount_source_op() is recommended for an individual member access.
@@ -0,0 +1,155 @@
+/// @file
+/// SoundFont 2 Optimization report class header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_OPTIMIZATION_REPORT_HPP_
+#define SF2CUTE_OPTIMIZATION_REPORT_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include "types.hpp"
+
+namespace sf2cute {
+
+/// The SFOptimizationReport class represents what an optimization pass changed in a SoundFont.
+///
+/// @see SoundFont::RemoveRedundantGenerators
+/// @see SoundFont::HoistToGlobalZones
+class SFOptimizationReport {
+public:
+  /// The zone index of a global zone.
+  static constexpr size_t kGlobalZone = static_cast<size_t>(-1);
+
+  /// The Element enum represents the kind of element that a change applies to.
+  enum class Element : uint8_t {
+    /// A preset.
+    kPreset = 0,
+
+    /// An instrument.
+    kInstrument
+  };
+
+  /// The Reason enum represents why a generator was changed.
+  enum class Reason : uint8_t {
+    /// The amount equals the default value of the generator.
+    kDefault = 0,
+
+    /// The amount equals the amount set in the global zone.
+    kGlobalZone,
+
+    /// The global zone was left without generators and modulators.
+    kEmptyGlobalZone,
+
+    /// The generator was moved from the local zones to the global zone.
+    kHoistedGenerator,
+
+    /// The modulator was moved from the local zones to the global zone.
+    kHoistedModulator
+  };
+
+  /// The Entry struct represents a removed or hoisted generator, a hoisted
+  /// modulator, or a removed global zone.
+  struct Entry {
+    /// The kind of element.
+    Element element;
+
+    /// The index of the element in the preset or instrument list.
+    size_t element_index;
+
+    /// The name of the element.
+    std::string element_name;
+
+    /// The index of the zone in the zone list of the element, or kGlobalZone.
+    size_t zone_index;
+
+    /// The type of the generator, or the destination of the modulator,
+    /// unused for an empty global zone.
+    SFGenerator op;
+
+    /// The amount of the generator or the modulator, unused for an empty global zone.
+    GenAmountType amount;
+
+    /// The reason for the change.
+    Reason reason;
+
+    /// The number of generator, modulator or zone records saved by the change.
+    /// A global zone created to hold hoisted items is counted against the
+    /// first item hoisted into it.
+    size_t num_records;
+  };
+
+  /// Constructs a new empty SFOptimizationReport.
+  SFOptimizationReport() = default;
+
+  /// Constructs a new copy of specified SFOptimizationReport.
+  /// @param origin a SFOptimizationReport object.
+  SFOptimizationReport(const SFOptimizationReport & origin) = default;
+
+  /// Copy-assigns a new value to the SFOptimizationReport, replacing its current contents.
+  /// @param origin a SFOptimizationReport object.
+  SFOptimizationReport & operator=(const SFOptimizationReport & origin) = default;
+
+  /// Acquires the contents of specified SFOptimizationReport.
+  /// @param origin a SFOptimizationReport object.
+  SFOptimizationReport(SFOptimizationReport && origin) = default;
+
+  /// Move-assigns a new value to the SFOptimizationReport, replacing its current contents.
+  /// @param origin a SFOptimizationReport object.
+  SFOptimizationReport & operator=(SFOptimizationReport && origin) = default;
+
+  /// Destructs the SFOptimizationReport.
+  ~SFOptimizationReport() = default;
+
+  /// Returns the changes.
+  /// @return the changes, in the order they were made.
+  const std::vector<Entry> & entries() const noexcept {
+    return entries_;
+  }
+
+  /// Returns the number of generators removed from presets.
+  /// @return the number of pgen records saved.
+  size_t num_preset_generators() const noexcept;
+
+  /// Returns the number of generators removed from instruments.
+  /// @return the number of igen records saved.
+  size_t num_instrument_generators() const noexcept;
+
+  /// Returns the number of global zones removed.
+  /// @return the number of pbag and ibag records saved.
+  size_t num_global_zones() const noexcept;
+
+  /// Returns the number of records saved by every change.
+  /// @return the number of pdta records saved.
+  size_t num_records_saved() const noexcept;
+
+  /// Appends a change.
+  /// @param entry the change.
+  void AddEntry(Entry entry);
+
+  /// Writes the report as tab-separated text.
+  ///
+  /// Each line after the header line has the kind of element, the index and
+  /// the name of the element, the zone index ("global" for a global zone),
+  /// the generator type and amount, the reason and the number of records saved.
+  /// @param out the output stream to write to.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  void Write(std::ostream & out) const;
+
+private:
+  /// Returns the number of removed generators of the specified kind of element.
+  /// @param element the kind of element.
+  /// @return the number of removed generators.
+  size_t CountGenerators(Element element) const noexcept;
+
+  /// The changes.
+  std::vector<Entry> entries_;
+};
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_OPTIMIZATION_REPORT_HPP_
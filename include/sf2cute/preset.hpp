@@ -6,6 +6,7 @@
 #ifndef SF2CUTE_PRESET_HPP_
 #define SF2CUTE_PRESET_HPP_
 
+#include <stddef.h>
 #include <stdint.h>
 #include <algorithm>
 #include <memory>
@@ -77,6 +78,7 @@ public:
 
   /// Copy-assigns a new value to the SFPreset, replacing its current contents.
   /// @param origin a SFPreset object.
+  /// @remarks This object stays in its SoundFont, if any, at the same position.
   SFPreset & operator=(const SFPreset & origin);
 
   /// Acquires the contents of specified SFPreset.
@@ -85,6 +87,7 @@ public:
 
   /// Move-assigns a new value to the SFPreset, replacing its current contents.
   /// @param origin a SFPreset object.
+  /// @remarks This object stays in its SoundFont, if any, at the same position.
   SFPreset & operator=(SFPreset && origin) noexcept;
 
   /// Destructs the SFPreset.
@@ -106,9 +109,7 @@ public:
 
   /// Sets the name of this preset.
   /// @param name the name of this preset.
-  void set_name(std::string name) {
-    name_ = std::move(name);
-  }
+  void set_name(std::string name);
 
   /// Returns the preset number.
   /// @return the preset number.
@@ -118,9 +119,7 @@ public:
 
   /// Sets the preset number.
   /// @param preset_number the preset number.
-  void set_preset_number(uint16_t preset_number) {
-    preset_number_ = std::move(preset_number);
-  }
+  void set_preset_number(uint16_t preset_number);
 
   /// Returns the bank number.
   /// @return the bank number.
@@ -130,9 +129,7 @@ public:
 
   /// Sets the bank number.
   /// @param bank the bank number.
-  void set_bank(uint16_t bank) {
-    bank_ = std::move(bank);
-  }
+  void set_bank(uint16_t bank);
 
   /// Returns the library.
   /// @return the library.
@@ -250,8 +247,10 @@ public:
 private:
   /// Sets the parent file.
   /// @param parent_file the parent file.
-  void set_parent_file(SoundFont & parent_file) noexcept {
+  /// @param file_index the index of the preset in the parent file.
+  void set_parent_file(SoundFont & parent_file, size_t file_index) noexcept {
     parent_file_ = &parent_file;
+    file_index_ = file_index;
   }
 
   /// Resets the parent file.
@@ -288,6 +287,9 @@ private:
 
   /// The parent file.
   SoundFont * parent_file_;
+
+  /// The index of the preset in the parent file, valid while the preset has a parent file.
+  size_t file_index_;
 };
 
 } // namespace sf2cute
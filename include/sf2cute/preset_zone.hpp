@@ -26,6 +26,7 @@ class SoundFont;
 /// @see "7.3 The PBAG Sub-chunk". In SoundFont Technical Specification 2.04.
 class SFPresetZone : public SFZone {
   friend class SFPreset;
+  friend class SoundFont;
 
 public:
   /// Constructs a new empty SFPresetZone.
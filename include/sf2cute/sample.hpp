@@ -6,6 +6,7 @@
 #ifndef SF2CUTE_SAMPLE_HPP_
 #define SF2CUTE_SAMPLE_HPP_
 
+#include <stddef.h>
 #include <stdint.h>
 #include <algorithm>
 #include <memory>
@@ -13,6 +14,7 @@
 #include <vector>
 
 #include "types.hpp"
+#include "sample_data.hpp"
 
 namespace sf2cute {
 
@@ -30,6 +32,9 @@ class SoundFontWriter;
 /// In SoundFont Technical Specification 2.04.
 class SFSample {
   friend class SoundFont;
+  friend class SFRIFFIgenChunk;
+  friend class SFRIFFShdrChunk;
+  friend class SoundFontSharder;
   friend class SoundFontWriter;
 
 public:
@@ -48,14 +53,14 @@ public:
 
   /// Constructs a new SFSample.
   /// @param name the name of the sample.
-  /// @param data the sample data
+  /// @param data the sample data, owned, viewed from an external buffer, or streamed from a source.
   /// @param start_loop the beginning index of the loop, in sample data points, inclusive.
   /// @param end_loop the ending index of the loop, in sample data points, exclusive.
   /// @param sample_rate the sample rate, in hertz.
   /// @param original_key the MIDI key number of the recorded pitch of the sample.
   /// @param correction the pitch correction that should be applied to the sample, in cents.
   SFSample(std::string name,
-      std::vector<int16_t> data,
+      SFSampleData data,
       uint32_t start_loop,
       uint32_t end_loop,
       uint32_t sample_rate,
@@ -64,7 +69,7 @@ public:
 
   /// Constructs a new SFSample with a sample link.
   /// @param name the name of the sample.
-  /// @param data the sample data
+  /// @param data the sample data, owned, viewed from an external buffer, or streamed from a source.
   /// @param start_loop the beginning index of the loop, in sample data points, inclusive.
   /// @param end_loop the ending index of the loop, in sample data points, exclusive.
   /// @param sample_rate the sample rate, in hertz.
@@ -73,7 +78,7 @@ public:
   /// @param link the associated right or left stereo sample. nullptr is allowed.
   /// @param type both the type of sample and the whether the sample is located in RAM or ROM memory.
   SFSample(std::string name,
-      std::vector<int16_t> data,
+      SFSampleData data,
       uint32_t start_loop,
       uint32_t end_loop,
       uint32_t sample_rate,
@@ -88,15 +93,17 @@ public:
 
   /// Copy-assigns a new value to the SFSample, replacing its current contents.
   /// @param origin a SFSample object.
+  /// @remarks This object stays in its SoundFont, if any, at the same position.
   SFSample & operator=(const SFSample & origin);
 
   /// Acquires the contents of specified SFSample.
   /// @param origin a SFSample object.
-  SFSample(SFSample && origin) = default;
+  SFSample(SFSample && origin) noexcept;
 
   /// Move-assigns a new value to the SFSample, replacing its current contents.
   /// @param origin a SFSample object.
-  SFSample & operator=(SFSample && origin) = default;
+  /// @remarks This object stays in its SoundFont, if any, at the same position.
+  SFSample & operator=(SFSample && origin) noexcept;
 
   /// Destructs the SFSample.
   ~SFSample() = default;
@@ -117,9 +124,7 @@ public:
 
   /// Sets the name of this sample.
   /// @param name the name of this sample.
-  void set_name(std::string name) {
-    name_ = std::move(name);
-  }
+  void set_name(std::string name);
 
   /// Returns the starting point of the loop of this sample.
   /// @return the beginning index of the loop, in sample data points, inclusive.
@@ -220,10 +225,32 @@ public:
 
   /// Returns the sample data.
   /// @return the sample data.
-  const std::vector<int16_t> & data() const noexcept {
+  const SFSampleData & data() const noexcept {
     return data_;
   }
 
+  /// Modifies a copy of the sample datapoints, and replaces the datapoints with it.
+  /// @param modify the function that receives the copy as std::vector<int16_t>&.
+  /// @throws std::ios_base::failure An I/O error occurred while reading a sample source.
+  /// @remarks Copies of this sample keep the datapoints they share.
+  /// @see SFSampleData::Modify
+  template <typename Function>
+  void ModifyData(Function modify) {
+    data_.Modify(std::move(modify));
+  }
+
+  /// Sets the sample data.
+  /// @param data the sample data.
+  void set_data(SFSampleData data) noexcept {
+    data_ = std::move(data);
+  }
+
+  /// Keeps the sample data compressed in memory until it is written.
+  /// @see SFSampleData::Compress
+  void CompressData() {
+    data_.Compress();
+  }
+
   /// Returns true if this sample has a parent file.
   /// @return true if this sample has a parent file.
   bool has_parent_file() const noexcept {
@@ -239,8 +266,10 @@ public:
 private:
   /// Sets the parent file.
   /// @param parent_file the parent file.
-  void set_parent_file(SoundFont & parent_file) noexcept {
+  /// @param file_index the index of the sample in the parent file.
+  void set_parent_file(SoundFont & parent_file, size_t file_index) noexcept {
     parent_file_ = &parent_file;
+    file_index_ = file_index;
   }
 
   /// Resets the parent file.
@@ -273,10 +302,13 @@ private:
   SFSampleLink type_;
 
   /// The sample data.
-  std::vector<int16_t> data_;
+  SFSampleData data_;
 
   /// The parent file.
   SoundFont * parent_file_;
+
+  /// The index of the sample in the parent file, valid while the sample has a parent file.
+  size_t file_index_;
 };
 
 } // namespace sf2cute
@@ -0,0 +1,213 @@
+/// @file
+/// SoundFont 2 Sample data class header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_SAMPLE_DATA_HPP_
+#define SF2CUTE_SAMPLE_DATA_HPP_
+
+#include <stdint.h>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <stdexcept>
+
+#include "sample_source.hpp"
+
+namespace sf2cute {
+
+/// The SFSampleData class represents the datapoints of a sample.
+///
+/// The datapoints are either owned by the object, or viewed from a
+/// read-only buffer owned by someone else (for example, the "smpl" chunk
+/// of a memory-mapped file, or the output buffer of a decoder).
+/// Copying a view is cheap and never touches the datapoints.
+///
+/// Owned datapoints are immutable, reference-counted and shared between
+/// copies. Modify copies the datapoints, lets a function change the copy,
+/// and then replaces the shared datapoints of this object only, so other
+/// copies never see the change.
+///
+/// The datapoints can also be streamed from an SFSampleSource. Streamed
+/// datapoints are not resident in memory: data() returns nullptr, iterating
+/// or indexing them throws std::logic_error, and they are pulled in blocks
+/// through Read (or copied at once through ToVector) instead.
+class SFSampleData {
+public:
+  /// Unsigned integer type for the number of datapoints.
+  using size_type = std::vector<int16_t>::size_type;
+
+  /// The type of a datapoint.
+  using value_type = int16_t;
+
+  /// The iterator type for read-only access.
+  using const_iterator = const int16_t *;
+
+  /// Constructs a new empty SFSampleData.
+  SFSampleData() noexcept;
+
+  /// Constructs a new SFSampleData that owns the specified datapoints.
+  /// @param data the sample datapoints.
+  SFSampleData(std::vector<int16_t> data);
+
+  /// Constructs a new SFSampleData that views a read-only buffer.
+  /// @param data a pointer to the first datapoint, in native byte order.
+  /// @param size the number of datapoints.
+  /// @param buffer the owner of the buffer, kept alive as long as the view.
+  /// nullptr is allowed, in which case the caller must keep the buffer alive.
+  SFSampleData(const int16_t * data,
+      size_type size,
+      std::shared_ptr<const void> buffer) noexcept;
+
+  /// Constructs a new SFSampleData that views a shared vector.
+  /// @param data the shared sample datapoints.
+  SFSampleData(std::shared_ptr<const std::vector<int16_t>> data) noexcept;
+
+  /// Constructs a new SFSampleData that streams the datapoints from a source.
+  /// @param source the source of the datapoints.
+  SFSampleData(std::shared_ptr<const SFSampleSource> source) noexcept;
+
+  /// Constructs a new copy of specified SFSampleData.
+  /// @param origin a SFSampleData object.
+  SFSampleData(const SFSampleData & origin) = default;
+
+  /// Copy-assigns a new value to the SFSampleData, replacing its current contents.
+  /// @param origin a SFSampleData object.
+  SFSampleData & operator=(const SFSampleData & origin) = default;
+
+  /// Acquires the contents of specified SFSampleData.
+  /// @param origin a SFSampleData object.
+  SFSampleData(SFSampleData && origin) = default;
+
+  /// Move-assigns a new value to the SFSampleData, replacing its current contents.
+  /// @param origin a SFSampleData object.
+  SFSampleData & operator=(SFSampleData && origin) = default;
+
+  /// Destructs the SFSampleData.
+  ~SFSampleData() = default;
+
+  /// Returns a pointer to the datapoints.
+  /// @return a pointer to the first datapoint, or nullptr if the datapoints are streamed.
+  const int16_t * data() const noexcept {
+    return view_ ? view_.get() : (owned_ ? owned_->data() : nullptr);
+  }
+
+  /// Returns the number of datapoints.
+  /// @return the number of datapoints.
+  size_type size() const noexcept {
+    return view_ ? view_size_ : (owned_ ? owned_->size() : (source_ ? source_->size() : 0));
+  }
+
+  /// Returns true if there are no datapoints.
+  /// @return true if there are no datapoints.
+  bool empty() const noexcept {
+    return size() == 0;
+  }
+
+  /// Returns an iterator to the first datapoint.
+  /// @return an iterator to the first datapoint.
+  /// @throws std::logic_error The datapoints are streamed; use Read or ToVector instead.
+  const_iterator begin() const {
+    return resident_data();
+  }
+
+  /// Returns an iterator past the last datapoint.
+  /// @return an iterator past the last datapoint.
+  /// @throws std::logic_error The datapoints are streamed; use Read or ToVector instead.
+  const_iterator end() const {
+    return resident_data() + size();
+  }
+
+  /// Returns the datapoint at the specified index.
+  /// @param index the index of the datapoint.
+  /// @return the datapoint.
+  /// @throws std::logic_error The datapoints are streamed; use Read or ToVector instead.
+  int16_t operator[](size_type index) const {
+    return resident_data()[index];
+  }
+
+  /// Returns true if the datapoints are viewed from a buffer owned by someone else.
+  /// @return true if the datapoints are not owned by this object.
+  bool is_view() const noexcept {
+    return static_cast<bool>(view_);
+  }
+
+  /// Returns true if the datapoints are shared with another SFSampleData.
+  /// @return true if the datapoints are shared by copies of this object.
+  bool is_shared() const noexcept {
+    return view_ ? view_.use_count() > 1 :
+        (owned_ ? owned_.use_count() > 1 : source_.use_count() > 1);
+  }
+
+  /// Returns true if the datapoints are streamed from a source.
+  /// @return true if the datapoints are not resident in memory.
+  bool is_streamed() const noexcept {
+    return static_cast<bool>(source_);
+  }
+
+  /// Returns the source of the streamed datapoints.
+  /// @return the source, or nullptr if the datapoints are resident in memory.
+  const std::shared_ptr<const SFSampleSource> & source() const noexcept {
+    return source_;
+  }
+
+  /// Copies datapoints to a buffer, pulling them from the source if streamed.
+  /// @param offset the index of the first datapoint to copy.
+  /// @param buffer the buffer that receives the datapoints, in native byte order.
+  /// @param length the number of datapoints to copy.
+  /// @throws std::out_of_range The range exceeds the number of datapoints.
+  /// @throws std::ios_base::failure An I/O error occurred while reading the source.
+  void Read(size_type offset, int16_t * buffer, size_type length) const;
+
+  /// Modifies a copy of the datapoints, and replaces the datapoints with it.
+  /// @param modify the function that receives the copy as std::vector<int16_t>&.
+  /// @throws std::ios_base::failure An I/O error occurred while reading the source.
+  /// @remarks Copies of this object keep the datapoints they share.
+  template <typename Function>
+  void Modify(Function modify) {
+    std::vector<int16_t> datapoints = ToVector();
+    modify(datapoints);
+    *this = SFSampleData(std::move(datapoints));
+  }
+
+  /// Replaces resident datapoints with a losslessly compressed copy.
+  ///
+  /// The datapoints become streamed from a compressed source, and are
+  /// decompressed block by block when the sample pool is written.
+  /// @remarks Streamed datapoints are left as they are. Owned datapoints
+  /// shared with a copy stay resident until every copy releases them.
+  /// @see SFSampleSource::Compress
+  void Compress();
+
+  /// Returns a copy of the datapoints.
+  /// @return the datapoints.
+  /// @throws std::ios_base::failure An I/O error occurred while reading the source.
+  std::vector<int16_t> ToVector() const;
+
+private:
+  /// Returns a pointer to the resident datapoints.
+  /// @return a pointer to the first datapoint.
+  /// @throws std::logic_error The datapoints are streamed.
+  const int16_t * resident_data() const {
+    if (source_) {
+      throw std::logic_error("Streamed sample datapoints cannot be accessed directly.");
+    }
+    return data();
+  }
+
+  /// The owned datapoints, shared between copies.
+  std::shared_ptr<const std::vector<int16_t>> owned_;
+
+  /// The viewed datapoints, sharing the ownership of their buffer.
+  std::shared_ptr<const int16_t> view_;
+
+  /// The number of viewed datapoints.
+  size_type view_size_;
+
+  /// The source of the streamed datapoints.
+  std::shared_ptr<const SFSampleSource> source_;
+};
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_SAMPLE_DATA_HPP_
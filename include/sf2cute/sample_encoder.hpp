@@ -0,0 +1,58 @@
+/// @file
+/// SoundFont 2 Sample encoder class header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_SAMPLE_ENCODER_HPP_
+#define SF2CUTE_SAMPLE_ENCODER_HPP_
+
+#include <memory>
+#include <vector>
+
+namespace sf2cute {
+
+class SFSample;
+
+/// The SFSampleEncoder class represents a codec for the samples of an SF3 file.
+///
+/// When SFWriteOptions::sample_encoder is set, every sample is encoded into
+/// a self-contained stream, the streams are stored one after another in the
+/// sample pool, and the file is written as an SF3 file: the sample headers
+/// hold the byte range of each stream and the loop points relative to the
+/// sample, and the "ifil" version is 3.1.
+///
+/// @remarks Encode is called from multiple threads at the same time
+/// when a SoundFont is written with more than one thread.
+class SFSampleEncoder {
+public:
+  /// Constructs a new SFSampleEncoder.
+  SFSampleEncoder() = default;
+
+  /// Destructs the SFSampleEncoder.
+  virtual ~SFSampleEncoder() = default;
+
+  SFSampleEncoder(const SFSampleEncoder &) = delete;
+  SFSampleEncoder & operator=(const SFSampleEncoder &) = delete;
+
+  /// Encodes the datapoints of a sample.
+  /// @param sample the sample, whose datapoints are read through SFSampleData::Read.
+  /// @return the encoded stream.
+  /// @throws std::runtime_error The sample could not be encoded.
+  /// @throws std::ios_base::failure An I/O error occurred while reading a sample source.
+  virtual std::vector<char> Encode(const SFSample & sample) const = 0;
+
+  /// Returns true if the library is built with the Ogg Vorbis encoder.
+  /// @return true if CreateVorbis can be used.
+  static bool IsVorbisSupported() noexcept;
+
+  /// Creates an encoder that compresses samples into Ogg Vorbis streams,
+  /// as read by SF3-capable synthesizers.
+  /// @param quality the variable bitrate quality, from -0.1 (smallest) to 1.0 (best).
+  /// @return the encoder.
+  /// @throws std::runtime_error The library is built without libvorbis.
+  static std::shared_ptr<const SFSampleEncoder> CreateVorbis(float quality = 0.4f);
+};
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_SAMPLE_ENCODER_HPP_
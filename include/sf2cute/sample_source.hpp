@@ -0,0 +1,105 @@
+/// @file
+/// SoundFont 2 Sample source class header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_SAMPLE_SOURCE_HPP_
+#define SF2CUTE_SAMPLE_SOURCE_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace sf2cute {
+
+/// The SFSampleSource class represents sample datapoints pulled on demand.
+///
+/// A source knows its length up front, and hands out its datapoints in
+/// blocks when the sample pool is written. The datapoints never need to be
+/// resident in memory all at once, so a bank larger than the available
+/// memory can be written with a bounded buffer.
+///
+/// @remarks Read may be called from multiple threads at the same time
+/// when a SoundFont is written with more than one thread.
+class SFSampleSource {
+public:
+  /// Unsigned integer type for the number of datapoints.
+  using size_type = size_t;
+
+  /// The type of a function that reads datapoints.
+  ///
+  /// The function is called with the index of the first datapoint, a buffer,
+  /// and the number of datapoints to store in the buffer, in native byte order.
+  using ReadFunction = std::function<void(size_type, int16_t *, size_type)>;
+
+  /// Constructs a new SFSampleSource.
+  SFSampleSource() = default;
+
+  /// Destructs the SFSampleSource.
+  virtual ~SFSampleSource() = default;
+
+  SFSampleSource(const SFSampleSource &) = delete;
+  SFSampleSource & operator=(const SFSampleSource &) = delete;
+
+  /// Returns the number of datapoints.
+  /// @return the number of datapoints.
+  virtual size_type size() const noexcept = 0;
+
+  /// Reads datapoints.
+  /// @param offset the index of the first datapoint to read.
+  /// @param buffer the buffer that receives the datapoints, in native byte order.
+  /// @param length the number of datapoints to read.
+  /// @throws std::out_of_range The range exceeds the length of the source.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  virtual void Read(size_type offset, int16_t * buffer, size_type length) const = 0;
+
+  /// Creates a source that reads 16-bit little-endian datapoints from a range of a file.
+  ///
+  /// The range is typically the "data" chunk of a 16-bit PCM WAV file, or
+  /// the "smpl" chunk of another SoundFont. The file is opened immediately
+  /// to check that it exists, and then again for each read, so that many
+  /// sources do not keep many files open.
+  /// @param filename the name of the file.
+  /// @param offset the offset of the first datapoint from the beginning of the file, in terms of bytes.
+  /// @param size the number of datapoints.
+  /// @return the source.
+  /// @throws std::ios_base::failure The file cannot be opened.
+  static std::shared_ptr<const SFSampleSource> FromFile(const std::string & filename,
+      uint64_t offset,
+      size_type size);
+
+  /// Creates a source that pulls datapoints from a function.
+  ///
+  /// The function is never called from two threads at the same time, so
+  /// it may keep the state of a decoder, for example.
+  /// @param size the number of datapoints.
+  /// @param read the function that reads datapoints.
+  /// @return the source.
+  /// @throws std::invalid_argument The function is empty.
+  static std::shared_ptr<const SFSampleSource> FromFunction(size_type size,
+      ReadFunction read);
+
+  /// Creates a source that holds a losslessly compressed copy of datapoints.
+  ///
+  /// The datapoints are compressed in blocks, and each block is decompressed
+  /// on its own when it is read, so the datapoints stay compressed at rest.
+  /// Reads do not share any state, and may run on multiple threads at once.
+  /// @param data a pointer to the first datapoint, in native byte order.
+  /// @param size the number of datapoints.
+  /// @return the source.
+  static std::shared_ptr<const SFSampleSource> Compress(const int16_t * data,
+      size_type size);
+
+protected:
+  /// Checks that a range is within the source.
+  /// @param offset the index of the first datapoint.
+  /// @param length the number of datapoints.
+  /// @throws std::out_of_range The range exceeds the length of the source.
+  void CheckRange(size_type offset, size_type length) const;
+};
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_SAMPLE_SOURCE_HPP_
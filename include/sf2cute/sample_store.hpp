@@ -0,0 +1,146 @@
+/// @file
+/// SoundFont 2 Sample store class header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_SAMPLE_STORE_HPP_
+#define SF2CUTE_SAMPLE_STORE_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "sample_data.hpp"
+
+namespace sf2cute {
+
+/// The SFSampleStore class keeps sample datapoints within a memory budget.
+///
+/// The datapoints added to the store are kept in memory until the resident
+/// datapoints exceed the budget. Past the budget, the oldest datapoints are
+/// spilled to a scratch file, and read back in blocks when the sample pool
+/// is written. The scratch file is appended in the order the datapoints are
+/// added, so a bank whose samples are added in order is read sequentially.
+///
+/// The store is kept alive by the sample data it hands out, and the scratch
+/// file is removed when the store is destroyed.
+///
+/// @remarks The datapoints may be read from multiple threads at the same time
+/// when a SoundFont is written with more than one thread.
+class SFSampleStore : public std::enable_shared_from_this<SFSampleStore> {
+public:
+  /// Unsigned integer type for the size of the datapoints.
+  using size_type = size_t;
+
+  /// Creates a store.
+  /// @param scratch_filename the name of the scratch file, replaced if it exists.
+  /// @param memory_budget the maximum size of the resident datapoints, in terms of bytes.
+  /// @return the store.
+  /// @throws std::ios_base::failure The scratch file cannot be created.
+  static std::shared_ptr<SFSampleStore> Create(const std::string & scratch_filename,
+      size_type memory_budget);
+
+  /// Closes and removes the scratch file.
+  ~SFSampleStore();
+
+  SFSampleStore(const SFSampleStore &) = delete;
+  SFSampleStore & operator=(const SFSampleStore &) = delete;
+
+  /// Adds datapoints to the store.
+  /// @param data the sample datapoints.
+  /// @return the sample data streamed from the store.
+  /// @throws std::ios_base::failure An I/O error occurred while spilling datapoints.
+  SFSampleData Add(std::vector<int16_t> data);
+
+  /// Returns the maximum size of the resident datapoints.
+  /// @return the memory budget, in terms of bytes.
+  size_type memory_budget() const noexcept {
+    return memory_budget_;
+  }
+
+  /// Returns the size of the datapoints kept in memory.
+  /// @return the size of the resident datapoints, in terms of bytes.
+  size_type resident_size() const;
+
+  /// Returns the size of the datapoints spilled to the scratch file.
+  /// @return the size of the scratch file, in terms of bytes.
+  uint64_t spilled_size() const;
+
+private:
+  /// The Source class streams the datapoints of an entry.
+  class Source;
+
+  /// The Entry struct represents the datapoints added at once.
+  struct Entry {
+    /// The resident datapoints, empty once spilled or released.
+    std::vector<int16_t> datapoints;
+
+    /// The offset of the spilled datapoints in the scratch file, in terms of bytes.
+    uint64_t offset;
+
+    /// True if the datapoints are in the scratch file.
+    bool spilled;
+  };
+
+  /// Constructs a new SFSampleStore.
+  /// @param scratch_filename the name of the scratch file.
+  /// @param memory_budget the maximum size of the resident datapoints, in terms of bytes.
+  /// @throws std::ios_base::failure The scratch file cannot be created.
+  SFSampleStore(std::string scratch_filename, size_type memory_budget);
+
+  /// Spills the oldest resident datapoints until the specified size fits in the budget.
+  /// @param size the size of the datapoints to be kept in memory, in terms of bytes.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  void SpillFor(size_type size);
+
+  /// Appends datapoints to the scratch file.
+  /// @param data a pointer to the datapoints.
+  /// @param size the number of datapoints.
+  /// @return the offset of the datapoints in the scratch file, in terms of bytes.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  uint64_t Spill(const int16_t * data, size_type size);
+
+  /// Reads the datapoints of an entry.
+  /// @param index the index of the entry.
+  /// @param offset the index of the first datapoint to read.
+  /// @param buffer the buffer that receives the datapoints.
+  /// @param length the number of datapoints to read.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  void Read(size_t index, size_type offset, int16_t * buffer, size_type length);
+
+  /// Releases the resident datapoints of an entry that is no longer used.
+  /// @param index the index of the entry.
+  void Release(size_t index) noexcept;
+
+  /// The name of the scratch file.
+  std::string scratch_filename_;
+
+  /// The scratch file.
+  std::fstream scratch_;
+
+  /// The mutex that guards the entries and the scratch file.
+  mutable std::mutex mutex_;
+
+  /// The maximum size of the resident datapoints, in terms of bytes.
+  size_type memory_budget_;
+
+  /// The size of the resident datapoints, in terms of bytes.
+  size_type resident_size_;
+
+  /// The size of the scratch file, in terms of bytes.
+  uint64_t spilled_size_;
+
+  /// The entries, in the order they are added.
+  std::vector<Entry> entries_;
+
+  /// The index of the oldest entry that may still be resident.
+  size_t oldest_resident_;
+};
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_SAMPLE_STORE_HPP_
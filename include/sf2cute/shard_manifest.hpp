@@ -0,0 +1,112 @@
+/// @file
+/// SoundFont 2 Shard manifest class header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_SHARD_MANIFEST_HPP_
+#define SF2CUTE_SHARD_MANIFEST_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace sf2cute {
+
+/// The SFShardManifest class represents where each preset of a sharded SoundFont is written.
+///
+/// @see SoundFont::WriteSharded
+class SFShardManifest {
+public:
+  /// The position returned for a preset that is not in any shard.
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  /// The Entry struct represents the location of a preset.
+  struct Entry {
+    /// The MIDI bank number.
+    uint16_t bank;
+
+    /// The MIDI preset number.
+    uint16_t preset_number;
+
+    /// The name of the preset.
+    std::string name;
+
+    /// The index of the shard that contains the preset.
+    size_t shard;
+  };
+
+  /// Constructs a new empty SFShardManifest.
+  SFShardManifest() = default;
+
+  /// Constructs a new copy of specified SFShardManifest.
+  /// @param origin a SFShardManifest object.
+  SFShardManifest(const SFShardManifest & origin) = default;
+
+  /// Copy-assigns a new value to the SFShardManifest, replacing its current contents.
+  /// @param origin a SFShardManifest object.
+  SFShardManifest & operator=(const SFShardManifest & origin) = default;
+
+  /// Acquires the contents of specified SFShardManifest.
+  /// @param origin a SFShardManifest object.
+  SFShardManifest(SFShardManifest && origin) = default;
+
+  /// Move-assigns a new value to the SFShardManifest, replacing its current contents.
+  /// @param origin a SFShardManifest object.
+  SFShardManifest & operator=(SFShardManifest && origin) = default;
+
+  /// Destructs the SFShardManifest.
+  ~SFShardManifest() = default;
+
+  /// Returns the names of the shard files.
+  /// @return the names of the shard files, in the order of the shards.
+  const std::vector<std::string> & filenames() const noexcept {
+    return filenames_;
+  }
+
+  /// Returns the locations of the presets.
+  /// @return the locations of the presets, in the order of the presets in the original SoundFont.
+  const std::vector<Entry> & entries() const noexcept {
+    return entries_;
+  }
+
+  /// Appends a shard file.
+  /// @param filename the name of the shard file.
+  void AddFile(std::string filename);
+
+  /// Appends the location of a preset.
+  /// @param entry the location of the preset.
+  /// @throws std::out_of_range The shard index is not the index of a file.
+  void AddEntry(Entry entry);
+
+  /// Finds the shard that contains the specified preset.
+  /// @param bank the MIDI bank number.
+  /// @param preset_number the MIDI preset number.
+  /// @return the index of the shard, or npos if no such preset is found.
+  size_t Find(uint16_t bank, uint16_t preset_number) const noexcept;
+
+  /// Writes the manifest as tab-separated text.
+  ///
+  /// Each line after the header line has the bank, the preset number,
+  /// the name of the shard file and the name of the preset.
+  /// @param out the output stream to write to.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  void Write(std::ostream & out) const;
+
+  /// Writes the manifest as tab-separated text to a file.
+  /// @param filename the name of the file to write to.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  void Write(const std::string & filename) const;
+
+private:
+  /// The names of the shard files.
+  std::vector<std::string> filenames_;
+
+  /// The locations of the presets.
+  std::vector<Entry> entries_;
+};
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_SHARD_MANIFEST_HPP_
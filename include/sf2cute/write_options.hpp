@@ -0,0 +1,61 @@
+/// @file
+/// SoundFont 2 File writing options header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_WRITE_OPTIONS_HPP_
+#define SF2CUTE_WRITE_OPTIONS_HPP_
+
+#include <memory>
+
+namespace sf2cute {
+
+class SFSampleEncoder;
+
+/// The SFWriteOptions class represents the options for writing a SoundFont.
+struct SFWriteOptions {
+  /// Constructs a new SFWriteOptions with the default options.
+  SFWriteOptions() noexcept :
+      num_threads(1),
+      positional_write(false),
+      deduplicate_samples(false),
+      sample_encoder(nullptr) {
+  }
+
+  /// The number of threads used to serialize the chunks.
+  ///
+  /// With 1, every chunk is serialized in sequence onto the output.
+  /// With more threads, the pdta subchunks are serialized into their own
+  /// buffers in parallel while the sample pool is being written, and then
+  /// spliced in order. 0 selects the number of hardware threads.
+  unsigned int num_threads;
+
+  /// Whether a file is written with positional writes.
+  ///
+  /// When writing to a file, the file is preallocated and every region
+  /// (the headers, each sample and each pdta subchunk) is written at its
+  /// precomputed offset, using num_threads threads at the same time.
+  /// Ignored when writing to a stream, or where positional writes are not supported.
+  bool positional_write;
+
+  /// Whether identical sample datapoints are stored only once.
+  ///
+  /// Samples with the same datapoints (such as one recording reused under
+  /// different names or loop points) share a single range of the sample pool,
+  /// and their sample headers point to it. The samples are found by hashing
+  /// the datapoints of the samples that have the same length.
+  /// @see SoundFont::GetDuplicateSampleSize
+  bool deduplicate_samples;
+
+  /// The codec of the samples, or nullptr to write 16-bit datapoints.
+  ///
+  /// With an encoder, the SoundFont is written as an SF3 file whose sample
+  /// pool holds one encoded stream per sample. The samples are encoded
+  /// before anything is written, using num_threads threads at the same time.
+  /// @see SFSampleEncoder::CreateVorbis
+  std::shared_ptr<const SFSampleEncoder> sample_encoder;
+};
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_WRITE_OPTIONS_HPP_
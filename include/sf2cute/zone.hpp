@@ -6,12 +6,15 @@
 #ifndef SF2CUTE_ZONE_HPP_
 #define SF2CUTE_ZONE_HPP_
 
+#include <stddef.h>
 #include <memory>
 #include <functional>
 #include <vector>
 
 #include "types.hpp"
+#include "arena.hpp"
 #include "generator_item.hpp"
+#include "generator_set.hpp"
 #include "modulator_key.hpp"
 #include "modulator_item.hpp"
 
@@ -53,46 +56,63 @@ public:
   /// Destructs the SFZone.
   virtual ~SFZone() = default;
 
-  /// Returns the list of generators.
-  /// @return the list of generators assigned to the zone.
-  const std::vector<std::unique_ptr<SFGeneratorItem>> & generators() const noexcept {
+  /// Allocates a zone, from the current arena if any.
+  /// @param size the size of the zone.
+  /// @return a pointer to the zone.
+  /// @see SFArena::Scope
+  static void * operator new(size_t size) {
+    return SFArena::AllocateNode(size);
+  }
+
+  /// Frees a zone.
+  /// @param pointer a pointer to the zone.
+  static void operator delete(void * pointer) noexcept {
+    SFArena::DeallocateNode(pointer);
+  }
+
+  /// Returns the set of generators.
+  /// @return the set of generators assigned to the zone.
+  const SFGeneratorSet & generators() const noexcept {
     return generators_;
   }
 
   /// Sets a generator to the zone.
   /// @param generator a generator to be assigned to the zone.
   /// @remarks An existing generator which has the same key will be overwritten.
+  /// @throws std::invalid_argument The generator type is not valid.
   void SetGenerator(SFGeneratorItem generator);
 
   /// Finds the generator which is the specified type.
   /// @return the position of the found generator or std::end(generators()) if no such generator is found.
-  const std::vector<std::unique_ptr<SFGeneratorItem>>::const_iterator
-      FindGenerator(SFGenerator op) const;
+  SFGeneratorSet::const_iterator FindGenerator(SFGenerator op) const noexcept {
+    return generators_.Find(op);
+  }
 
   /// Removes a generator from the zone.
   /// @param position the generator to remove.
-  void RemoveGenerator(
-      std::vector<std::unique_ptr<SFGeneratorItem>>::const_iterator position) {
-    generators_.erase(position);
+  void RemoveGenerator(SFGeneratorSet::const_iterator position) noexcept {
+    generators_.Remove(position->op());
   }
 
   /// Removes generators from the zone.
   /// @param first the first generator to remove.
   /// @param last the last generator to remove.
   void RemoveGenerator(
-      std::vector<std::unique_ptr<SFGeneratorItem>>::const_iterator first,
-      std::vector<std::unique_ptr<SFGeneratorItem>>::const_iterator last) {
-    generators_.erase(first, last);
+      SFGeneratorSet::const_iterator first,
+      SFGeneratorSet::const_iterator last) noexcept {
+    while (first != last) {
+      generators_.Remove((first++)->op());
+    }
   }
 
   /// Removes generators from the zone.
   /// @param predicate unary predicate which returns true if the generator should be removed.
   void RemoveGeneratorIf(
-      std::function<bool(const std::unique_ptr<SFGeneratorItem> &)> predicate);
+      std::function<bool(const SFGeneratorItem &)> predicate);
 
   /// Removes all of the generators.
   void ClearGenerators() noexcept {
-    generators_.clear();
+    generators_.Clear();
   }
 
   /// Returns the list of modulators.
@@ -138,8 +158,8 @@ public:
   }
 
 protected:
-  /// The list of generators.
-  std::vector<std::unique_ptr<SFGeneratorItem>> generators_;
+  /// The set of generators.
+  SFGeneratorSet generators_;
 
   /// The list of modulators.
   std::vector<std::unique_ptr<SFModulatorItem>> modulators_;
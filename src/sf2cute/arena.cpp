@@ -0,0 +1,115 @@
+/// @file
+/// SoundFont 2 Arena class implementation.
+///
+/// @author gocha <https://github.com/gocha>
+
+#include <sf2cute/arena.hpp>
+
+#include <stddef.h>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace sf2cute {
+
+namespace {
+
+/// The alignment of every allocation.
+constexpr size_t kAlignment = alignof(max_align_t);
+
+/// The NodeHeader struct precedes every node allocated by AllocateNode.
+struct NodeHeader {
+  /// The arena of the node, or nullptr if the node is allocated from the heap.
+  std::shared_ptr<SFArena> arena;
+};
+
+/// The size of a node header, keeping the node aligned.
+constexpr size_t kNodeHeaderSize = (sizeof(NodeHeader) + kAlignment - 1) & ~(kAlignment - 1);
+
+/// The current arena of the thread.
+thread_local const std::shared_ptr<SFArena> * current_arena = nullptr;
+
+} // namespace
+
+/// Makes an arena the current arena.
+SFArena::Scope::Scope(const std::shared_ptr<SFArena> & arena) noexcept :
+    previous_(current_arena) {
+  current_arena = &arena;
+}
+
+/// Restores the previous arena.
+SFArena::Scope::~Scope() {
+  current_arena = previous_;
+}
+
+/// Constructs a new SFArena.
+SFArena::SFArena(size_t block_size) :
+    block_size_(block_size),
+    next_(nullptr),
+    available_(0),
+    num_allocations_(0),
+    allocated_size_(0) {
+}
+
+/// Destructs the SFArena, releasing every block.
+SFArena::~SFArena() = default;
+
+/// Allocates memory from the arena.
+void * SFArena::Allocate(size_t size) {
+  size = (size + kAlignment - 1) & ~(kAlignment - 1);
+  if (size > available_) {
+    // Start a new block; an allocation larger than a block gets a block of its own.
+    const size_t new_block_size = size > block_size_ ? size : block_size_;
+    blocks_.push_back(std::unique_ptr<char[]>(new char[new_block_size]));
+    next_ = blocks_.back().get();
+    available_ = new_block_size;
+  }
+
+  void * memory = next_;
+  next_ += size;
+  available_ -= size;
+  num_allocations_++;
+  allocated_size_ += size;
+  return memory;
+}
+
+/// Returns the current arena of the thread.
+const std::shared_ptr<SFArena> & SFArena::current() noexcept {
+  static const std::shared_ptr<SFArena> kNoArena;
+  return current_arena != nullptr ? *current_arena : kNoArena;
+}
+
+/// Allocates a node from the current arena, or from the heap without a current arena.
+void * SFArena::AllocateNode(size_t size) {
+  char * memory;
+  if (current_arena != nullptr && *current_arena != nullptr) {
+    memory = static_cast<char *>((*current_arena)->Allocate(kNodeHeaderSize + size));
+    new (memory) NodeHeader{ *current_arena };
+  }
+  else {
+    memory = static_cast<char *>(::operator new(kNodeHeaderSize + size));
+    new (memory) NodeHeader{};
+  }
+  return memory + kNodeHeaderSize;
+}
+
+/// Frees a node allocated by AllocateNode.
+void SFArena::DeallocateNode(void * node) noexcept {
+  if (node == nullptr) {
+    return;
+  }
+
+  char * memory = static_cast<char *>(node) - kNodeHeaderSize;
+  NodeHeader * header = reinterpret_cast<NodeHeader *>(memory);
+
+  // Take the reference out of the header first, since releasing it may
+  // release the block that contains the header.
+  const std::shared_ptr<SFArena> arena = std::move(header->arena);
+  header->~NodeHeader();
+  if (arena == nullptr) {
+    ::operator delete(memory);
+  }
+}
+
+} // namespace sf2cute
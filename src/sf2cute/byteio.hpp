@@ -7,9 +7,17 @@
 #define SF2CUTE_BYTEIO_HPP_
 
 #include <stdint.h>
+#include <iterator>
 
 namespace sf2cute {
 
+/// Returns true if the host stores integers in little-endian order.
+/// @return true if the host is a little-endian machine.
+inline bool IsLittleEndianHost() noexcept {
+  const uint16_t probe = 1;
+  return *reinterpret_cast<const uint8_t *>(&probe) == 1;
+}
+
 /// Writes an 8-bit integer.
 /// @param out the output iterator.
 /// @param value the number to be written.
@@ -63,6 +71,59 @@ OutputIterator WriteInt32L(OutputIterator out, uint32_t value) {
   return out;
 }
 
+/// Reads an 8-bit integer.
+/// @param in the input iterator.
+/// @param value the number read from the input.
+/// @return the input iterator that points to the next element of the read data.
+/// @tparam InputIterator an Iterator that can read from the pointed-to element.
+template <typename InputIterator>
+InputIterator ReadInt8(InputIterator in, uint8_t & value) {
+  static_assert(sizeof(*in) == 1, "Element size of InputIterator must be 1.");
+
+  value = static_cast<uint8_t>(*in);
+  in = std::next(in, 1);
+
+  return in;
+}
+
+/// Reads a 16-bit integer in little-endian order.
+/// @param in the input iterator.
+/// @param value the number read from the input.
+/// @return the input iterator that points to the next element of the read data.
+/// @tparam InputIterator an Iterator that can read from the pointed-to element.
+template <typename InputIterator>
+InputIterator ReadInt16L(InputIterator in, uint16_t & value) {
+  static_assert(sizeof(*in) == 1, "Element size of InputIterator must be 1.");
+
+  value = static_cast<uint8_t>(*in);
+  in = std::next(in, 1);
+  value |= static_cast<uint16_t>(static_cast<uint8_t>(*in) << 8);
+  in = std::next(in, 1);
+
+  return in;
+}
+
+/// Reads a 32-bit integer in little-endian order.
+/// @param in the input iterator.
+/// @param value the number read from the input.
+/// @return the input iterator that points to the next element of the read data.
+/// @tparam InputIterator an Iterator that can read from the pointed-to element.
+template <typename InputIterator>
+InputIterator ReadInt32L(InputIterator in, uint32_t & value) {
+  static_assert(sizeof(*in) == 1, "Element size of InputIterator must be 1.");
+
+  value = static_cast<uint8_t>(*in);
+  in = std::next(in, 1);
+  value |= static_cast<uint32_t>(static_cast<uint8_t>(*in)) << 8;
+  in = std::next(in, 1);
+  value |= static_cast<uint32_t>(static_cast<uint8_t>(*in)) << 16;
+  in = std::next(in, 1);
+  value |= static_cast<uint32_t>(static_cast<uint8_t>(*in)) << 24;
+  in = std::next(in, 1);
+
+  return in;
+}
+
 /// Writes an 8-bit integer.
 /// @param out the output destination object.
 /// @param value the number to be written.
@@ -8,8 +8,11 @@
 #include <iterator>
 #include <algorithm>
 #include <stdexcept>
-#include <unordered_map>
 #include <fstream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
 
 #include <sf2cute/sample.hpp>
 #include <sf2cute/generator_item.hpp>
@@ -19,12 +22,57 @@
 #include <sf2cute/preset_zone.hpp>
 #include <sf2cute/preset.hpp>
 
+#include "file_layout.hpp"
+#include "file_optimizer.hpp"
+#include "file_reader.hpp"
+#include "file_sharder.hpp"
 #include "file_writer.hpp"
+#include "pointer_index.hpp"
 
 namespace sf2cute {
 
+namespace {
+
+/// Returns the key of a preset in the lookup table by numbers.
+/// @param bank the bank number.
+/// @param preset_number the preset number.
+/// @return the key of the numbers.
+uint32_t PresetNumberKey(uint16_t bank, uint16_t preset_number) noexcept {
+  return (uint32_t(bank) << 16) | preset_number;
+}
+
+/// Removes the entry of an element from a lookup table.
+/// @param index the lookup table.
+/// @param key the key of the element.
+/// @param element the element.
+template <typename Key, typename T>
+void EraseEntry(std::unordered_multimap<Key, const T *> & index,
+    const Key & key, const T * element) noexcept {
+  const auto range = index.equal_range(key);
+  for (auto entry = range.first; entry != range.second; ++entry) {
+    if (entry->second == element) {
+      index.erase(entry);
+      return;
+    }
+  }
+}
+
+} // namespace
+
 /// Constructs a new empty SoundFont.
 SoundFont::SoundFont() :
+    has_removed_elements_(false),
+    indexed_(false),
+    sound_engine_(kDefaultTargetSoundEngine),
+    bank_name_(kDefaultBankName),
+    has_rom_version_(false) {
+}
+
+/// Constructs a new empty SoundFont whose elements are allocated from an arena.
+SoundFont::SoundFont(std::shared_ptr<SFArena> arena) :
+    arena_(std::move(arena)),
+    has_removed_elements_(false),
+    indexed_(false),
     sound_engine_(kDefaultTargetSoundEngine),
     bank_name_(kDefaultBankName),
     has_rom_version_(false) {
@@ -32,9 +80,12 @@ SoundFont::SoundFont() :
 
 /// Constructs a new copy of specified SoundFont.
 SoundFont::SoundFont(const SoundFont & origin) :
+    arena_(origin.arena_ != nullptr ? std::make_shared<SFArena>(origin.arena_->block_size()) : nullptr),
     presets_(),
     instruments_(),
     samples_(),
+    has_removed_elements_(false),
+    indexed_(false),
     sound_engine_(origin.sound_engine_),
     bank_name_(origin.bank_name_),
     rom_name_(origin.rom_name_),
@@ -49,19 +100,19 @@ SoundFont::SoundFont(const SoundFont & origin) :
   // Copy presets.
   presets_.reserve(origin.presets().size());
   for (const auto & preset : origin.presets()) {
-    presets_.push_back(std::make_shared<SFPreset>(*preset));
+    presets_.push_back(SFArena::MakeShared<SFPreset>(arena_, *preset));
   }
 
   // Copy instruments.
   instruments_.reserve(origin.instruments().size());
   for (const auto & instrument : origin.instruments()) {
-    instruments_.push_back(std::make_shared<SFInstrument>(*instrument));
+    instruments_.push_back(SFArena::MakeShared<SFInstrument>(arena_, *instrument));
   }
 
-  // Copy samples.
+  // Copy samples. The sample data is shared, not duplicated.
   samples_.reserve(origin.samples().size());
   for (const auto & sample : origin.samples()) {
-    samples_.push_back(std::make_shared<SFSample>(*sample));
+    samples_.push_back(SFArena::MakeShared<SFSample>(arena_, *sample));
   }
 
   // Repair references.
@@ -72,24 +123,24 @@ SoundFont::SoundFont(const SoundFont & origin) :
 /// Copy-assigns a new value to the SoundFont, replacing its current contents.
 SoundFont & SoundFont::operator=(const SoundFont & origin) {
   // Copy presets.
-  presets_.clear();
+  ClearPresets();
   presets_.reserve(origin.presets().size());
   for (const auto & preset : origin.presets()) {
-    presets_.push_back(std::make_shared<SFPreset>(*preset));
+    presets_.push_back(SFArena::MakeShared<SFPreset>(arena_, *preset));
   }
 
   // Copy instruments.
-  instruments_.clear();
+  ClearInstruments();
   instruments_.reserve(origin.instruments().size());
   for (const auto & instrument : origin.instruments()) {
-    instruments_.push_back(std::make_shared<SFInstrument>(*instrument));
+    instruments_.push_back(SFArena::MakeShared<SFInstrument>(arena_, *instrument));
   }
 
-  // Copy samples.
-  samples_.clear();
+  // Copy samples. The sample data is shared, not duplicated.
+  ClearSamples();
   samples_.reserve(origin.samples().size());
   for (const auto & sample : origin.samples()) {
-    samples_.push_back(std::make_shared<SFSample>(*sample));
+    samples_.push_back(SFArena::MakeShared<SFSample>(arena_, *sample));
   }
 
   // Copy other fields.
@@ -114,9 +165,12 @@ SoundFont & SoundFont::operator=(const SoundFont & origin) {
 
 /// Acquires the contents of specified SoundFont.
 SoundFont::SoundFont(SoundFont && origin) noexcept :
+    arena_(std::move(origin.arena_)),
     presets_(std::move(origin.presets_)),
     instruments_(std::move(origin.instruments_)),
     samples_(std::move(origin.samples_)),
+    has_removed_elements_(false),
+    indexed_(false),
     sound_engine_(std::move(origin.sound_engine_)),
     bank_name_(std::move(origin.bank_name_)),
     rom_name_(std::move(origin.rom_name_)),
@@ -130,11 +184,19 @@ SoundFont::SoundFont(SoundFont && origin) noexcept :
     software_(std::move(origin.software_)) {
   // Repair references.
   SetBackwardReferences();
+  origin.has_removed_elements_.store(false, std::memory_order_release);
+  origin.InvalidateIndex();
 }
 
 /// Move-assigns a new value to the SoundFont, replacing its current contents.
 SoundFont & SoundFont::operator=(SoundFont && origin) noexcept {
+  // Release the current elements.
+  ClearPresets();
+  ClearInstruments();
+  ClearSamples();
+
   // Copy fields.
+  arena_ = std::move(origin.arena_);
   presets_ = std::move(origin.presets_);
   instruments_ = std::move(origin.instruments_);
   samples_ = std::move(origin.samples_);
@@ -152,6 +214,8 @@ SoundFont & SoundFont::operator=(SoundFont && origin) noexcept {
 
   // Repair references.
   SetBackwardReferences();
+  origin.has_removed_elements_.store(false, std::memory_order_release);
+  origin.InvalidateIndex();
 
   return *this;
 }
@@ -176,10 +240,11 @@ void SoundFont::AddPreset(std::shared_ptr<SFPreset> preset) {
   }
 
   // Set this file to the parent file of the preset.
-  preset->set_parent_file(*this);
+  preset->set_parent_file(*this, presets_.size());
 
   // Add the preset to the list.
   presets_.push_back(preset);
+  IndexElement(*presets_.back());
 
   // If the preset has orphan instruments, add them to the file.
   for (auto && preset_zone : preset->zones()) {
@@ -192,9 +257,15 @@ void SoundFont::AddPreset(std::shared_ptr<SFPreset> preset) {
 /// Removes a preset from the SoundFont.
 void SoundFont::RemovePreset(
     std::vector<std::shared_ptr<SFPreset>>::const_iterator position) {
-  const std::shared_ptr<SFPreset> & preset = *position;
+  // Leave a hole, which is closed up the next time the list is requested.
+  std::shared_ptr<SFPreset> & preset = presets_[position - presets_.cbegin()];
+  if (preset == nullptr) {
+    return;
+  }
+  UnindexElement(*preset);
   preset->reset_parent_file();
-  presets_.erase(position);
+  preset.reset();
+  has_removed_elements_.store(true, std::memory_order_release);
 }
 
 /// Removes presets from the SoundFont.
@@ -202,18 +273,32 @@ void SoundFont::RemovePreset(
     std::vector<std::shared_ptr<SFPreset>>::const_iterator first,
   std::vector<std::shared_ptr<SFPreset>>::const_iterator last) {
   for (auto position = first; position != last; ++position) {
-    const auto & preset = *position;
-    preset->reset_parent_file();
+    RemovePreset(position);
+  }
+}
+
+/// Removes a preset from the SoundFont.
+void SoundFont::RemovePreset(const std::shared_ptr<SFPreset> & preset) {
+  if (preset == nullptr || !Contains(*preset)) {
+    return;
   }
-  presets_.erase(first, last);
+  RemovePreset(presets_.begin() + preset->file_index_);
+}
+
+/// Removes presets from the SoundFont.
+void SoundFont::RemovePresets(const std::vector<std::shared_ptr<SFPreset>> & presets) {
+  CompactLists();
+  RemoveElements(presets_, presets);
 }
 
 /// Removes presets from the SoundFont.
 void SoundFont::RemovePresetIf(
     std::function<bool(const std::shared_ptr<SFPreset> &)> predicate) {
+  CompactLists();
   presets_.erase(std::remove_if(presets_.begin(), presets_.end(),
-    [&predicate](const std::shared_ptr<SFPreset> & preset) -> bool {
+    [this, &predicate](const std::shared_ptr<SFPreset> & preset) -> bool {
       if (predicate(preset)) {
+        UnindexElement(*preset);
         preset->reset_parent_file();
         return true;
       }
@@ -221,14 +306,39 @@ void SoundFont::RemovePresetIf(
         return false;
       }
     }), presets_.end());
+  ReindexPresets(presets_.begin());
 }
 
 /// Removes all of the presets.
 void SoundFont::ClearPresets() noexcept {
   for (const auto & preset : presets_) {
-    preset->reset_parent_file();
+    if (preset != nullptr) {
+      preset->reset_parent_file();
+    }
   }
   presets_.clear();
+  preset_number_index_.clear();
+  preset_name_index_.clear();
+}
+
+/// Returns true if the SoundFont owns a preset.
+bool SoundFont::Contains(const SFPreset & preset) const noexcept {
+  return preset.has_parent_file() && &preset.parent_file() == this &&
+      preset.file_index_ < presets_.size() && presets_[preset.file_index_].get() == &preset;
+}
+
+/// Finds a preset by its bank and preset number.
+std::shared_ptr<SFPreset> SoundFont::FindPreset(uint16_t bank, uint16_t preset_number) const {
+  std::lock_guard<std::mutex> lock(index_mutex_);
+  BuildIndex();
+  return FindElement(presets_, preset_number_index_, PresetNumberKey(bank, preset_number));
+}
+
+/// Finds a preset by its name.
+std::shared_ptr<SFPreset> SoundFont::FindPreset(const std::string & name) const {
+  std::lock_guard<std::mutex> lock(index_mutex_);
+  BuildIndex();
+  return FindElement(presets_, preset_name_index_, name);
 }
 
 /// Adds an instrument to the SoundFont.
@@ -251,10 +361,11 @@ void SoundFont::AddInstrument(std::shared_ptr<SFInstrument> instrument) {
   }
 
   // Set this file to the parent file of the instrument.
-  instrument->set_parent_file(*this);
+  instrument->set_parent_file(*this, instruments_.size());
 
   // Add the instrument to the list.
   instruments_.push_back(instrument);
+  IndexElement(*instruments_.back());
 
   // If the instrument has orphan samples, add them to the file.
   for (auto && instrument_zone : instrument->zones()) {
@@ -267,9 +378,15 @@ void SoundFont::AddInstrument(std::shared_ptr<SFInstrument> instrument) {
 /// Removes an instrument from the SoundFont.
 void SoundFont::RemoveInstrument(
     std::vector<std::shared_ptr<SFInstrument>>::const_iterator position) {
-  const std::shared_ptr<SFInstrument> & instrument = *position;
+  // Leave a hole, which is closed up the next time the list is requested.
+  std::shared_ptr<SFInstrument> & instrument = instruments_[position - instruments_.cbegin()];
+  if (instrument == nullptr) {
+    return;
+  }
+  UnindexElement(*instrument);
   instrument->reset_parent_file();
-  instruments_.erase(position);
+  instrument.reset();
+  has_removed_elements_.store(true, std::memory_order_release);
 }
 
 /// Removes an instrument from the SoundFont.
@@ -277,18 +394,32 @@ void SoundFont::RemoveInstrument(
     std::vector<std::shared_ptr<SFInstrument>>::const_iterator first,
     std::vector<std::shared_ptr<SFInstrument>>::const_iterator last) {
   for (auto position = first; position != last; ++position) {
-    const auto & instrument = *position;
-    instrument->reset_parent_file();
+    RemoveInstrument(position);
   }
-  instruments_.erase(first, last);
+}
+
+/// Removes an instrument from the SoundFont.
+void SoundFont::RemoveInstrument(const std::shared_ptr<SFInstrument> & instrument) {
+  if (instrument == nullptr || !Contains(*instrument)) {
+    return;
+  }
+  RemoveInstrument(instruments_.begin() + instrument->file_index_);
+}
+
+/// Removes instruments from the SoundFont.
+void SoundFont::RemoveInstruments(const std::vector<std::shared_ptr<SFInstrument>> & instruments) {
+  CompactLists();
+  RemoveElements(instruments_, instruments);
 }
 
 /// Removes an instrument from the SoundFont.
 void SoundFont::RemoveInstrumentIf(
     std::function<bool(const std::shared_ptr<SFInstrument> &)> predicate) {
+  CompactLists();
   instruments_.erase(std::remove_if(instruments_.begin(), instruments_.end(),
-    [&predicate](const std::shared_ptr<SFInstrument> & instrument) -> bool {
+    [this, &predicate](const std::shared_ptr<SFInstrument> & instrument) -> bool {
       if (predicate(instrument)) {
+        UnindexElement(*instrument);
         instrument->reset_parent_file();
         return true;
       }
@@ -296,14 +427,31 @@ void SoundFont::RemoveInstrumentIf(
         return false;
       }
     }), instruments_.end());
+  ReindexInstruments(instruments_.begin());
 }
 
 /// Removes all of the instruments.
 void SoundFont::ClearInstruments() noexcept {
   for (const auto & instrument : instruments_) {
-    instrument->reset_parent_file();
+    if (instrument != nullptr) {
+      instrument->reset_parent_file();
+    }
   }
   instruments_.clear();
+  instrument_name_index_.clear();
+}
+
+/// Returns true if the SoundFont owns an instrument.
+bool SoundFont::Contains(const SFInstrument & instrument) const noexcept {
+  return instrument.has_parent_file() && &instrument.parent_file() == this &&
+      instrument.file_index_ < instruments_.size() && instruments_[instrument.file_index_].get() == &instrument;
+}
+
+/// Finds an instrument by its name.
+std::shared_ptr<SFInstrument> SoundFont::FindInstrument(const std::string & name) const {
+  std::lock_guard<std::mutex> lock(index_mutex_);
+  BuildIndex();
+  return FindElement(instruments_, instrument_name_index_, name);
 }
 
 /// Adds a sample to the SoundFont.
@@ -326,18 +474,25 @@ void SoundFont::AddSample(std::shared_ptr<SFSample> sample) {
   }
 
   // Set this file to the parent file of the sample.
-  sample->set_parent_file(*this);
+  sample->set_parent_file(*this, samples_.size());
 
   // Add the sample to the list.
   samples_.push_back(sample);
+  IndexElement(*samples_.back());
 }
 
 /// Removes a sample from the SoundFont.
 void SoundFont::RemoveSample(
     std::vector<std::shared_ptr<SFSample>>::const_iterator position) {
-  const std::shared_ptr<SFSample> & sample = *position;
+  // Leave a hole, which is closed up the next time the list is requested.
+  std::shared_ptr<SFSample> & sample = samples_[position - samples_.cbegin()];
+  if (sample == nullptr) {
+    return;
+  }
+  UnindexElement(*sample);
   sample->reset_parent_file();
-  samples_.erase(position);
+  sample.reset();
+  has_removed_elements_.store(true, std::memory_order_release);
 }
 
 /// Removes a sample from the SoundFont.
@@ -345,18 +500,32 @@ void SoundFont::RemoveSample(
     std::vector<std::shared_ptr<SFSample>>::const_iterator first,
   std::vector<std::shared_ptr<SFSample>>::const_iterator last) {
   for (auto position = first; position != last; ++position) {
-    const auto & sample = *position;
-    sample->reset_parent_file();
+    RemoveSample(position);
   }
-  samples_.erase(first, last);
+}
+
+/// Removes a sample from the SoundFont.
+void SoundFont::RemoveSample(const std::shared_ptr<SFSample> & sample) {
+  if (sample == nullptr || !Contains(*sample)) {
+    return;
+  }
+  RemoveSample(samples_.begin() + sample->file_index_);
+}
+
+/// Removes samples from the SoundFont.
+void SoundFont::RemoveSamples(const std::vector<std::shared_ptr<SFSample>> & samples) {
+  CompactLists();
+  RemoveElements(samples_, samples);
 }
 
 /// Removes a sample from the SoundFont.
 void SoundFont::RemoveSampleIf(
     std::function<bool(const std::shared_ptr<SFSample> &)> predicate) {
+  CompactLists();
   samples_.erase(std::remove_if(samples_.begin(), samples_.end(),
-    [&predicate](const std::shared_ptr<SFSample> & sample) -> bool {
+    [this, &predicate](const std::shared_ptr<SFSample> & sample) -> bool {
       if (predicate(sample)) {
+        UnindexElement(*sample);
         sample->reset_parent_file();
         return true;
       }
@@ -364,14 +533,66 @@ void SoundFont::RemoveSampleIf(
         return false;
       }
     }), samples_.end());
+  ReindexSamples(samples_.begin());
 }
 
 /// Removes all of the samples.
 void SoundFont::ClearSamples() noexcept {
   for (const auto & sample : samples_) {
-    sample->reset_parent_file();
+    if (sample != nullptr) {
+      sample->reset_parent_file();
+    }
   }
   samples_.clear();
+  sample_name_index_.clear();
+}
+
+/// Returns true if the SoundFont owns a sample.
+bool SoundFont::Contains(const SFSample & sample) const noexcept {
+  return sample.has_parent_file() && &sample.parent_file() == this &&
+      sample.file_index_ < samples_.size() && samples_[sample.file_index_].get() == &sample;
+}
+
+/// Finds a sample by its name.
+std::shared_ptr<SFSample> SoundFont::FindSample(const std::string & name) const {
+  std::lock_guard<std::mutex> lock(index_mutex_);
+  BuildIndex();
+  return FindElement(samples_, sample_name_index_, name);
+}
+
+/// Reads a SoundFont from a file.
+SoundFont SoundFont::Read(const std::string & filename) {
+  SoundFontReader reader;
+  return reader.Read(filename);
+}
+
+/// Reads a SoundFont from an input stream.
+SoundFont SoundFont::Read(std::istream & in) {
+  SoundFontReader reader;
+  return reader.Read(in);
+}
+
+/// Reads a SoundFont from an input stream.
+SoundFont SoundFont::Read(std::istream && in) {
+  return Read(in);
+}
+
+/// Reads a SoundFont from a file, allocating its elements from an arena.
+SoundFont SoundFont::Read(const std::string & filename, std::shared_ptr<SFArena> arena) {
+  SoundFontReader reader(std::move(arena));
+  return reader.Read(filename);
+}
+
+/// Reads a SoundFont from an input stream, allocating its elements from an arena.
+SoundFont SoundFont::Read(std::istream & in, std::shared_ptr<SFArena> arena) {
+  SoundFontReader reader(std::move(arena));
+  return reader.Read(in);
+}
+
+/// Reads a SoundFont from a file, mapping it into memory.
+SoundFont SoundFont::ReadMapped(const std::string & filename) {
+  SoundFontReader reader;
+  return reader.ReadMapped(filename);
 }
 
 /// Writes the SoundFont to a file.
@@ -391,133 +612,414 @@ void SoundFont::Write(std::ostream && out) {
   Write(out);
 }
 
+/// Writes the SoundFont to a file using the specified options.
+void SoundFont::Write(const std::string & filename, const SFWriteOptions & options) {
+  SoundFontWriter writer(*this, options);
+  writer.Write(filename);
+}
+
+/// Writes the SoundFont to an output stream using the specified options.
+void SoundFont::Write(std::ostream & out, const SFWriteOptions & options) {
+  SoundFontWriter writer(*this, options);
+  writer.Write(out);
+}
+
+/// Writes the SoundFont to an output stream using the specified options.
+void SoundFont::Write(std::ostream && out, const SFWriteOptions & options) {
+  Write(out, options);
+}
+
+/// Returns the length of the file that Write would produce.
+size_t SoundFont::GetWriteSize() {
+  SoundFontWriter writer(*this);
+  return writer.GetWriteSize();
+}
+
+/// Writes the SoundFont to a preallocated buffer.
+size_t SoundFont::WriteTo(char * buffer, size_t size) {
+  SoundFontWriter writer(*this);
+  return writer.WriteTo(buffer, size);
+}
+
+/// Writes the SoundFont to a new vector.
+std::vector<char> SoundFont::WriteToVector() {
+  SoundFontWriter writer(*this);
+  return writer.WriteToVector();
+}
+
+/// Returns the size of the sample datapoints that deduplication saves.
+size_t SoundFont::GetDuplicateSampleSize() const {
+  SoundFontLayout layout(*this, true);
+  return static_cast<size_t>(layout.duplicate_sample_size());
+}
+
+/// Keeps the data of every sample compressed in memory until it is written.
+void SoundFont::CompressSamples() {
+  for (const auto & sample : samples()) {
+    sample->CompressData();
+  }
+}
+
+/// Removes the generators that do not change the sound.
+SFOptimizationReport SoundFont::RemoveRedundantGenerators() {
+  SoundFontOptimizer optimizer(*this);
+  return optimizer.RemoveRedundantGenerators();
+}
+
+/// Moves the generators and modulators shared by the zones into the global zones.
+SFOptimizationReport SoundFont::HoistToGlobalZones() {
+  SoundFontOptimizer optimizer(*this);
+  return optimizer.HoistToGlobalZones();
+}
+
+/// Splits the SoundFont into SoundFonts that each fit in a SoundFont file.
+std::vector<SoundFont> SoundFont::Split() const {
+  SoundFontSharder sharder(*this);
+  return sharder.Split();
+}
+
+/// Writes the SoundFont to as many files as needed to stay within the limits of a file.
+SFShardManifest SoundFont::WriteSharded(const std::string & filename) {
+  return WriteSharded(filename, SFWriteOptions());
+}
+
+/// Writes the SoundFont to as many files as needed using the specified options.
+SFShardManifest SoundFont::WriteSharded(const std::string & filename,
+    const SFWriteOptions & options) {
+  std::vector<SoundFont> shards = Split();
+
+  SFShardManifest manifest;
+  for (size_t shard_index = 0; shard_index < shards.size(); shard_index++) {
+    SoundFont & shard = shards[shard_index];
+    const std::string shard_filename = SoundFontSharder::ShardFilename(filename, shard_index);
+    shard.Write(shard_filename, options);
+
+    manifest.AddFile(shard_filename);
+    for (const auto & preset : shard.presets()) {
+      manifest.AddEntry(SFShardManifest::Entry{
+        preset->bank(), preset->preset_number(), preset->name(), shard_index });
+    }
+  }
+  return manifest;
+}
+
 /// Sets backward references of every children elements.
 void SoundFont::SetBackwardReferences() noexcept {
+  // The lookup tables may refer to elements of another SoundFont.
+  InvalidateIndex();
+
+  // Close up the holes left by removed elements.
+  CloseUp(presets_);
+  CloseUp(instruments_);
+  CloseUp(samples_);
+  has_removed_elements_.store(false, std::memory_order_release);
+
   // Set backward reference from presets to the file.
-  for (const auto & preset : presets_) {
-    preset->set_parent_file(*this);
+  for (size_t index = 0; index < presets_.size(); index++) {
+    presets_[index]->set_parent_file(*this, index);
   }
 
   // Set backward reference from instruments to the file.
-  for (const auto & instrument : instruments_) {
-    instrument->set_parent_file(*this);
+  for (size_t index = 0; index < instruments_.size(); index++) {
+    instruments_[index]->set_parent_file(*this, index);
   }
 
   // Set backward reference from samples to the file.
-  for (const auto & sample : samples_) {
-    sample->set_parent_file(*this);
+  for (size_t index = 0; index < samples_.size(); index++) {
+    samples_[index]->set_parent_file(*this, index);
   }
 }
 
-/// Repairs references in the copied children elements.
-void SoundFont::RepairReferences(const SoundFont & origin) {
-  // Construct a map from the original instrument to the copied instrument.
-  std::unordered_map<std::shared_ptr<SFInstrument>, std::shared_ptr<SFInstrument>> instrument_map;
-  std::transform(origin.instruments_.begin(), origin.instruments_.end(), instruments_.begin(),
-    std::inserter(instrument_map, instrument_map.end()),
-    std::make_pair<const std::shared_ptr<SFInstrument> &, const std::shared_ptr<SFInstrument> &>);
-
-  // Construct a map from the original sample to the copied sample.
-  std::unordered_map<std::shared_ptr<SFSample>, std::shared_ptr<SFSample>> sample_map;
-  std::transform(origin.samples_.begin(), origin.samples_.end(), samples_.begin(),
-    std::inserter(sample_map, sample_map.end()),
-    std::make_pair<const std::shared_ptr<SFSample> &, const std::shared_ptr<SFSample> &>);
+/// Updates the index of the presets from the specified position.
+void SoundFont::ReindexPresets(
+    std::vector<std::shared_ptr<SFPreset>>::const_iterator first) noexcept {
+  for (size_t index = first - presets_.begin(); index < presets_.size(); index++) {
+    presets_[index]->file_index_ = index;
+  }
+}
 
-  // Repair presets.
+/// Updates the index of the instruments from the specified position.
+void SoundFont::ReindexInstruments(
+    std::vector<std::shared_ptr<SFInstrument>>::const_iterator first) noexcept {
+  for (size_t index = first - instruments_.begin(); index < instruments_.size(); index++) {
+    instruments_[index]->file_index_ = index;
+  }
+}
+
+/// Updates the index of the samples from the specified position.
+void SoundFont::ReindexSamples(
+    std::vector<std::shared_ptr<SFSample>>::const_iterator first) noexcept {
+  for (size_t index = first - samples_.begin(); index < samples_.size(); index++) {
+    samples_[index]->file_index_ = index;
+  }
+}
+
+/// Closes up the holes left by removed elements in every list.
+void SoundFont::CompactListsNow() const noexcept {
+  // Lookups read the lists under the same mutex.
+  std::lock_guard<std::mutex> lock(index_mutex_);
+  if (!has_removed_elements_.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  CloseUp(presets_);
+  CloseUp(instruments_);
+  CloseUp(samples_);
+  has_removed_elements_.store(false, std::memory_order_release);
+}
+
+/// Builds the lookup tables, unless they are up to date.
+void SoundFont::BuildIndex() const {
+  // The caller holds index_mutex_, so the lists are not closed up here,
+  // and the holes left by removed elements are skipped instead.
+  if (indexed_) {
+    return;
+  }
+
+  preset_number_index_.reserve(presets_.size());
+  preset_name_index_.reserve(presets_.size());
   for (const auto & preset : presets_) {
-    RepairPresetReference(*preset, instrument_map);
+    if (preset == nullptr) {
+      continue;
+    }
+    preset_number_index_.emplace(PresetNumberKey(preset->bank(), preset->preset_number()), preset.get());
+    preset_name_index_.emplace(preset->name(), preset.get());
   }
 
-  // Repair instruments.
+  instrument_name_index_.reserve(instruments_.size());
   for (const auto & instrument : instruments_) {
-    RepairInstrumentReference(*instrument, sample_map);
+    if (instrument == nullptr) {
+      continue;
+    }
+    instrument_name_index_.emplace(instrument->name(), instrument.get());
   }
 
-  // Repair samples.
+  sample_name_index_.reserve(samples_.size());
   for (const auto & sample : samples_) {
-    RepairSampleReference(*sample, sample_map);
+    if (sample == nullptr) {
+      continue;
+    }
+    sample_name_index_.emplace(sample->name(), sample.get());
   }
+  indexed_ = true;
+}
+
+/// Drops the lookup tables, which are rebuilt by the next lookup.
+void SoundFont::InvalidateIndex() noexcept {
+  indexed_ = false;
+  preset_number_index_.clear();
+  preset_name_index_.clear();
+  instrument_name_index_.clear();
+  sample_name_index_.clear();
 }
 
-/// Corrects the instrument pointer in a copied preset.
-void SoundFont::RepairPresetReference(
-    SFPreset & preset,
-    const std::unordered_map<std::shared_ptr<SFInstrument>,
-    std::shared_ptr<SFInstrument>> & instrument_map) {
-  // Repair global zone.
-  if (preset.has_global_zone()) {
-    RepairPresetZoneReference(preset.global_zone(), instrument_map);
+/// Adds a preset to the lookup tables, if they are built.
+void SoundFont::IndexElement(const SFPreset & preset) noexcept {
+  if (!indexed_) {
+    return;
+  }
+
+  try {
+    preset_number_index_.emplace(PresetNumberKey(preset.bank(), preset.preset_number()), &preset);
+    preset_name_index_.emplace(preset.name(), &preset);
+  }
+  catch (const std::bad_alloc &) {
+    InvalidateIndex();
   }
+}
 
-  // Repair preset zones.
-  for (const auto & preset_zone : preset.zones()) {
-    RepairPresetZoneReference(*preset_zone, instrument_map);
+/// Removes a preset from the lookup tables, if they are built.
+void SoundFont::UnindexElement(const SFPreset & preset) noexcept {
+  if (!indexed_) {
+    return;
   }
+
+  EraseEntry(preset_number_index_, PresetNumberKey(preset.bank(), preset.preset_number()), &preset);
+  EraseEntry(preset_name_index_, preset.name(), &preset);
 }
 
-/// Corrects the instrument pointer in a copied preset zone.
-void SoundFont::RepairPresetZoneReference(
-    SFPresetZone & preset_zone,
-    const std::unordered_map<std::shared_ptr<SFInstrument>,
-    std::shared_ptr<SFInstrument>> & instrument_map) {
-  // Repair instrument reference.
-  if (preset_zone.has_instrument()) {
-    const auto & instrument = preset_zone.instrument();
-    if (instrument_map.count(instrument) != 0) {
-      preset_zone.set_instrument(instrument_map.at(instrument));
-    }
-    else {
-      preset_zone.reset_instrument();
+/// Adds an instrument to the lookup tables, if they are built.
+void SoundFont::IndexElement(const SFInstrument & instrument) noexcept {
+  if (!indexed_) {
+    return;
+  }
+
+  try {
+    instrument_name_index_.emplace(instrument.name(), &instrument);
+  }
+  catch (const std::bad_alloc &) {
+    InvalidateIndex();
+  }
+}
+
+/// Removes an instrument from the lookup tables, if they are built.
+void SoundFont::UnindexElement(const SFInstrument & instrument) noexcept {
+  if (!indexed_) {
+    return;
+  }
+
+  EraseEntry(instrument_name_index_, instrument.name(), &instrument);
+}
+
+/// Adds a sample to the lookup tables, if they are built.
+void SoundFont::IndexElement(const SFSample & sample) noexcept {
+  if (!indexed_) {
+    return;
+  }
+
+  try {
+    sample_name_index_.emplace(sample.name(), &sample);
+  }
+  catch (const std::bad_alloc &) {
+    InvalidateIndex();
+  }
+}
+
+/// Removes a sample from the lookup tables, if they are built.
+void SoundFont::UnindexElement(const SFSample & sample) noexcept {
+  if (!indexed_) {
+    return;
+  }
+
+  EraseEntry(sample_name_index_, sample.name(), &sample);
+}
+
+/// Returns the first element of a list among the entries of a lookup table.
+template <typename T, typename Key>
+std::shared_ptr<T> SoundFont::FindElement(const std::vector<std::shared_ptr<T>> & list,
+    const std::unordered_multimap<Key, const T *> & index,
+    const Key & key) {
+  // Duplicate keys are allowed; the earliest element wins, as in a linear search.
+  const auto range = index.equal_range(key);
+  const T * first = nullptr;
+  for (auto entry = range.first; entry != range.second; ++entry) {
+    if (first == nullptr || entry->second->file_index_ < first->file_index_) {
+      first = entry->second;
     }
   }
+  return first != nullptr ? list[first->file_index_] : nullptr;
 }
 
-/// Corrects the sample pointer in a copied instrument.
-void SoundFont::RepairInstrumentReference(
-    SFInstrument & instrument,
-    const std::unordered_map<std::shared_ptr<SFSample>,
-    std::shared_ptr<SFSample>> & sample_map) {
-  // Repair global zone.
-  if (instrument.has_global_zone()) {
-    RepairInstrumentZoneReference(instrument.global_zone(), sample_map);
+/// Removes elements from a list, keeping the order of the other elements.
+template <typename T>
+void SoundFont::RemoveElements(std::vector<std::shared_ptr<T>> & list,
+    const std::vector<std::shared_ptr<T>> & elements) {
+  // Mark the elements through their stored positions. The argument may be
+  // the list itself, so it is not read after the list starts changing.
+  std::vector<bool> removed(list.size(), false);
+  for (const auto & element : elements) {
+    if (element != nullptr && Contains(*element)) {
+      removed[element->file_index_] = true;
+    }
   }
 
-  // Repair instrument zones.
-  for (const auto & instrument_zone : instrument.zones()) {
-    RepairInstrumentZoneReference(*instrument_zone, sample_map);
+  // Compact the list in a single pass, renumbering the remaining elements.
+  size_t new_size = 0;
+  for (size_t index = 0; index < list.size(); index++) {
+    if (removed[index]) {
+      UnindexElement(*list[index]);
+      list[index]->reset_parent_file();
+      continue;
+    }
+
+    if (new_size != index) {
+      list[new_size] = std::move(list[index]);
+    }
+    list[new_size]->file_index_ = new_size;
+    new_size++;
   }
+  list.erase(list.begin() + new_size, list.end());
 }
 
-/// Corrects the sample pointer in a copied instrument zone.
-void SoundFont::RepairInstrumentZoneReference(
-    SFInstrumentZone & instrument_zone,
-    const std::unordered_map<std::shared_ptr<SFSample>,
-    std::shared_ptr<SFSample>> & sample_map) {
-  // Repair sample reference.
-  if (instrument_zone.has_sample()) {
-    const auto & sample = instrument_zone.sample();
-    if (sample_map.count(sample) != 0) {
-      instrument_zone.set_sample(sample_map.at(sample));
+/// Closes up the holes left by removed elements, keeping the order of the other elements.
+template <typename T>
+void SoundFont::CloseUp(std::vector<std::shared_ptr<T>> & list) noexcept {
+  size_t new_size = 0;
+  for (size_t index = 0; index < list.size(); index++) {
+    if (list[index] == nullptr) {
+      continue;
     }
-    else {
-      instrument_zone.reset_sample();
+
+    if (new_size != index) {
+      list[new_size] = std::move(list[index]);
     }
+    list[new_size]->file_index_ = new_size;
+    new_size++;
   }
+  list.erase(list.begin() + new_size, list.end());
 }
 
-/// Corrects the sample link in a copied sample.
-void SoundFont::RepairSampleReference(
-    SFSample & sample,
-    const std::unordered_map<std::shared_ptr<SFSample>,
-    std::shared_ptr<SFSample>> & sample_map) {
-  // Repair sample link.
-  if (sample.has_link()) {
-    const auto link = sample.link();
-    if (sample_map.count(link) != 0) {
-      sample.set_link(sample_map.at(link));
+/// Repairs references in the copied children elements.
+void SoundFont::RepairReferences(const SoundFont & origin) {
+  // The copies are built in the same order as the originals, so the
+  // position of an original element is also the position of its copy.
+  // The copied elements are already in this SoundFont, so the references
+  // are assigned directly rather than through the setters.
+  const PointerIndex<SFInstrument> instrument_index(origin.instruments());
+  const PointerIndex<SFSample> sample_index(origin.samples());
+
+  // The last positions found, tried first for the next lookup.
+  size_t instrument_hint = 0;
+  size_t sample_hint = 0;
+
+  // Corrects the instrument pointer in a copied preset zone.
+  const auto repair_preset_zone = [&](SFPresetZone & preset_zone) {
+    if (!preset_zone.instrument_.expired()) {
+      const auto position = instrument_index.Find(preset_zone.instrument_, instrument_hint);
+      if (position != PointerIndex<SFInstrument>::npos) {
+        preset_zone.instrument_ = instruments_[position];
+        instrument_hint = position;
+      }
+      else {
+        preset_zone.instrument_.reset();
+      }
     }
-    else {
-      sample.reset_link();
+  };
+
+  // Corrects the sample pointer in a copied instrument zone.
+  const auto repair_instrument_zone = [&](SFInstrumentZone & instrument_zone) {
+    if (!instrument_zone.sample_.expired()) {
+      const auto position = sample_index.Find(instrument_zone.sample_, sample_hint);
+      if (position != PointerIndex<SFSample>::npos) {
+        instrument_zone.sample_ = samples_[position];
+        sample_hint = position;
+      }
+      else {
+        instrument_zone.sample_.reset();
+      }
+    }
+  };
+
+  // Repair presets.
+  for (const auto & preset : presets_) {
+    if (preset->has_global_zone()) {
+      repair_preset_zone(preset->global_zone());
+    }
+    for (const auto & preset_zone : preset->zones()) {
+      repair_preset_zone(*preset_zone);
+    }
+  }
+
+  // Repair instruments.
+  for (const auto & instrument : instruments_) {
+    if (instrument->has_global_zone()) {
+      repair_instrument_zone(instrument->global_zone());
+    }
+    for (const auto & instrument_zone : instrument->zones()) {
+      repair_instrument_zone(*instrument_zone);
+    }
+  }
+
+  // Repair sample links.
+  for (const auto & sample : samples_) {
+    if (!sample->link_.expired()) {
+      const auto position = sample_index.Find(sample->link_, sample_hint);
+      if (position != PointerIndex<SFSample>::npos) {
+        sample->link_ = samples_[position];
+      }
+      else {
+        sample->link_.reset();
+      }
     }
   }
 }
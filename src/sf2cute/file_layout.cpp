@@ -0,0 +1,402 @@
+/// @file
+/// SoundFont 2 File layout class implementation.
+///
+/// @author gocha <https://github.com/gocha>
+
+#include "file_layout.hpp"
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <sstream>
+#include <stdexcept>
+
+#include <sf2cute/file.hpp>
+#include <sf2cute/sample.hpp>
+#include <sf2cute/sample_encoder.hpp>
+#include <sf2cute/write_options.hpp>
+#include <sf2cute/instrument_zone.hpp>
+#include <sf2cute/instrument.hpp>
+#include <sf2cute/preset_zone.hpp>
+#include <sf2cute/preset.hpp>
+
+#include "parallel.hpp"
+#include "riff.hpp"
+
+namespace sf2cute {
+
+namespace {
+
+/// The number of datapoints hashed or compared at once.
+constexpr size_t kSampleBlockLength = 32768;
+
+/// Multipliers of the sample hash.
+constexpr uint64_t kHashPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kHashPrime2 = 0xC2B2AE3D27D4EB4FULL;
+
+/// Rotates a 64-bit value to the left.
+inline uint64_t RotateLeft(uint64_t value, int count) noexcept {
+  return (value << count) | (value >> (64 - count));
+}
+
+/// Hashes a block of datapoints.
+///
+/// The block is consumed as 64-bit words in four independent lanes, which
+/// compilers turn into vector instructions; the lanes are folded at the end.
+uint64_t HashBlock(const int16_t * datapoints, size_t length) noexcept {
+  const char * bytes = reinterpret_cast<const char *>(datapoints);
+  const size_t size = sizeof(int16_t) * length;
+
+  uint64_t lanes[4] = { kHashPrime1, kHashPrime2, ~kHashPrime1, ~kHashPrime2 };
+  size_t offset = 0;
+  for (; offset + sizeof(lanes) <= size; offset += sizeof(lanes)) {
+    uint64_t words[4];
+    memcpy(words, bytes + offset, sizeof(words));
+    for (size_t lane = 0; lane < 4; lane++) {
+      lanes[lane] = RotateLeft(lanes[lane] + words[lane] * kHashPrime2, 31) * kHashPrime1;
+    }
+  }
+
+  uint64_t hash = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) +
+      RotateLeft(lanes[2], 12) + RotateLeft(lanes[3], 18);
+  for (; offset < size; offset++) {
+    hash = RotateLeft(hash ^ static_cast<uint8_t>(bytes[offset]), 11) * kHashPrime1;
+  }
+  return hash;
+}
+
+/// Hashes the datapoints of a sample.
+/// @throws std::ios_base::failure An I/O error occurred while reading a sample source.
+uint64_t HashSampleData(const SFSampleData & data) {
+  // In-memory and streamed datapoints are hashed in the same blocks,
+  // so that they hash alike when they are identical.
+  std::vector<int16_t> buffer;
+  uint64_t hash = data.size() * kHashPrime2;
+  for (size_t offset = 0; offset < data.size(); offset += kSampleBlockLength) {
+    const size_t remaining = data.size() - offset;
+    const size_t length = remaining < kSampleBlockLength ? remaining : kSampleBlockLength;
+    const int16_t * block;
+    if (data.is_streamed()) {
+      buffer.resize(length);
+      data.Read(offset, buffer.data(), length);
+      block = buffer.data();
+    }
+    else {
+      block = data.data() + offset;
+    }
+    hash = RotateLeft(hash ^ HashBlock(block, length), 27) * kHashPrime1;
+  }
+  return hash;
+}
+
+/// Returns true if two samples of the same length have identical datapoints.
+/// @throws std::ios_base::failure An I/O error occurred while reading a sample source.
+bool EqualSampleData(const SFSampleData & data, const SFSampleData & other) {
+  if (!data.is_streamed() && !other.is_streamed()) {
+    return data.data() == other.data() ||
+      std::equal(data.begin(), data.end(), other.begin());
+  }
+  if (data.is_streamed() && data.source() == other.source()) {
+    return true;
+  }
+
+  std::vector<int16_t> buffer(kSampleBlockLength);
+  std::vector<int16_t> other_buffer(kSampleBlockLength);
+  for (size_t offset = 0; offset < data.size(); offset += kSampleBlockLength) {
+    const size_t remaining = data.size() - offset;
+    const size_t length = remaining < kSampleBlockLength ? remaining : kSampleBlockLength;
+    data.Read(offset, buffer.data(), length);
+    other.Read(offset, other_buffer.data(), length);
+    if (!std::equal(buffer.begin(), buffer.begin() + length, other_buffer.begin())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+/// Constructs a new empty SoundFontLayout.
+SoundFontLayout::SoundFontLayout() :
+    num_preset_items_(0),
+    num_preset_zone_items_(0),
+    num_preset_modulator_items_(0),
+    num_preset_generator_items_(0),
+    num_instrument_items_(0),
+    num_instrument_zone_items_(0),
+    num_instrument_modulator_items_(0),
+    num_instrument_generator_items_(0),
+    num_sample_items_(0),
+    sample_pool_size_(0),
+    deduplicates_samples_(false),
+    encodes_samples_(false),
+    duplicate_sample_size_(0) {
+}
+
+/// Plans the layout of the specified SoundFont.
+SoundFontLayout::SoundFontLayout(const SoundFont & file) :
+    SoundFontLayout() {
+  PlanPresets(file.presets());
+  PlanInstruments(file.instruments());
+  PlanSamples(file.samples());
+}
+
+/// Plans the layout of the specified SoundFont, optionally deduplicating samples.
+SoundFontLayout::SoundFontLayout(const SoundFont & file, bool deduplicate_samples) :
+    SoundFontLayout() {
+  PlanPresets(file.presets());
+  PlanInstruments(file.instruments());
+  if (deduplicate_samples) {
+    PlanSharedSamples(file.samples());
+  }
+  else {
+    PlanSamples(file.samples());
+  }
+}
+
+/// Plans the layout of the specified SoundFont using the specified options.
+SoundFontLayout::SoundFontLayout(const SoundFont & file, const SFWriteOptions & options) :
+    SoundFontLayout(file, options.deduplicate_samples) {
+  if (options.sample_encoder != nullptr) {
+    EncodeSamples(file.samples(), *options.sample_encoder, ResolveNumThreads(options.num_threads));
+  }
+}
+
+/// Returns the location of the chunk with the specified name.
+const SoundFontLayout::ChunkLocation & SoundFontLayout::chunk_location(
+    const std::string & name) const {
+  for (const auto & location : chunk_locations_) {
+    if (location.name == name) {
+      return location;
+    }
+  }
+
+  std::ostringstream message_builder;
+  message_builder << "RIFF chunk \"" << name << "\" is not located.";
+  throw std::out_of_range(message_builder.str());
+}
+
+/// Computes the offset of every chunk in the specified RIFF.
+void SoundFontLayout::Locate(const RIFF & riff) {
+  chunk_locations_.clear();
+
+  // The chunks follow the RIFF header.
+  size_type offset = 12;
+  for (const auto & chunk : riff.chunks()) {
+    LocateChunk(*chunk, offset);
+    offset += chunk->size();
+  }
+}
+
+/// Counts the preset records.
+void SoundFontLayout::PlanPresets(const std::vector<std::shared_ptr<SFPreset>> & presets) {
+  size_type num_zones = 1; // 1 = terminator
+  size_type num_modulators = 1; // 1 = terminator
+  size_type num_generators = 1; // 1 = terminator
+  for (const auto & preset : presets) {
+    // Count the global zone.
+    if (preset->has_global_zone()) {
+      num_zones++;
+      num_modulators += preset->global_zone().modulators().size();
+      num_generators += preset->global_zone().generators().size();
+    }
+
+    // Count the preset zones.
+    for (const auto & zone : preset->zones()) {
+      num_modulators += zone->modulators().size();
+      num_generators += (zone->has_instrument() ? 1 : 0) + zone->generators().size();
+    }
+    num_zones += preset->zones().size();
+  }
+
+  // Check the range of the number of items.
+  num_preset_items_ = presets.size() + 1;
+  if (num_preset_items_ > UINT16_MAX) {
+    throw std::length_error("Too many presets.");
+  }
+  if (num_zones > UINT16_MAX) {
+    throw std::length_error("Too many preset zones.");
+  }
+  if (num_modulators > UINT16_MAX) {
+    throw std::length_error("Too many preset modulators.");
+  }
+  if (num_generators > UINT16_MAX) {
+    throw std::length_error("Too many preset generators.");
+  }
+
+  num_preset_zone_items_ = num_zones;
+  num_preset_modulator_items_ = num_modulators;
+  num_preset_generator_items_ = num_generators;
+}
+
+/// Counts the instrument records.
+void SoundFontLayout::PlanInstruments(const std::vector<std::shared_ptr<SFInstrument>> & instruments) {
+  size_type num_zones = 1; // 1 = terminator
+  size_type num_modulators = 1; // 1 = terminator
+  size_type num_generators = 1; // 1 = terminator
+  for (const auto & instrument : instruments) {
+    // Count the global zone.
+    if (instrument->has_global_zone()) {
+      num_zones++;
+      num_modulators += instrument->global_zone().modulators().size();
+      num_generators += instrument->global_zone().generators().size();
+    }
+
+    // Count the instrument zones.
+    for (const auto & zone : instrument->zones()) {
+      num_modulators += zone->modulators().size();
+      num_generators += (zone->has_sample() ? 1 : 0) + zone->generators().size();
+    }
+    num_zones += instrument->zones().size();
+  }
+
+  // Check the range of the number of items.
+  num_instrument_items_ = instruments.size() + 1;
+  if (num_instrument_items_ > UINT16_MAX) {
+    throw std::length_error("Too many instruments.");
+  }
+  if (num_zones > UINT16_MAX) {
+    throw std::length_error("Too many instrument zones.");
+  }
+  if (num_modulators > UINT16_MAX) {
+    throw std::length_error("Too many instrument modulators.");
+  }
+  if (num_generators > UINT16_MAX) {
+    throw std::length_error("Too many instrument generators.");
+  }
+
+  num_instrument_zone_items_ = num_zones;
+  num_instrument_modulator_items_ = num_modulators;
+  num_instrument_generator_items_ = num_generators;
+}
+
+/// Computes the sample pool size.
+void SoundFontLayout::PlanSamples(const std::vector<std::shared_ptr<SFSample>> & samples) {
+  num_sample_items_ = samples.size() + 1;
+  if (num_sample_items_ > UINT16_MAX) {
+    throw std::length_error("Too many samples.");
+  }
+
+  // Compute the sample pool size.
+  sample_pool_size_ = 0;
+  for (const auto & sample : samples) {
+    sample_pool_size_ += sizeof(int16_t) *
+        (sample->data().size() + SFSample::kTerminatorSampleLength);
+    if (sample_pool_size_ > UINT32_MAX) {
+      throw std::length_error("The sample pool size exceeds the maximum.");
+    }
+  }
+}
+
+/// Computes the sample pool, storing identical datapoints only once.
+void SoundFontLayout::PlanSharedSamples(const std::vector<std::shared_ptr<SFSample>> & samples) {
+  num_sample_items_ = samples.size() + 1;
+  if (num_sample_items_ > UINT16_MAX) {
+    throw std::length_error("Too many samples.");
+  }
+
+  // Only samples of the same length can be identical, so a sample with
+  // a unique length is never hashed.
+  std::unordered_map<size_t, size_t> length_counts;
+  for (const auto & sample : samples) {
+    length_counts[sample->data().size()]++;
+  }
+
+  // A duplicate points to the datapoints of the first identical sample.
+  // The loop points are relative to the sample, so they remain valid.
+  deduplicates_samples_ = true;
+  pooled_samples_.clear();
+  sample_starts_.clear();
+  sample_starts_.reserve(samples.size());
+  pooled_sample_indices_.clear();
+  pooled_sample_indices_.reserve(samples.size());
+  sample_pool_size_ = 0;
+  duplicate_sample_size_ = 0;
+  std::unordered_multimap<uint64_t, size_t> pooled_indices;
+  for (size_t sample_index = 0; sample_index < samples.size(); sample_index++) {
+    const SFSampleData & data = samples[sample_index]->data();
+    const size_type size = sizeof(int16_t) * (data.size() + SFSample::kTerminatorSampleLength);
+
+    if (length_counts[data.size()] > 1) {
+      const uint64_t hash = HashSampleData(data);
+      const auto candidates = pooled_indices.equal_range(hash);
+      const auto original = std::find_if(candidates.first, candidates.second,
+        [&](const std::pair<const uint64_t, size_t> & candidate) {
+          const SFSampleData & other = samples[candidate.second]->data();
+          return other.size() == data.size() && EqualSampleData(data, other);
+        });
+      if (original != candidates.second) {
+        sample_starts_.push_back(sample_starts_[original->second]);
+        pooled_sample_indices_.push_back(pooled_sample_indices_[original->second]);
+        duplicate_sample_size_ += size;
+        continue;
+      }
+      pooled_indices.emplace(hash, sample_index);
+    }
+
+    sample_starts_.push_back(sample_pool_size_ / sizeof(int16_t));
+    pooled_sample_indices_.push_back(pooled_samples_.size());
+    pooled_samples_.push_back(samples[sample_index]);
+    sample_pool_size_ += size;
+    if (sample_pool_size_ > UINT32_MAX) {
+      throw std::length_error("The sample pool size exceeds the maximum.");
+    }
+  }
+}
+
+/// Encodes the stored samples, and recomputes the sample pool in terms of bytes.
+void SoundFontLayout::EncodeSamples(const std::vector<std::shared_ptr<SFSample>> & samples,
+    const SFSampleEncoder & encoder,
+    unsigned int num_threads) {
+  // Each sample is encoded independently, so the samples are spread over the threads.
+  const auto & stored_samples = deduplicates_samples_ ? pooled_samples_ : samples;
+  encoded_samples_.clear();
+  encoded_samples_.resize(stored_samples.size());
+  ParallelFor(stored_samples.size(), num_threads, [&](size_t index) {
+    encoded_samples_[index] = encoder.Encode(*stored_samples[index]);
+  });
+
+  // The streams are stored one after another, without terminator samples.
+  std::vector<size_type> stream_offsets;
+  stream_offsets.reserve(encoded_samples_.size());
+  sample_pool_size_ = 0;
+  for (const auto & stream : encoded_samples_) {
+    stream_offsets.push_back(sample_pool_size_);
+    sample_pool_size_ += stream.size();
+    if (sample_pool_size_ > UINT32_MAX) {
+      throw std::length_error("The sample pool size exceeds the maximum.");
+    }
+  }
+
+  // A duplicate points to the stream of the first identical sample.
+  encodes_samples_ = true;
+  sample_starts_.resize(samples.size());
+  sample_ends_.resize(samples.size());
+  for (size_t sample_index = 0; sample_index < samples.size(); sample_index++) {
+    const size_t stream_index = deduplicates_samples_ ?
+        pooled_sample_indices_[sample_index] : sample_index;
+    sample_starts_[sample_index] = stream_offsets[stream_index];
+    sample_ends_[sample_index] = stream_offsets[stream_index] + encoded_samples_[stream_index].size();
+  }
+}
+
+/// Appends the location of a chunk and its subchunks.
+void SoundFontLayout::LocateChunk(const RIFFChunkInterface & chunk, size_type offset) {
+  chunk_locations_.push_back(ChunkLocation{ chunk.name(), offset, chunk.size() });
+
+  // The subchunks of a "LIST" chunk follow its header and list type.
+  const RIFFListChunk * list = dynamic_cast<const RIFFListChunk *>(&chunk);
+  if (list != nullptr) {
+    size_type subchunk_offset = offset + 12;
+    for (const auto & subchunk : list->subchunks()) {
+      LocateChunk(*subchunk, subchunk_offset);
+      subchunk_offset += subchunk->size();
+    }
+  }
+}
+
+} // namespace sf2cute
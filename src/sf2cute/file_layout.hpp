@@ -0,0 +1,315 @@
+/// @file
+/// SoundFont 2 File layout class header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_FILE_LAYOUT_HPP_
+#define SF2CUTE_FILE_LAYOUT_HPP_
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "riff.hpp"
+
+namespace sf2cute {
+
+class SFSample;
+class SFSampleEncoder;
+class SFInstrument;
+class SFPreset;
+class SoundFont;
+struct SFWriteOptions;
+
+/// The SoundFontLayout class represents the planned layout of a SoundFont file.
+///
+/// The layout is planned by a single traversal of the object graph.
+/// It holds the number of records of every pdta subchunk and the size of the
+/// sample pool, so that the chunk serializers do not need to walk the graph
+/// again to compute their sizes.
+///
+/// When samples are deduplicated, the layout also decides which samples
+/// are stored in the sample pool, and where every sample header points to.
+/// When samples are encoded, the layout holds the encoded streams, since
+/// the size of the sample pool is only known after encoding.
+class SoundFontLayout {
+public:
+  /// Unsigned integer type for the chunk size.
+  using size_type = RIFFChunkInterface::size_type;
+
+  /// The ChunkLocation struct represents the location of a chunk in the file.
+  struct ChunkLocation {
+    /// The name of the chunk (FourCC), or the list type for a "LIST" chunk.
+    std::string name;
+
+    /// The offset of the chunk header from the beginning of the file, in terms of bytes.
+    size_type offset;
+
+    /// The length of the chunk including a chunk header, in terms of bytes.
+    size_type size;
+  };
+
+  /// Constructs a new empty SoundFontLayout.
+  SoundFontLayout();
+
+  /// Plans the layout of the specified SoundFont.
+  /// @param file the SoundFont to be written.
+  /// @throws std::length_error The SoundFont has too many elements for a SoundFont file.
+  explicit SoundFontLayout(const SoundFont & file);
+
+  /// Plans the layout of the specified SoundFont, optionally deduplicating samples.
+  /// @param file the SoundFont to be written.
+  /// @param deduplicate_samples true to store identical sample datapoints only once.
+  /// @throws std::length_error The SoundFont has too many elements for a SoundFont file.
+  /// @throws std::ios_base::failure An I/O error occurred while reading a sample source.
+  SoundFontLayout(const SoundFont & file, bool deduplicate_samples);
+
+  /// Plans the layout of the specified SoundFont using the specified options.
+  /// @param file the SoundFont to be written.
+  /// @param options the options for writing.
+  /// @throws std::length_error The SoundFont has too many elements for a SoundFont file.
+  /// @throws std::runtime_error A sample could not be encoded.
+  /// @throws std::ios_base::failure An I/O error occurred while reading a sample source.
+  SoundFontLayout(const SoundFont & file, const SFWriteOptions & options);
+
+  /// Constructs a new copy of specified SoundFontLayout.
+  /// @param origin a SoundFontLayout object.
+  SoundFontLayout(const SoundFontLayout & origin) = default;
+
+  /// Copy-assigns a new value to the SoundFontLayout, replacing its current contents.
+  /// @param origin a SoundFontLayout object.
+  SoundFontLayout & operator=(const SoundFontLayout & origin) = default;
+
+  /// Acquires the contents of specified SoundFontLayout.
+  /// @param origin a SoundFontLayout object.
+  SoundFontLayout(SoundFontLayout && origin) = default;
+
+  /// Move-assigns a new value to the SoundFontLayout, replacing its current contents.
+  /// @param origin a SoundFontLayout object.
+  SoundFontLayout & operator=(SoundFontLayout && origin) = default;
+
+  /// Destructs the SoundFontLayout.
+  ~SoundFontLayout() = default;
+
+  /// Returns the number of "phdr" items, including the terminator.
+  /// @return the number of preset header items.
+  size_type num_preset_items() const noexcept {
+    return num_preset_items_;
+  }
+
+  /// Returns the number of "pbag" items, including the terminator.
+  /// @return the number of preset zone items.
+  size_type num_preset_zone_items() const noexcept {
+    return num_preset_zone_items_;
+  }
+
+  /// Returns the number of "pmod" items, including the terminator.
+  /// @return the number of preset modulator items.
+  size_type num_preset_modulator_items() const noexcept {
+    return num_preset_modulator_items_;
+  }
+
+  /// Returns the number of "pgen" items, including the terminator.
+  /// @return the number of preset generator items.
+  size_type num_preset_generator_items() const noexcept {
+    return num_preset_generator_items_;
+  }
+
+  /// Returns the number of "inst" items, including the terminator.
+  /// @return the number of instrument items.
+  size_type num_instrument_items() const noexcept {
+    return num_instrument_items_;
+  }
+
+  /// Returns the number of "ibag" items, including the terminator.
+  /// @return the number of instrument zone items.
+  size_type num_instrument_zone_items() const noexcept {
+    return num_instrument_zone_items_;
+  }
+
+  /// Returns the number of "imod" items, including the terminator.
+  /// @return the number of instrument modulator items.
+  size_type num_instrument_modulator_items() const noexcept {
+    return num_instrument_modulator_items_;
+  }
+
+  /// Returns the number of "igen" items, including the terminator.
+  /// @return the number of instrument generator items.
+  size_type num_instrument_generator_items() const noexcept {
+    return num_instrument_generator_items_;
+  }
+
+  /// Returns the number of "shdr" items, including the terminator.
+  /// @return the number of sample header items.
+  size_type num_sample_items() const noexcept {
+    return num_sample_items_;
+  }
+
+  /// Returns the total sample pool size.
+  /// @return the length of the "smpl" chunk data, in terms of bytes.
+  size_type sample_pool_size() const noexcept {
+    return sample_pool_size_;
+  }
+
+  /// Returns whether the samples are deduplicated.
+  /// @return true if pooled_samples and sample_starts are planned.
+  bool deduplicates_samples() const noexcept {
+    return deduplicates_samples_;
+  }
+
+  /// Returns the samples whose datapoints are stored in the sample pool.
+  /// @return the samples in the order of the sample pool, empty unless samples are deduplicated.
+  const std::vector<std::shared_ptr<SFSample>> & pooled_samples() const noexcept {
+    return pooled_samples_;
+  }
+
+  /// Returns the positions of the samples in the sample pool.
+  /// @return the index of the first datapoint of each sample, or the offset
+  /// of its encoded stream in terms of bytes, in the order of the sample list,
+  /// empty unless samples are deduplicated or encoded.
+  const std::vector<size_type> & sample_starts() const noexcept {
+    return sample_starts_;
+  }
+
+  /// Returns whether the samples are encoded.
+  /// @return true if encoded_samples and sample_ends are planned.
+  bool encodes_samples() const noexcept {
+    return encodes_samples_;
+  }
+
+  /// Returns the encoded streams stored in the sample pool.
+  /// @return the stream of each stored sample, in the order of the sample
+  /// pool, empty unless samples are encoded.
+  const std::vector<std::vector<char>> & encoded_samples() const noexcept {
+    return encoded_samples_;
+  }
+
+  /// Returns the ends of the encoded samples in the sample pool.
+  /// @return the offset past the encoded stream of each sample, in terms of
+  /// bytes, in the order of the sample list, empty unless samples are encoded.
+  const std::vector<size_type> & sample_ends() const noexcept {
+    return sample_ends_;
+  }
+
+  /// Returns the size of the datapoints that are not stored, because they duplicate another sample.
+  /// @return the number of bytes saved in the sample pool by deduplication.
+  size_type duplicate_sample_size() const noexcept {
+    return duplicate_sample_size_;
+  }
+
+  /// Returns the locations of every chunk, in the order of appearance in the file.
+  /// @return the chunk locations, empty until Locate is called.
+  const std::vector<ChunkLocation> & chunk_locations() const noexcept {
+    return chunk_locations_;
+  }
+
+  /// Returns the location of the chunk with the specified name.
+  /// @param name the name of the chunk, or the list type for a "LIST" chunk.
+  /// @return the location of the first chunk with the name.
+  /// @throws std::out_of_range The chunk could not be found.
+  const ChunkLocation & chunk_location(const std::string & name) const;
+
+  /// Computes the offset of every chunk in the specified RIFF.
+  /// @param riff the RIFF built from this layout.
+  void Locate(const RIFF & riff);
+
+private:
+  /// Counts the preset records.
+  /// @param presets the presets to be written.
+  /// @throws std::length_error Too many preset records.
+  void PlanPresets(const std::vector<std::shared_ptr<SFPreset>> & presets);
+
+  /// Counts the instrument records.
+  /// @param instruments the instruments to be written.
+  /// @throws std::length_error Too many instrument records.
+  void PlanInstruments(const std::vector<std::shared_ptr<SFInstrument>> & instruments);
+
+  /// Computes the sample pool size.
+  /// @param samples the samples to be written.
+  /// @throws std::length_error Too many samples, or the sample pool is too large.
+  void PlanSamples(const std::vector<std::shared_ptr<SFSample>> & samples);
+
+  /// Computes the sample pool, storing identical datapoints only once.
+  /// @param samples the samples to be written.
+  /// @throws std::length_error Too many samples, or the sample pool is too large.
+  /// @throws std::ios_base::failure An I/O error occurred while reading a sample source.
+  void PlanSharedSamples(const std::vector<std::shared_ptr<SFSample>> & samples);
+
+  /// Encodes the stored samples, and recomputes the sample pool in terms of bytes.
+  /// @param samples the samples to be written.
+  /// @param encoder the codec of the samples.
+  /// @param num_threads the number of threads.
+  /// @throws std::length_error The sample pool is too large.
+  /// @throws std::runtime_error A sample could not be encoded.
+  /// @throws std::ios_base::failure An I/O error occurred while reading a sample source.
+  void EncodeSamples(const std::vector<std::shared_ptr<SFSample>> & samples,
+      const SFSampleEncoder & encoder,
+      unsigned int num_threads);
+
+  /// Appends the location of a chunk and its subchunks.
+  /// @param chunk the chunk.
+  /// @param offset the offset of the chunk header from the beginning of the file.
+  void LocateChunk(const RIFFChunkInterface & chunk, size_type offset);
+
+  /// The number of "phdr" items.
+  size_type num_preset_items_;
+
+  /// The number of "pbag" items.
+  size_type num_preset_zone_items_;
+
+  /// The number of "pmod" items.
+  size_type num_preset_modulator_items_;
+
+  /// The number of "pgen" items.
+  size_type num_preset_generator_items_;
+
+  /// The number of "inst" items.
+  size_type num_instrument_items_;
+
+  /// The number of "ibag" items.
+  size_type num_instrument_zone_items_;
+
+  /// The number of "imod" items.
+  size_type num_instrument_modulator_items_;
+
+  /// The number of "igen" items.
+  size_type num_instrument_generator_items_;
+
+  /// The number of "shdr" items.
+  size_type num_sample_items_;
+
+  /// The total sample pool size, in terms of bytes.
+  size_type sample_pool_size_;
+
+  /// Whether the samples are deduplicated.
+  bool deduplicates_samples_;
+
+  /// The samples whose datapoints are stored in the sample pool.
+  std::vector<std::shared_ptr<SFSample>> pooled_samples_;
+
+  /// The index of the first datapoint of each sample.
+  std::vector<size_type> sample_starts_;
+
+  /// The position of each sample in pooled_samples_.
+  std::vector<size_t> pooled_sample_indices_;
+
+  /// Whether the samples are encoded.
+  bool encodes_samples_;
+
+  /// The encoded streams stored in the sample pool.
+  std::vector<std::vector<char>> encoded_samples_;
+
+  /// The offset past the encoded stream of each sample.
+  std::vector<size_type> sample_ends_;
+
+  /// The size of the datapoints that are not stored, in terms of bytes.
+  size_type duplicate_sample_size_;
+
+  /// The locations of every chunk.
+  std::vector<ChunkLocation> chunk_locations_;
+};
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_FILE_LAYOUT_HPP_
@@ -0,0 +1,411 @@
+/// @file
+/// SoundFont 2 File optimizer class implementation.
+///
+/// @author gocha <https://github.com/gocha>
+
+#include "file_optimizer.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sf2cute/file.hpp>
+#include <sf2cute/generator_item.hpp>
+#include <sf2cute/modulator_item.hpp>
+#include <sf2cute/instrument_zone.hpp>
+#include <sf2cute/instrument.hpp>
+#include <sf2cute/preset_zone.hpp>
+#include <sf2cute/preset.hpp>
+
+namespace sf2cute {
+
+namespace {
+
+/// Returns true if two amounts are the same.
+/// @param x the first amount.
+/// @param y the second amount.
+/// @return true if the amounts have the same bits.
+bool SameAmount(GenAmountType x, GenAmountType y) noexcept {
+  return x.uvalue == y.uvalue;
+}
+
+/// Returns true if two modulators with the same key have the same effect.
+/// @param x the first modulator.
+/// @param y the second modulator.
+/// @return true if the amounts and the transforms are the same.
+bool SameModulator(const SFModulatorItem & x, const SFModulatorItem & y) noexcept {
+  return x.amount() == y.amount() && x.transform_op() == y.transform_op();
+}
+
+} // namespace
+
+/// Constructs a new SoundFontOptimizer using specified file.
+SoundFontOptimizer::SoundFontOptimizer(SoundFont & file) noexcept :
+    file_(&file) {
+}
+
+/// Removes the generators that do not change the sound.
+SFOptimizationReport SoundFontOptimizer::RemoveRedundantGenerators() {
+  SFOptimizationReport report;
+  for (size_t preset_index = 0; preset_index < file().presets().size(); preset_index++) {
+    RemoveRedundantGenerators(*file().presets()[preset_index],
+      SFOptimizationReport::Element::kPreset, preset_index, report);
+  }
+  for (size_t instrument_index = 0; instrument_index < file().instruments().size(); instrument_index++) {
+    RemoveRedundantGenerators(*file().instruments()[instrument_index],
+      SFOptimizationReport::Element::kInstrument, instrument_index, report);
+  }
+  return report;
+}
+
+/// Moves the generators and modulators shared by the local zones into the global zone.
+SFOptimizationReport SoundFontOptimizer::HoistToGlobalZones() {
+  SFOptimizationReport report;
+  for (size_t preset_index = 0; preset_index < file().presets().size(); preset_index++) {
+    HoistToGlobalZone(*file().presets()[preset_index],
+      SFOptimizationReport::Element::kPreset, preset_index, report);
+  }
+  for (size_t instrument_index = 0; instrument_index < file().instruments().size(); instrument_index++) {
+    HoistToGlobalZone(*file().instruments()[instrument_index],
+      SFOptimizationReport::Element::kInstrument, instrument_index, report);
+  }
+  return report;
+}
+
+/// Removes the generators that do not change the sound from a preset or an instrument.
+template <typename T>
+void SoundFontOptimizer::RemoveRedundantGenerators(T & element,
+    SFOptimizationReport::Element kind,
+    size_t element_index,
+    SFOptimizationReport & report) {
+  std::vector<SFGeneratorItem> removed;
+
+  // Compare the local zones with the global zone before the global zone changes.
+  for (size_t zone_index = 0; zone_index < element.zones().size(); zone_index++) {
+    auto & zone = *element.zones()[zone_index];
+
+    removed.clear();
+    for (const auto & generator : zone.generators()) {
+      if (!IsRemovable(generator.op())) {
+        continue;
+      }
+
+      // A local key or velocity range is kept even when it equals the range
+      // of the global zone, since not every synthesizer applies it from a global zone.
+      if (element.has_global_zone() && element.global_zone().generators().Contains(generator.op())) {
+        if (generator.op() != SFGenerator::kKeyRange && generator.op() != SFGenerator::kVelRange &&
+            SameAmount(generator.amount(), element.global_zone().generators().amount(generator.op()))) {
+          removed.push_back(generator);
+          report.AddEntry(SFOptimizationReport::Entry{ kind, element_index, element.name(), zone_index,
+            generator.op(), generator.amount(), SFOptimizationReport::Reason::kGlobalZone, 1 });
+        }
+      }
+      else if (SameAmount(generator.amount(), DefaultAmount(kind, generator.op()))) {
+        removed.push_back(generator);
+        report.AddEntry(SFOptimizationReport::Entry{ kind, element_index, element.name(), zone_index,
+          generator.op(), generator.amount(), SFOptimizationReport::Reason::kDefault, 1 });
+      }
+    }
+    for (const auto & generator : removed) {
+      zone.RemoveGenerator(zone.FindGenerator(generator.op()));
+    }
+  }
+
+  if (!element.has_global_zone()) {
+    return;
+  }
+
+  // The local zones that lack a generator equal to the default stay the same
+  // when the global zone falls back to the default.
+  auto & global_zone = element.global_zone();
+  removed.clear();
+  for (const auto & generator : global_zone.generators()) {
+    if (IsRemovable(generator.op()) &&
+        SameAmount(generator.amount(), DefaultAmount(kind, generator.op()))) {
+      removed.push_back(generator);
+      report.AddEntry(SFOptimizationReport::Entry{ kind, element_index, element.name(),
+        SFOptimizationReport::kGlobalZone, generator.op(), generator.amount(),
+        SFOptimizationReport::Reason::kDefault, 1 });
+    }
+  }
+  for (const auto & generator : removed) {
+    global_zone.RemoveGenerator(global_zone.FindGenerator(generator.op()));
+  }
+
+  if (global_zone.generators().empty() && global_zone.modulators().empty()) {
+    element.reset_global_zone();
+    report.AddEntry(SFOptimizationReport::Entry{ kind, element_index, element.name(),
+      SFOptimizationReport::kGlobalZone, SFGenerator::kEndOper, GenAmountType(),
+      SFOptimizationReport::Reason::kEmptyGlobalZone, 1 });
+  }
+}
+
+/// Moves the generators and modulators shared by the local zones of a preset or an instrument.
+template <typename T>
+void SoundFontOptimizer::HoistToGlobalZone(T & element,
+    SFOptimizationReport::Element kind,
+    size_t element_index,
+    SFOptimizationReport & report) {
+  using Zone = typename std::decay<decltype(element.global_zone())>::type;
+  if (element.zones().size() < 2) {
+    return;
+  }
+
+  // Plan the generators. The key and velocity ranges stay in the local zones,
+  // since not every synthesizer applies them from a global zone.
+  std::vector<GeneratorPlan> generator_plans;
+  size_t num_records = 0;
+  bool needs_global_zone = false;
+  for (size_t index = 0; index < SFGeneratorSet::kCapacity; index++) {
+    const SFGenerator op = SFGenerator(index);
+    if (!IsRemovable(op) || op == SFGenerator::kKeyRange || op == SFGenerator::kVelRange) {
+      continue;
+    }
+
+    GeneratorPlan plan;
+    if (PlanGenerator(element, kind, op, plan)) {
+      generator_plans.push_back(plan);
+      num_records += plan.num_records;
+      if (!SameAmount(plan.amount, DefaultAmount(kind, op))) {
+        needs_global_zone = true;
+      }
+    }
+  }
+
+  // Plan the modulators. A local zone cannot opt out of a global modulator,
+  // so a modulator is hoisted only when every local zone ends up with it.
+  std::vector<SFModulatorKey> keys;
+  for (const auto & zone : element.zones()) {
+    for (const auto & modulator : zone->modulators()) {
+      if (std::find(keys.begin(), keys.end(), modulator->key()) == keys.end()) {
+        keys.push_back(modulator->key());
+      }
+    }
+  }
+  std::vector<std::pair<SFModulatorItem, size_t>> modulator_plans;
+  for (const auto & key : keys) {
+    const SFModulatorItem * common = nullptr;
+    size_t modulator_records = 0;
+    if (element.has_global_zone() &&
+        element.global_zone().FindModulator(key) != element.global_zone().modulators().end()) {
+      modulator_records++;
+    }
+
+    bool shared = true;
+    for (const auto & zone : element.zones()) {
+      const SFModulatorItem * effective = nullptr;
+      const auto modulator = zone->FindModulator(key);
+      if (modulator != zone->modulators().end()) {
+        effective = modulator->get();
+        modulator_records++;
+      }
+      else if (element.has_global_zone()) {
+        const auto global_modulator = element.global_zone().FindModulator(key);
+        if (global_modulator != element.global_zone().modulators().end()) {
+          effective = global_modulator->get();
+        }
+      }
+
+      if (effective == nullptr || (common != nullptr && !SameModulator(*common, *effective))) {
+        shared = false;
+        break;
+      }
+      common = effective;
+    }
+
+    if (shared && modulator_records > 1) {
+      modulator_plans.emplace_back(*common, modulator_records - 1);
+      num_records += modulator_records - 1;
+      needs_global_zone = true;
+    }
+  }
+
+  // A new global zone costs a zone record.
+  const bool creates_global_zone = needs_global_zone && !element.has_global_zone();
+  if (num_records == 0 || (creates_global_zone && num_records <= 1)) {
+    return;
+  }
+  if (creates_global_zone) {
+    element.set_global_zone(Zone());
+  }
+  size_t zone_cost = creates_global_zone ? 1 : 0;
+
+  for (const auto & plan : generator_plans) {
+    // The zones that end up with another value keep it as their own generator.
+    const GenAmountType default_amount = DefaultAmount(kind, plan.op);
+    const bool in_global_zone = element.has_global_zone() &&
+        element.global_zone().generators().Contains(plan.op);
+    const GenAmountType inherited = in_global_zone ?
+        element.global_zone().generators().amount(plan.op) : default_amount;
+    for (const auto & zone : element.zones()) {
+      const bool in_zone = zone->generators().Contains(plan.op);
+      const GenAmountType effective = in_zone ? zone->generators().amount(plan.op) : inherited;
+      if (SameAmount(effective, plan.amount)) {
+        if (in_zone) {
+          zone->RemoveGenerator(zone->FindGenerator(plan.op));
+        }
+      }
+      else if (!in_zone) {
+        zone->SetGenerator(SFGeneratorItem(plan.op, effective));
+      }
+    }
+
+    if (!SameAmount(plan.amount, default_amount)) {
+      element.global_zone().SetGenerator(SFGeneratorItem(plan.op, plan.amount));
+    }
+    else if (in_global_zone) {
+      element.global_zone().RemoveGenerator(element.global_zone().FindGenerator(plan.op));
+    }
+
+    report.AddEntry(SFOptimizationReport::Entry{ kind, element_index, element.name(),
+      SFOptimizationReport::kGlobalZone, plan.op, plan.amount,
+      SFOptimizationReport::Reason::kHoistedGenerator, plan.num_records - zone_cost });
+    zone_cost = 0;
+  }
+
+  for (const auto & plan : modulator_plans) {
+    const SFModulatorItem & modulator = plan.first;
+    for (const auto & zone : element.zones()) {
+      const auto position = zone->FindModulator(modulator.key());
+      if (position != zone->modulators().end()) {
+        zone->RemoveModulator(position);
+      }
+    }
+    element.global_zone().SetModulator(modulator);
+
+    report.AddEntry(SFOptimizationReport::Entry{ kind, element_index, element.name(),
+      SFOptimizationReport::kGlobalZone, modulator.destination_op(), GenAmountType(modulator.amount()),
+      SFOptimizationReport::Reason::kHoistedModulator, plan.second - zone_cost });
+    zone_cost = 0;
+  }
+}
+
+/// Plans the hoisting of a generator.
+template <typename T>
+bool SoundFontOptimizer::PlanGenerator(const T & element,
+    SFOptimizationReport::Element kind,
+    SFGenerator op,
+    GeneratorPlan & plan) {
+  // Find the value that each local zone ends up with.
+  const GenAmountType default_amount = DefaultAmount(kind, op);
+  const bool in_global_zone = element.has_global_zone() &&
+      element.global_zone().generators().Contains(op);
+  const GenAmountType inherited = in_global_zone ?
+      element.global_zone().generators().amount(op) : default_amount;
+  size_t num_records = in_global_zone ? 1 : 0;
+  std::vector<std::pair<uint16_t, size_t>> counts;
+  for (const auto & zone : element.zones()) {
+    GenAmountType effective = inherited;
+    if (zone->generators().Contains(op)) {
+      effective = zone->generators().amount(op);
+      num_records++;
+    }
+
+    auto count = std::find_if(counts.begin(), counts.end(),
+      [&](const std::pair<uint16_t, size_t> & entry) { return entry.first == effective.uvalue; });
+    if (count != counts.end()) {
+      count->second++;
+    }
+    else {
+      counts.emplace_back(effective.uvalue, 1);
+    }
+  }
+  if (num_records < 2) {
+    return false;
+  }
+
+  // The zones with another value need a record each, and the global zone
+  // needs one unless the value is the default.
+  const size_t num_zones = element.zones().size();
+  size_t best_cost = num_zones;
+  GenAmountType best_amount = default_amount;
+  for (const auto & count : counts) {
+    GenAmountType amount;
+    amount.uvalue = count.first;
+    const size_t cost = num_zones - count.second + (SameAmount(amount, default_amount) ? 0 : 1);
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_amount = amount;
+    }
+  }
+  if (best_cost >= num_records) {
+    return false;
+  }
+
+  plan = GeneratorPlan{ op, best_amount, num_records - best_cost };
+  return true;
+}
+
+/// Returns true if the specified generator may be removed.
+bool SoundFontOptimizer::IsRemovable(SFGenerator op) noexcept {
+  switch (op) {
+  case SFGenerator::kInstrument:
+  case SFGenerator::kSampleID:
+  case SFGenerator::kUnused1:
+  case SFGenerator::kUnused2:
+  case SFGenerator::kUnused3:
+  case SFGenerator::kUnused4:
+  case SFGenerator::kUnused5:
+  case SFGenerator::kReserved1:
+  case SFGenerator::kReserved2:
+  case SFGenerator::kReserved3:
+    return false;
+
+  default:
+    return SFGeneratorSet::IsValid(op);
+  }
+}
+
+/// Returns the value that a missing generator takes.
+GenAmountType SoundFontOptimizer::DefaultAmount(SFOptimizationReport::Element kind,
+    SFGenerator op) noexcept {
+  switch (op) {
+  case SFGenerator::kKeyRange:
+  case SFGenerator::kVelRange:
+    return GenAmountType(RangesType(0, 127));
+
+  default:
+    break;
+  }
+
+  // A preset generator is an offset to the instrument value.
+  if (kind == SFOptimizationReport::Element::kPreset) {
+    return GenAmountType(int16_t(0));
+  }
+
+  // @see "8.1.3 Generator Summary". In SoundFont Technical Specification 2.04.
+  switch (op) {
+  case SFGenerator::kInitialFilterFc:
+    return GenAmountType(int16_t(13500));
+
+  case SFGenerator::kDelayModLFO:
+  case SFGenerator::kDelayVibLFO:
+  case SFGenerator::kDelayModEnv:
+  case SFGenerator::kAttackModEnv:
+  case SFGenerator::kHoldModEnv:
+  case SFGenerator::kDecayModEnv:
+  case SFGenerator::kReleaseModEnv:
+  case SFGenerator::kDelayVolEnv:
+  case SFGenerator::kAttackVolEnv:
+  case SFGenerator::kHoldVolEnv:
+  case SFGenerator::kDecayVolEnv:
+  case SFGenerator::kReleaseVolEnv:
+    return GenAmountType(int16_t(-12000));
+
+  case SFGenerator::kKeynum:
+  case SFGenerator::kVelocity:
+  case SFGenerator::kOverridingRootKey:
+    return GenAmountType(int16_t(-1));
+
+  case SFGenerator::kScaleTuning:
+    return GenAmountType(int16_t(100));
+
+  default:
+    return GenAmountType(int16_t(0));
+  }
+}
+
+} // namespace sf2cute
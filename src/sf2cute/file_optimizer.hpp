@@ -0,0 +1,122 @@
+/// @file
+/// SoundFont 2 File optimizer class header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_FILE_OPTIMIZER_HPP_
+#define SF2CUTE_FILE_OPTIMIZER_HPP_
+
+#include <stddef.h>
+
+#include <sf2cute/types.hpp>
+#include <sf2cute/optimization_report.hpp>
+
+namespace sf2cute {
+
+class SoundFont;
+
+/// The SoundFontOptimizer class rewrites a SoundFont into an equivalent one with fewer records.
+///
+/// A generator of a local zone replaces the generator of the global zone,
+/// and a missing generator takes the value of the global zone, or the
+/// default value. At the instrument level, the default is the value defined
+/// by the specification; at the preset level, generators are added to the
+/// instrument values, so the default is no change (zero, or the full range).
+class SoundFontOptimizer {
+public:
+  /// Constructs a new SoundFontOptimizer using specified file.
+  /// @param file the SoundFont to optimize.
+  explicit SoundFontOptimizer(SoundFont & file) noexcept;
+
+  /// Returns the SoundFont to optimize.
+  /// @return the SoundFont to optimize.
+  SoundFont & file() const noexcept {
+    return *file_;
+  }
+
+  /// Removes the generators that do not change the sound.
+  ///
+  /// A generator of a local zone is removed when it equals the generator
+  /// of the global zone, or when the global zone has no such generator and
+  /// it equals the default. A key or velocity range of a local zone is only
+  /// removed for the default, never for the range of the global zone. A generator of the global zone is removed when it
+  /// equals the default. A global zone left empty is removed.
+  /// @return the removed generators and global zones.
+  SFOptimizationReport RemoveRedundantGenerators();
+
+  /// Moves the generators and modulators shared by the local zones into the global zone.
+  ///
+  /// For each generator, the global zone receives the value that the most
+  /// local zones end up with, and only the zones with another value keep
+  /// their own generator. A modulator is hoisted only when every local zone
+  /// ends up with the same modulator, since a local zone cannot opt out of a
+  /// global modulator. Nothing is changed unless it saves records, counting
+  /// the zone record of a new global zone.
+  /// @return the hoisted generators and modulators.
+  SFOptimizationReport HoistToGlobalZones();
+
+private:
+  /// The GeneratorPlan struct represents a generator to be hoisted.
+  struct GeneratorPlan {
+    /// The type of the generator.
+    SFGenerator op;
+
+    /// The value of the generator in the global zone.
+    GenAmountType amount;
+
+    /// The number of generator records saved.
+    size_t num_records;
+  };
+
+  /// Removes the generators that do not change the sound from a preset or an instrument.
+  /// @param element the preset or the instrument.
+  /// @param kind the kind of element.
+  /// @param element_index the index of the element in its list.
+  /// @param report the report that receives the changes.
+  template <typename T>
+  void RemoveRedundantGenerators(T & element,
+      SFOptimizationReport::Element kind,
+      size_t element_index,
+      SFOptimizationReport & report);
+
+  /// Moves the generators and modulators shared by the local zones of a preset or an instrument.
+  /// @param element the preset or the instrument.
+  /// @param kind the kind of element.
+  /// @param element_index the index of the element in its list.
+  /// @param report the report that receives the changes.
+  template <typename T>
+  void HoistToGlobalZone(T & element,
+      SFOptimizationReport::Element kind,
+      size_t element_index,
+      SFOptimizationReport & report);
+
+  /// Plans the hoisting of a generator.
+  /// @param element the preset or the instrument.
+  /// @param kind the kind of element.
+  /// @param op the type of the generator.
+  /// @param plan the plan, set if hoisting saves records.
+  /// @return true if hoisting saves records.
+  template <typename T>
+  static bool PlanGenerator(const T & element,
+      SFOptimizationReport::Element kind,
+      SFGenerator op,
+      GeneratorPlan & plan);
+
+  /// Returns true if the specified generator may be removed.
+  /// @param op the type of the generator.
+  /// @return false for the terminal generators and the unused generator types.
+  static bool IsRemovable(SFGenerator op) noexcept;
+
+  /// Returns the value that a missing generator takes.
+  /// @param kind the kind of element.
+  /// @param op the type of the generator.
+  /// @return the default amount of the generator.
+  static GenAmountType DefaultAmount(SFOptimizationReport::Element kind, SFGenerator op) noexcept;
+
+  /// The SoundFont to optimize.
+  SoundFont * file_;
+};
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_FILE_OPTIMIZER_HPP_
@@ -0,0 +1,669 @@
+/// @file
+/// SoundFont 2 File reader class implementation.
+///
+/// @author gocha <https://github.com/gocha>
+
+#include "file_reader.hpp"
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include <istream>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <sf2cute/file.hpp>
+#include <sf2cute/sample.hpp>
+#include <sf2cute/generator_item.hpp>
+#include <sf2cute/generator_set.hpp>
+#include <sf2cute/modulator_item.hpp>
+#include <sf2cute/instrument_zone.hpp>
+#include <sf2cute/instrument.hpp>
+#include <sf2cute/preset_zone.hpp>
+#include <sf2cute/preset.hpp>
+
+#include "byteio.hpp"
+#include "mapped_file.hpp"
+#include "riff_phdr_chunk.hpp"
+#include "riff_pbag_chunk.hpp"
+#include "riff_pmod_chunk.hpp"
+#include "riff_pgen_chunk.hpp"
+#include "riff_inst_chunk.hpp"
+#include "riff_ibag_chunk.hpp"
+#include "riff_imod_chunk.hpp"
+#include "riff_igen_chunk.hpp"
+#include "riff_shdr_chunk.hpp"
+
+namespace sf2cute {
+
+namespace {
+
+/// The number of bytes read from a non-seekable stream at once.
+constexpr std::streamsize kReadBlockSize = 1024 * 1024;
+
+/// The length of a name field in the pdta records, in terms of bytes.
+constexpr std::string::size_type kNameFieldLength = 20;
+
+/// The length of a generator record (sfGenList/sfInstGenList), in terms of bytes.
+constexpr size_t kGeneratorItemSize = 4;
+
+/// The length of a modulator record (sfModList/sfInstModList), in terms of bytes.
+constexpr size_t kModulatorItemSize = 10;
+
+/// The Bag struct represents a record of pbag/ibag chunk.
+struct Bag {
+  /// The index of the first generator.
+  uint16_t generator_index;
+
+  /// The index of the first modulator.
+  uint16_t modulator_index;
+};
+
+/// Reads the bag records and validates their indices.
+/// @param data a pointer to the pbag/ibag records.
+/// @param num_bags the number of bag records, including the terminator.
+/// @param num_generators the number of generator records, including the terminator.
+/// @param num_modulators the number of modulator records, including the terminator.
+/// @return the bag records.
+/// @throws std::runtime_error The bag records are malformed.
+std::vector<Bag> ReadBags(const char * data,
+    size_t num_bags,
+    size_t num_generators,
+    size_t num_modulators) {
+  std::vector<Bag> bags(num_bags);
+  for (size_t index = 0; index < num_bags; index++) {
+    data = ReadInt16L(data, bags[index].generator_index);
+    data = ReadInt16L(data, bags[index].modulator_index);
+
+    // Indices must be in ascending order and point to an existing record.
+    if (bags[index].generator_index >= num_generators ||
+        bags[index].modulator_index >= num_modulators ||
+        (index != 0 && (bags[index].generator_index < bags[index - 1].generator_index ||
+          bags[index].modulator_index < bags[index - 1].modulator_index))) {
+      throw std::runtime_error("Zone has an invalid generator or modulator index.");
+    }
+  }
+  return bags;
+}
+
+/// Reads a modulator record.
+/// @param data a pointer to the record.
+/// @return the modulator.
+SFModulatorItem ReadModulator(const char * data) {
+  uint16_t source_op;
+  uint16_t destination_op;
+  uint16_t amount;
+  uint16_t amount_source_op;
+  uint16_t transform_op;
+  data = ReadInt16L(data, source_op);
+  data = ReadInt16L(data, destination_op);
+  data = ReadInt16L(data, amount);
+  data = ReadInt16L(data, amount_source_op);
+  data = ReadInt16L(data, transform_op);
+  return SFModulatorItem(SFModulator(source_op),
+    SFGenerator(destination_op),
+    static_cast<int16_t>(amount),
+    SFModulator(amount_source_op),
+    SFTransform(transform_op));
+}
+
+/// Reads the generators and modulators of a zone.
+/// @param zone the zone to store the generators and modulators in.
+/// @param generators a pointer to the generator records.
+/// @param modulators a pointer to the modulator records.
+/// @param bag the bag record of the zone.
+/// @param next_bag the bag record following the zone.
+/// @param link_op the generator type that terminates the zone (instrument or sampleID).
+/// @param link_index the amount of the terminating generator, if any.
+/// @return true if the zone is terminated by the link generator.
+bool ReadZone(SFZone & zone,
+    const char * generators,
+    const char * modulators,
+    const Bag & bag,
+    const Bag & next_bag,
+    SFGenerator link_op,
+    uint16_t & link_index) {
+  bool linked = false;
+
+  // Generators:
+  const char * generator = generators + kGeneratorItemSize * bag.generator_index;
+  for (uint16_t index = bag.generator_index; index < next_bag.generator_index; index++) {
+    uint16_t op;
+    GenAmountType amount;
+    generator = ReadInt16L(generator, op);
+    generator = ReadInt16L(generator, amount.uvalue);
+
+    // The link generator must be the last one; the rest is ignored.
+    if (SFGenerator(op) == link_op) {
+      link_index = amount.uvalue;
+      linked = true;
+      break;
+    }
+
+    // Generators out of the known range are ignored, as the specification requires.
+    if (SFGeneratorSet::IsValid(SFGenerator(op))) {
+      zone.SetGenerator(SFGeneratorItem(SFGenerator(op), amount));
+    }
+  }
+
+  // Modulators:
+  const char * modulator = modulators + kModulatorItemSize * bag.modulator_index;
+  for (uint16_t index = bag.modulator_index; index < next_bag.modulator_index; index++) {
+    zone.SetModulator(ReadModulator(modulator));
+    modulator += kModulatorItemSize;
+  }
+
+  return linked;
+}
+
+} // namespace
+
+/// Reads a SoundFont from a file.
+SoundFont SoundFontReader::Read(const std::string & filename) {
+  std::ifstream in;
+
+  in.exceptions(std::ios::badbit | std::ios::failbit);
+  in.open(filename, std::ios::binary);
+
+  // Load the whole file at once.
+  in.seekg(0, std::ios::end);
+  const std::streamoff size = in.tellg();
+  in.seekg(0, std::ios::beg);
+
+  std::vector<char> data(static_cast<size_type>(size));
+  in.read(data.data(), std::streamsize(data.size()));
+
+  return Read(data.data(), data.size());
+}
+
+/// Reads a SoundFont from an input stream.
+SoundFont SoundFontReader::Read(std::istream & in) {
+  // Save exception bits of input stream.
+  const std::ios_base::iostate old_exception_bits = in.exceptions();
+  // Set exception bits to get input error as an exception.
+  in.exceptions(std::ios::badbit);
+
+  std::vector<char> data;
+  try {
+    // Load the whole stream in large blocks.
+    while (in) {
+      const size_type old_size = data.size();
+      data.resize(old_size + kReadBlockSize);
+      in.read(&data[old_size], kReadBlockSize);
+      data.resize(old_size + static_cast<size_type>(in.gcount()));
+    }
+  }
+  catch (const std::exception &) {
+    // Recover exception bits of input stream.
+    in.exceptions(old_exception_bits);
+
+    // Rethrow the exception.
+    throw;
+  }
+
+  // Recover exception bits of input stream.
+  in.clear(in.rdstate() & ~std::ios::failbit);
+  in.exceptions(old_exception_bits);
+
+  return Read(data.data(), data.size());
+}
+
+/// Reads a SoundFont from an input stream.
+SoundFont SoundFontReader::Read(std::istream && in) {
+  return Read(in);
+}
+
+/// Reads a SoundFont from a memory buffer.
+SoundFont SoundFontReader::Read(const char * data, size_type size) {
+  return Read(data, size, nullptr, arena_);
+}
+
+/// Reads a SoundFont from a memory-mapped file.
+SoundFont SoundFontReader::ReadMapped(const std::string & filename) {
+  const std::shared_ptr<MappedFile> file = MappedFile::Open(filename);
+  return Read(file->data(), file->size(), file, arena_);
+}
+
+/// Reads a SoundFont from a memory buffer.
+SoundFont SoundFontReader::Read(const char * data, size_type size,
+    const std::shared_ptr<const void> & buffer,
+    const std::shared_ptr<SFArena> & arena) {
+  // Check the RIFF header.
+  if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "sfbk", 4) != 0) {
+    throw std::runtime_error("Not a SoundFont 2 file.");
+  }
+
+  uint32_t riff_size;
+  ReadInt32L(data + 4, riff_size);
+  if (riff_size < 4 || riff_size > size - 8) {
+    throw std::runtime_error("RIFF file size is not valid.");
+  }
+
+  // Find the top-level chunks.
+  const Chunk * info = nullptr;
+  const Chunk * sdta = nullptr;
+  const Chunk * pdta = nullptr;
+  const std::vector<Chunk> chunks = ReadSubchunks(data + 12, riff_size - 4);
+  for (const auto & chunk : chunks) {
+    if (chunk.name == "INFO") {
+      info = &chunk;
+    }
+    else if (chunk.name == "sdta") {
+      sdta = &chunk;
+    }
+    else if (chunk.name == "pdta") {
+      pdta = &chunk;
+    }
+  }
+
+  if (pdta == nullptr) {
+    throw std::runtime_error("pdta chunk is missing.");
+  }
+
+  SoundFont file(arena);
+  if (info != nullptr) {
+    ReadInfoListChunk(*info, file);
+  }
+
+  Chunk smpl{ "smpl", nullptr, 0 };
+  if (sdta != nullptr) {
+    smpl = ReadSdtaListChunk(*sdta);
+  }
+
+  ReadPdtaListChunk(*pdta, smpl, buffer, file);
+  return file;
+}
+
+/// Splits the data of a list chunk into subchunks.
+std::vector<SoundFontReader::Chunk> SoundFontReader::ReadSubchunks(
+    const char * data, size_type size) {
+  std::vector<Chunk> chunks;
+  size_type offset = 0;
+  while (size - offset >= 8) {
+    // Read the chunk header.
+    std::string name(data + offset, 4);
+    uint32_t chunk_size;
+    ReadInt32L(data + offset + 4, chunk_size);
+    if (chunk_size > size - offset - 8) {
+      std::ostringstream message_builder;
+      message_builder << "RIFF chunk \"" << name << "\" size too large.";
+      throw std::runtime_error(message_builder.str());
+    }
+
+    const char * chunk_data = data + offset + 8;
+    if (name == "LIST") {
+      // Use the list type as the name of a list chunk.
+      if (chunk_size < 4) {
+        throw std::runtime_error("RIFF list chunk is too short.");
+      }
+      chunks.push_back(Chunk{ std::string(chunk_data, 4), chunk_data + 4, chunk_size - 4u });
+    }
+    else {
+      chunks.push_back(Chunk{ std::move(name), chunk_data, chunk_size });
+    }
+
+    // Skip the chunk data and a padding byte.
+    offset += 8 + size_type(chunk_size) + (chunk_size % 2);
+    if (offset > size) {
+      break;
+    }
+  }
+  return chunks;
+}
+
+/// Reads an INFO chunk.
+void SoundFontReader::ReadInfoListChunk(const Chunk & info, SoundFont & file) {
+  for (const auto & chunk : ReadSubchunks(info.data, info.size)) {
+    if (chunk.name == "isng") {
+      file.set_sound_engine(ReadZSTRChunk(chunk));
+    }
+    else if (chunk.name == "INAM") {
+      file.set_bank_name(ReadZSTRChunk(chunk));
+    }
+    else if (chunk.name == "irom") {
+      file.set_rom_name(ReadZSTRChunk(chunk));
+    }
+    else if (chunk.name == "iver") {
+      file.set_rom_version(ReadVersionChunk(chunk));
+    }
+    else if (chunk.name == "ICRD") {
+      file.set_creation_date(ReadZSTRChunk(chunk));
+    }
+    else if (chunk.name == "IENG") {
+      file.set_engineers(ReadZSTRChunk(chunk));
+    }
+    else if (chunk.name == "IPRD") {
+      file.set_product(ReadZSTRChunk(chunk));
+    }
+    else if (chunk.name == "ICOP") {
+      file.set_copyright(ReadZSTRChunk(chunk));
+    }
+    else if (chunk.name == "ICMT") {
+      file.set_comment(ReadZSTRChunk(chunk));
+    }
+    else if (chunk.name == "ISFT") {
+      file.set_software(ReadZSTRChunk(chunk));
+    }
+  }
+}
+
+/// Reads a sdta chunk.
+SoundFontReader::Chunk SoundFontReader::ReadSdtaListChunk(const Chunk & sdta) {
+  for (const auto & chunk : ReadSubchunks(sdta.data, sdta.size)) {
+    if (chunk.name == "smpl") {
+      return chunk;
+    }
+  }
+  return Chunk{ "smpl", nullptr, 0 };
+}
+
+/// Reads a pdta chunk.
+void SoundFontReader::ReadPdtaListChunk(const Chunk & pdta, const Chunk & smpl,
+    const std::shared_ptr<const void> & buffer, SoundFont & file) {
+  // Find the subchunks.
+  PdtaChunks chunks{};
+  const std::vector<std::pair<const char *, Chunk *>> names{
+    { "phdr", &chunks.phdr }, { "pbag", &chunks.pbag },
+    { "pmod", &chunks.pmod }, { "pgen", &chunks.pgen },
+    { "inst", &chunks.inst }, { "ibag", &chunks.ibag },
+    { "imod", &chunks.imod }, { "igen", &chunks.igen },
+    { "shdr", &chunks.shdr } };
+  for (const auto & chunk : ReadSubchunks(pdta.data, pdta.size)) {
+    for (const auto & name : names) {
+      if (chunk.name == name.first) {
+        *name.second = chunk;
+      }
+    }
+  }
+
+  for (const auto & name : names) {
+    if (name.second->data == nullptr) {
+      std::ostringstream message_builder;
+      message_builder << "RIFF chunk \"" << name.first << "\" is missing.";
+      throw std::runtime_error(message_builder.str());
+    }
+  }
+
+  // Read the elements in the order of dependency, from the arena of the file if any.
+  SFArena::Scope scope(file.arena());
+  const auto samples = ReadSamples(chunks.shdr, smpl, buffer);
+  const auto instruments = ReadInstruments(chunks, samples);
+  const auto presets = ReadPresets(chunks, instruments);
+
+  // Add the elements to the file, preserving the order of each list.
+  for (const auto & sample : samples) {
+    file.AddSample(sample);
+  }
+  for (const auto & instrument : instruments) {
+    file.AddInstrument(instrument);
+  }
+  for (const auto & preset : presets) {
+    file.AddPreset(preset);
+  }
+}
+
+/// Reads the sample headers and their sample data.
+std::vector<std::shared_ptr<SFSample>> SoundFontReader::ReadSamples(
+    const Chunk & shdr, const Chunk & smpl,
+    const std::shared_ptr<const void> & buffer) {
+  const size_type num_samples = NumItems(shdr, SFRIFFShdrChunk::kItemSize) - 1;
+  const size_type pool_length = smpl.size / sizeof(int16_t);
+
+  // The sample pool can be viewed in place only if it is already
+  // in the native byte order and suitably aligned.
+  const bool view_pool = buffer != nullptr && IsLittleEndianHost() &&
+    reinterpret_cast<uintptr_t>(smpl.data) % alignof(int16_t) == 0;
+
+  std::vector<std::shared_ptr<SFSample>> samples;
+  std::vector<uint16_t> links(num_samples);
+  samples.reserve(num_samples);
+
+  const char * record = shdr.data;
+  for (size_type index = 0; index < num_samples; index++) {
+    // struct sfSample:
+    std::string name = ReadName(record, kNameFieldLength);
+    const char * field = record + kNameFieldLength;
+    uint32_t start;
+    uint32_t end;
+    uint32_t start_loop;
+    uint32_t end_loop;
+    uint32_t sample_rate;
+    uint8_t original_key;
+    uint8_t correction;
+    uint16_t type;
+    field = ReadInt32L(field, start);
+    field = ReadInt32L(field, end);
+    field = ReadInt32L(field, start_loop);
+    field = ReadInt32L(field, end_loop);
+    field = ReadInt32L(field, sample_rate);
+    field = ReadInt8(field, original_key);
+    field = ReadInt8(field, correction);
+    field = ReadInt16L(field, links[index]);
+    field = ReadInt16L(field, type);
+    record += SFRIFFShdrChunk::kItemSize;
+
+    // Copy or view the sample data, unless the sample is located in ROM.
+    SFSampleData data;
+    const bool rom_sample = (type & 0x8000) != 0;
+    if (!rom_sample) {
+      if (start > end || end > pool_length) {
+        std::ostringstream message_builder;
+        message_builder << "Sample \"" << name << "\" points outside of the sample pool.";
+        throw std::runtime_error(message_builder.str());
+      }
+
+      const char * source = smpl.data + sizeof(int16_t) * start;
+      if (view_pool) {
+        data = SFSampleData(reinterpret_cast<const int16_t *>(source), end - start, buffer);
+      }
+      else {
+        std::vector<int16_t> datapoints(end - start);
+        if (IsLittleEndianHost()) {
+          if (!datapoints.empty()) {
+            memcpy(datapoints.data(), source, sizeof(int16_t) * datapoints.size());
+          }
+        }
+        else {
+          for (auto & value : datapoints) {
+            uint16_t datapoint;
+            source = ReadInt16L(source, datapoint);
+            value = static_cast<int16_t>(datapoint);
+          }
+        }
+        data = SFSampleData(std::move(datapoints));
+      }
+    }
+
+    // Make the loop points relative to the beginning of the sample.
+    samples.push_back(SFArena::MakeShared<SFSample>(SFArena::current(),
+      std::move(name),
+      std::move(data),
+      start_loop >= start ? start_loop - start : 0,
+      end_loop >= start ? end_loop - start : 0,
+      sample_rate,
+      original_key,
+      static_cast<int8_t>(correction),
+      std::weak_ptr<SFSample>(),
+      SFSampleLink(type)));
+  }
+
+  // Resolve the sample links.
+  for (size_type index = 0; index < num_samples; index++) {
+    const uint16_t type = static_cast<uint16_t>(samples[index]->type()) & 0x7fff;
+    if (type != static_cast<uint16_t>(SFSampleLink::kMonoSample) && links[index] < num_samples) {
+      samples[index]->set_link(samples[links[index]]);
+    }
+  }
+
+  return samples;
+}
+
+/// Reads the instruments.
+std::vector<std::shared_ptr<SFInstrument>> SoundFontReader::ReadInstruments(
+    const PdtaChunks & chunks,
+    const std::vector<std::shared_ptr<SFSample>> & samples) {
+  const size_type num_instruments = NumItems(chunks.inst, SFRIFFInstChunk::kItemSize) - 1;
+  const std::vector<Bag> bags = ReadBags(chunks.ibag.data,
+    NumItems(chunks.ibag, SFRIFFIbagChunk::kItemSize),
+    NumItems(chunks.igen, SFRIFFIgenChunk::kItemSize),
+    NumItems(chunks.imod, SFRIFFImodChunk::kItemSize));
+
+  // Read the bag index of every instrument, including the terminator.
+  std::vector<uint16_t> bag_indices(num_instruments + 1);
+  const char * record = chunks.inst.data;
+  for (size_type index = 0; index <= num_instruments; index++) {
+    ReadInt16L(record + kNameFieldLength, bag_indices[index]);
+    if (bag_indices[index] >= bags.size() ||
+        (index != 0 && bag_indices[index] < bag_indices[index - 1])) {
+      throw std::runtime_error("Instrument has an invalid zone index.");
+    }
+    record += SFRIFFInstChunk::kItemSize;
+  }
+
+  std::vector<std::shared_ptr<SFInstrument>> instruments;
+  instruments.reserve(num_instruments);
+  record = chunks.inst.data;
+  for (size_type index = 0; index < num_instruments; index++) {
+    // struct sfInst:
+    auto instrument = SFArena::MakeShared<SFInstrument>(SFArena::current(),
+      ReadName(record, kNameFieldLength));
+    record += SFRIFFInstChunk::kItemSize;
+
+    // Instrument zones:
+    for (uint16_t bag_index = bag_indices[index]; bag_index < bag_indices[index + 1]; bag_index++) {
+      SFInstrumentZone zone;
+      uint16_t sample_index = 0;
+      const bool has_sample = ReadZone(zone, chunks.igen.data, chunks.imod.data,
+        bags[bag_index], bags[bag_index + 1], SFGenerator::kSampleID, sample_index);
+
+      if (has_sample) {
+        if (sample_index >= samples.size()) {
+          throw std::runtime_error("Instrument zone points to an unknown sample.");
+        }
+        zone.set_sample(samples[sample_index]);
+        instrument->AddZone(std::move(zone));
+      }
+      else if (bag_index == bag_indices[index]) {
+        // Only the first zone can be a global zone.
+        instrument->set_global_zone(std::move(zone));
+      }
+    }
+
+    instruments.push_back(std::move(instrument));
+  }
+
+  return instruments;
+}
+
+/// Reads the presets.
+std::vector<std::shared_ptr<SFPreset>> SoundFontReader::ReadPresets(
+    const PdtaChunks & chunks,
+    const std::vector<std::shared_ptr<SFInstrument>> & instruments) {
+  const size_type num_presets = NumItems(chunks.phdr, SFRIFFPhdrChunk::kItemSize) - 1;
+  const std::vector<Bag> bags = ReadBags(chunks.pbag.data,
+    NumItems(chunks.pbag, SFRIFFPbagChunk::kItemSize),
+    NumItems(chunks.pgen, SFRIFFPgenChunk::kItemSize),
+    NumItems(chunks.pmod, SFRIFFPmodChunk::kItemSize));
+
+  // Read the bag index of every preset, including the terminator.
+  std::vector<uint16_t> bag_indices(num_presets + 1);
+  const char * record = chunks.phdr.data;
+  for (size_type index = 0; index <= num_presets; index++) {
+    ReadInt16L(record + kNameFieldLength + 4, bag_indices[index]);
+    if (bag_indices[index] >= bags.size() ||
+        (index != 0 && bag_indices[index] < bag_indices[index - 1])) {
+      throw std::runtime_error("Preset has an invalid zone index.");
+    }
+    record += SFRIFFPhdrChunk::kItemSize;
+  }
+
+  std::vector<std::shared_ptr<SFPreset>> presets;
+  presets.reserve(num_presets);
+  record = chunks.phdr.data;
+  for (size_type index = 0; index < num_presets; index++) {
+    // struct sfPresetHeader:
+    const char * field = record + kNameFieldLength;
+    uint16_t preset_number;
+    uint16_t bank;
+    uint16_t preset_bag_index;
+    uint32_t library;
+    uint32_t genre;
+    uint32_t morphology;
+    field = ReadInt16L(field, preset_number);
+    field = ReadInt16L(field, bank);
+    field = ReadInt16L(field, preset_bag_index);
+    field = ReadInt32L(field, library);
+    field = ReadInt32L(field, genre);
+    field = ReadInt32L(field, morphology);
+
+    auto preset = SFArena::MakeShared<SFPreset>(SFArena::current(),
+      ReadName(record, kNameFieldLength), preset_number, bank);
+    preset->set_library(library);
+    preset->set_genre(genre);
+    preset->set_morphology(morphology);
+    record += SFRIFFPhdrChunk::kItemSize;
+
+    // Preset zones:
+    for (uint16_t bag_index = bag_indices[index]; bag_index < bag_indices[index + 1]; bag_index++) {
+      SFPresetZone zone;
+      uint16_t instrument_index = 0;
+      const bool has_instrument = ReadZone(zone, chunks.pgen.data, chunks.pmod.data,
+        bags[bag_index], bags[bag_index + 1], SFGenerator::kInstrument, instrument_index);
+
+      if (has_instrument) {
+        if (instrument_index >= instruments.size()) {
+          throw std::runtime_error("Preset zone points to an unknown instrument.");
+        }
+        zone.set_instrument(instruments[instrument_index]);
+        preset->AddZone(std::move(zone));
+      }
+      else if (bag_index == bag_indices[index]) {
+        // Only the first zone can be a global zone.
+        preset->set_global_zone(std::move(zone));
+      }
+    }
+
+    presets.push_back(std::move(preset));
+  }
+
+  return presets;
+}
+
+/// Reads a fixed-length, zero-padded name field.
+std::string SoundFontReader::ReadName(const char * data, size_type size) {
+  return std::string(data, std::find(data, data + size, '\0'));
+}
+
+/// Reads a version chunk.
+SFVersionTag SoundFontReader::ReadVersionChunk(const Chunk & chunk) {
+  if (chunk.size < 4) {
+    std::ostringstream message_builder;
+    message_builder << "RIFF chunk \"" << chunk.name << "\" is too short.";
+    throw std::runtime_error(message_builder.str());
+  }
+
+  SFVersionTag version;
+  ReadInt16L(ReadInt16L(chunk.data, version.major_version), version.minor_version);
+  return version;
+}
+
+/// Reads a chunk with a string.
+std::string SoundFontReader::ReadZSTRChunk(const Chunk & chunk) {
+  return ReadName(chunk.data, chunk.size);
+}
+
+/// Returns the number of records in a pdta subchunk.
+SoundFontReader::size_type SoundFontReader::NumItems(const Chunk & chunk, size_type item_size) {
+  if (chunk.size % item_size != 0 || chunk.size < item_size) {
+    std::ostringstream message_builder;
+    message_builder << "RIFF chunk \"" << chunk.name << "\" size is not valid.";
+    throw std::runtime_error(message_builder.str());
+  }
+  return chunk.size / item_size;
+}
+
+} // namespace sf2cute
@@ -0,0 +1,226 @@
+/// @file
+/// SoundFont 2 File reader class header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_FILE_READER_HPP_
+#define SF2CUTE_FILE_READER_HPP_
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <istream>
+
+#include <sf2cute/types.hpp>
+
+namespace sf2cute {
+
+class SFArena;
+class SFSample;
+class SFInstrument;
+class SFPreset;
+class SoundFont;
+
+/// The SoundFontReader class represents a SoundFont reader.
+///
+/// The reader loads the whole file into a contiguous buffer and
+/// parses every chunk in a single pass over that buffer.
+class SoundFontReader {
+public:
+  /// Unsigned integer type for the chunk size.
+  using size_type = std::vector<char>::size_type;
+
+  /// Constructs a new SoundFontReader.
+  SoundFontReader() = default;
+
+  /// Constructs a new SoundFontReader that allocates the elements from an arena.
+  /// @param arena the arena of the SoundFonts to read, or nullptr.
+  explicit SoundFontReader(std::shared_ptr<SFArena> arena) noexcept :
+      arena_(std::move(arena)) {
+  }
+
+  /// Constructs a new copy of specified SoundFontReader.
+  /// @param origin a SoundFontReader object.
+  SoundFontReader(const SoundFontReader & origin) = default;
+
+  /// Copy-assigns a new value to the SoundFontReader, replacing its current contents.
+  /// @param origin a SoundFontReader object.
+  SoundFontReader & operator=(const SoundFontReader & origin) = default;
+
+  /// Acquires the contents of specified SoundFontReader.
+  /// @param origin a SoundFontReader object.
+  SoundFontReader(SoundFontReader && origin) = default;
+
+  /// Move-assigns a new value to the SoundFontReader, replacing its current contents.
+  /// @param origin a SoundFontReader object.
+  SoundFontReader & operator=(SoundFontReader && origin) = default;
+
+  /// Destructs the SoundFontReader.
+  ~SoundFontReader() = default;
+
+  /// Reads a SoundFont from a file.
+  /// @param filename the name of the file to read from.
+  /// @return the SoundFont read from the file.
+  /// @throws std::runtime_error The file is not a valid SoundFont.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  SoundFont Read(const std::string & filename);
+
+  /// Reads a SoundFont from an input stream.
+  /// @param in the input stream to read from.
+  /// @return the SoundFont read from the stream.
+  /// @throws std::runtime_error The stream does not contain a valid SoundFont.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  SoundFont Read(std::istream & in);
+
+  /// @copydoc SoundFontReader::Read(std::istream &)
+  SoundFont Read(std::istream && in);
+
+  /// Reads a SoundFont from a memory buffer.
+  /// @param data a pointer to the beginning of the file image.
+  /// @param size the length of the file image, in terms of bytes.
+  /// @return the SoundFont read from the buffer.
+  /// @throws std::runtime_error The buffer does not contain a valid SoundFont.
+  SoundFont Read(const char * data, size_type size);
+
+  /// Reads a SoundFont from a memory-mapped file.
+  /// @param filename the name of the file to read from.
+  /// @return the SoundFont read from the file.
+  /// @throws std::runtime_error The file is not a valid SoundFont.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  /// @remarks The sample data views the mapped "smpl" chunk and is
+  /// copied into memory only when it is modified. The mapping is
+  /// released when the last sample that views it is destroyed.
+  SoundFont ReadMapped(const std::string & filename);
+
+private:
+  /// The Chunk struct represents the location of a RIFF chunk in the buffer.
+  struct Chunk {
+    /// The name of the chunk (FourCC), or the list type for a "LIST" chunk.
+    std::string name;
+
+    /// A pointer to the chunk data, excluding the list type for a "LIST" chunk.
+    const char * data;
+
+    /// The length of the chunk data, in terms of bytes.
+    size_type size;
+  };
+
+  /// The PdtaChunks struct holds the location of every pdta subchunk.
+  struct PdtaChunks {
+    /// The "phdr" subchunk.
+    Chunk phdr;
+    /// The "pbag" subchunk.
+    Chunk pbag;
+    /// The "pmod" subchunk.
+    Chunk pmod;
+    /// The "pgen" subchunk.
+    Chunk pgen;
+    /// The "inst" subchunk.
+    Chunk inst;
+    /// The "ibag" subchunk.
+    Chunk ibag;
+    /// The "imod" subchunk.
+    Chunk imod;
+    /// The "igen" subchunk.
+    Chunk igen;
+    /// The "shdr" subchunk.
+    Chunk shdr;
+  };
+
+  /// Reads a SoundFont from a memory buffer.
+  /// @param data a pointer to the beginning of the file image.
+  /// @param size the length of the file image, in terms of bytes.
+  /// @param buffer the owner of the file image, or nullptr to copy the sample data.
+  /// @param arena the arena of the SoundFont, or nullptr.
+  /// @return the SoundFont read from the buffer.
+  /// @throws std::runtime_error The buffer does not contain a valid SoundFont.
+  static SoundFont Read(const char * data, size_type size,
+      const std::shared_ptr<const void> & buffer,
+      const std::shared_ptr<SFArena> & arena);
+
+  /// Splits the data of a list chunk into subchunks.
+  /// @param data a pointer to the list data.
+  /// @param size the length of the list data, in terms of bytes.
+  /// @return the subchunks of the list.
+  /// @throws std::runtime_error The list is malformed.
+  static std::vector<Chunk> ReadSubchunks(const char * data, size_type size);
+
+  /// Reads an INFO chunk.
+  /// @param info the INFO chunk.
+  /// @param file the SoundFont to store the metadata in.
+  static void ReadInfoListChunk(const Chunk & info, SoundFont & file);
+
+  /// Reads a sdta chunk.
+  /// @param sdta the sdta chunk.
+  /// @return the smpl subchunk, or an empty chunk if the sample pool is absent.
+  static Chunk ReadSdtaListChunk(const Chunk & sdta);
+
+  /// Reads a pdta chunk.
+  /// @param pdta the pdta chunk.
+  /// @param smpl the smpl subchunk.
+  /// @param buffer the owner of the smpl subchunk, or nullptr to copy the sample data.
+  /// @param file the SoundFont to store the presets, instruments and samples in.
+  /// @throws std::runtime_error The pdta chunk is malformed.
+  static void ReadPdtaListChunk(const Chunk & pdta, const Chunk & smpl,
+      const std::shared_ptr<const void> & buffer, SoundFont & file);
+
+  /// Reads the sample headers and their sample data.
+  /// @param shdr the shdr subchunk.
+  /// @param smpl the smpl subchunk.
+  /// @param buffer the owner of the smpl subchunk, or nullptr to copy the sample data.
+  /// @return the samples.
+  /// @throws std::runtime_error The sample headers are malformed.
+  static std::vector<std::shared_ptr<SFSample>> ReadSamples(
+      const Chunk & shdr, const Chunk & smpl,
+      const std::shared_ptr<const void> & buffer);
+
+  /// Reads the instruments.
+  /// @param chunks the pdta subchunks.
+  /// @param samples the samples referenced by the instruments.
+  /// @return the instruments.
+  /// @throws std::runtime_error The instrument records are malformed.
+  static std::vector<std::shared_ptr<SFInstrument>> ReadInstruments(
+      const PdtaChunks & chunks,
+      const std::vector<std::shared_ptr<SFSample>> & samples);
+
+  /// Reads the presets.
+  /// @param chunks the pdta subchunks.
+  /// @param instruments the instruments referenced by the presets.
+  /// @return the presets.
+  /// @throws std::runtime_error The preset records are malformed.
+  static std::vector<std::shared_ptr<SFPreset>> ReadPresets(
+      const PdtaChunks & chunks,
+      const std::vector<std::shared_ptr<SFInstrument>> & instruments);
+
+  /// Reads a fixed-length, zero-padded name field.
+  /// @param data a pointer to the name field.
+  /// @param size the length of the field, in terms of bytes.
+  /// @return the name.
+  static std::string ReadName(const char * data, size_type size);
+
+  /// Reads a version chunk.
+  /// @param chunk the chunk.
+  /// @return the version number.
+  /// @throws std::runtime_error The chunk is too short.
+  static SFVersionTag ReadVersionChunk(const Chunk & chunk);
+
+  /// Reads a chunk with a string.
+  /// @param chunk the chunk.
+  /// @return the data string.
+  static std::string ReadZSTRChunk(const Chunk & chunk);
+
+  /// Returns the number of records in a pdta subchunk.
+  /// @param chunk the subchunk.
+  /// @param item_size the size of a record, in terms of bytes.
+  /// @return the number of records, including the terminator record.
+  /// @throws std::runtime_error The subchunk size is not valid.
+  static size_type NumItems(const Chunk & chunk, size_type item_size);
+
+  /// The arena of the SoundFonts to read.
+  std::shared_ptr<SFArena> arena_;
+};
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_FILE_READER_HPP_
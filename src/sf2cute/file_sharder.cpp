@@ -0,0 +1,425 @@
+/// @file
+/// SoundFont 2 File sharder class implementation.
+///
+/// @author gocha <https://github.com/gocha>
+
+#include "file_sharder.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+
+#include <sf2cute/file.hpp>
+#include <sf2cute/sample.hpp>
+#include <sf2cute/instrument_zone.hpp>
+#include <sf2cute/instrument.hpp>
+#include <sf2cute/preset_zone.hpp>
+#include <sf2cute/preset.hpp>
+
+#include "file_writer.hpp"
+#include "riff_phdr_chunk.hpp"
+#include "riff_pbag_chunk.hpp"
+#include "riff_pmod_chunk.hpp"
+#include "riff_pgen_chunk.hpp"
+#include "riff_inst_chunk.hpp"
+#include "riff_ibag_chunk.hpp"
+#include "riff_imod_chunk.hpp"
+#include "riff_igen_chunk.hpp"
+#include "riff_shdr_chunk.hpp"
+
+namespace sf2cute {
+
+namespace {
+
+/// The shard index of an element that is not assigned to any shard yet.
+constexpr size_t kNoShard = static_cast<size_t>(-1);
+
+} // namespace
+
+/// Constructs a new empty Usage.
+SoundFontSharder::Usage::Usage() noexcept :
+    num_presets(0),
+    num_preset_zones(0),
+    num_preset_modulators(0),
+    num_preset_generators(0),
+    num_instruments(0),
+    num_instrument_zones(0),
+    num_instrument_modulators(0),
+    num_instrument_generators(0),
+    num_samples(0),
+    sample_pool_size(0) {
+}
+
+/// Adds the specified usage.
+SoundFontSharder::Usage & SoundFontSharder::Usage::operator+=(const Usage & other) noexcept {
+  num_presets += other.num_presets;
+  num_preset_zones += other.num_preset_zones;
+  num_preset_modulators += other.num_preset_modulators;
+  num_preset_generators += other.num_preset_generators;
+  num_instruments += other.num_instruments;
+  num_instrument_zones += other.num_instrument_zones;
+  num_instrument_modulators += other.num_instrument_modulators;
+  num_instrument_generators += other.num_instrument_generators;
+  num_samples += other.num_samples;
+  sample_pool_size += other.sample_pool_size;
+  return *this;
+}
+
+/// Constructs a new SoundFontSharder using specified file.
+SoundFontSharder::SoundFontSharder(const SoundFont & file) :
+    file_(&file),
+    empty_file_size_(0) {
+}
+
+/// Splits the SoundFont.
+std::vector<SoundFont> SoundFontSharder::Split() {
+  // Measure the INFO chunk and the terminator records once.
+  SoundFont empty_file;
+  CopyInfo(empty_file);
+  empty_file_size_ = SoundFontWriter(empty_file).GetWriteSize();
+
+  instrument_shards_.assign(file().instruments().size(), kNoShard);
+  sample_shards_.assign(file().samples().size(), kNoShard);
+
+  // Pack the presets in order, starting a new shard when one is full.
+  std::vector<Shard> shards(1);
+  for (size_t preset_index = 0; preset_index < file().presets().size(); preset_index++) {
+    const SFPreset & preset = *file().presets()[preset_index];
+
+    Shard * shard = &shards.back();
+    const size_t num_instruments = shard->instruments.size();
+    const size_t num_samples = shard->samples.size();
+    Usage usage = shard->usage;
+    usage += AddPreset(preset, shards.size() - 1, *shard);
+    if (!Fits(usage)) {
+      // Take back the new elements, and retry with a new shard.
+      shard->instruments.resize(num_instruments);
+      shard->samples.resize(num_samples);
+      if (!shard->presets.empty()) {
+        shards.emplace_back();
+        shard = &shards.back();
+        usage = AddPreset(preset, shards.size() - 1, *shard);
+      }
+
+      if (shard->presets.empty() && !Fits(usage)) {
+        std::ostringstream message_builder;
+        message_builder << "Preset \"" << preset.name() << "\" does not fit in a SoundFont file.";
+        throw std::length_error(message_builder.str());
+      }
+    }
+
+    shard->presets.push_back(preset_index);
+    shard->usage = usage;
+  }
+
+  // Keep the instruments and samples that no preset refers to in the last shards.
+  for (size_t instrument_index = 0; instrument_index < file().instruments().size(); instrument_index++) {
+    if (instrument_shards_[instrument_index] == kNoShard) {
+      const SFInstrument & instrument = *file().instruments()[instrument_index];
+      AddUnreferenced(shards, "Instrument \"" + instrument.name() + "\"", [&](size_t shard_index, Shard & shard, Usage & usage) {
+        AddInstrument(instrument, shard_index, shard, usage);
+      });
+    }
+  }
+  for (size_t sample_index = 0; sample_index < file().samples().size(); sample_index++) {
+    if (sample_shards_[sample_index] == kNoShard) {
+      const std::shared_ptr<SFSample> & sample = file().samples()[sample_index];
+      AddUnreferenced(shards, "Sample \"" + sample->name() + "\"", [&](size_t shard_index, Shard & shard, Usage & usage) {
+        AddSample(sample, shard_index, shard, usage);
+      });
+    }
+  }
+
+  // Build the shards.
+  instrument_copies_.assign(file().instruments().size(), nullptr);
+  sample_copies_.assign(file().samples().size(), nullptr);
+  std::vector<SoundFont> files;
+  files.reserve(shards.size());
+  for (auto & shard : shards) {
+    files.push_back(MakeShard(shard));
+  }
+  instrument_copies_.clear();
+  sample_copies_.clear();
+  return files;
+}
+
+/// Returns the name of a shard file.
+std::string SoundFontSharder::ShardFilename(const std::string & filename, size_t shard_index) {
+  // Insert the shard number before the extension, if any.
+  const std::string::size_type directory_end = filename.find_last_of("/\\");
+  std::string::size_type extension_start = filename.rfind('.');
+  if (extension_start == std::string::npos ||
+      (directory_end != std::string::npos && extension_start < directory_end)) {
+    extension_start = filename.size();
+  }
+
+  std::ostringstream name_builder;
+  name_builder << filename.substr(0, extension_start) << '-' << (shard_index + 1)
+    << filename.substr(extension_start);
+  return name_builder.str();
+}
+
+/// Measures what a preset adds to a shard, and assigns its new elements to the shard.
+SoundFontSharder::Usage SoundFontSharder::AddPreset(const SFPreset & preset,
+    size_t shard_index,
+    Shard & shard) {
+  Usage usage;
+  usage.num_presets = 1;
+
+  // Count the global zone.
+  if (preset.has_global_zone()) {
+    usage.num_preset_zones++;
+    usage.num_preset_modulators += preset.global_zone().modulators().size();
+    usage.num_preset_generators += preset.global_zone().generators().size();
+  }
+
+  // Count the preset zones, and the instruments they refer to.
+  for (const auto & zone : preset.zones()) {
+    usage.num_preset_zones++;
+    usage.num_preset_modulators += zone->modulators().size();
+    usage.num_preset_generators += zone->generators().size();
+    if (!zone->has_instrument()) {
+      continue;
+    }
+    usage.num_preset_generators++;
+
+    const std::shared_ptr<SFInstrument> instrument = zone->instrument();
+    if (!Contains(*instrument)) {
+      throw std::out_of_range("Preset zone points to an unknown instrument.");
+    }
+    AddInstrument(*instrument, shard_index, shard, usage);
+  }
+  return usage;
+}
+
+/// Assigns an instrument and its samples to a shard, unless already assigned.
+void SoundFontSharder::AddInstrument(const SFInstrument & instrument,
+    size_t shard_index,
+    Shard & shard,
+    Usage & usage) {
+  const size_t instrument_index = instrument.file_index_;
+  if (instrument_shards_[instrument_index] == shard_index) {
+    return;
+  }
+  instrument_shards_[instrument_index] = shard_index;
+  shard.instruments.push_back(instrument_index);
+
+  // Count the instrument.
+  usage.num_instruments++;
+  if (instrument.has_global_zone()) {
+    usage.num_instrument_zones++;
+    usage.num_instrument_modulators += instrument.global_zone().modulators().size();
+    usage.num_instrument_generators += instrument.global_zone().generators().size();
+  }
+  for (const auto & instrument_zone : instrument.zones()) {
+    usage.num_instrument_zones++;
+    usage.num_instrument_modulators += instrument_zone->modulators().size();
+    usage.num_instrument_generators += instrument_zone->generators().size();
+    if (instrument_zone->has_sample()) {
+      usage.num_instrument_generators++;
+      AddSample(instrument_zone->sample(), shard_index, shard, usage);
+    }
+  }
+}
+
+/// Assigns a sample and its linked samples to a shard, unless already assigned.
+void SoundFontSharder::AddSample(const std::shared_ptr<SFSample> & sample,
+    size_t shard_index,
+    Shard & shard,
+    Usage & usage) {
+  if (!Contains(*sample)) {
+    throw std::out_of_range("Instrument zone points to an unknown sample.");
+  }
+  const size_t sample_index = sample->file_index_;
+  if (sample_shards_[sample_index] == shard_index) {
+    return;
+  }
+  sample_shards_[sample_index] = shard_index;
+  shard.samples.push_back(sample_index);
+
+  usage.num_samples++;
+  usage.sample_pool_size += sizeof(int16_t) *
+      (sample->data().size() + SFSample::kTerminatorSampleLength);
+
+  // A stereo pair must be written in the same file.
+  if (sample->has_link()) {
+    const std::shared_ptr<SFSample> link = sample->link();
+    if (Contains(*link)) {
+      AddSample(link, shard_index, shard, usage);
+    }
+  }
+}
+
+/// Assigns an element that no preset refers to to the last shard, or to a new shard if it is full.
+template <typename Function>
+void SoundFontSharder::AddUnreferenced(std::vector<Shard> & shards,
+    const std::string & description,
+    Function add) {
+  Shard * shard = &shards.back();
+  const size_t num_instruments = shard->instruments.size();
+  const size_t num_samples = shard->samples.size();
+  Usage usage = shard->usage;
+  add(shards.size() - 1, *shard, usage);
+  if (!Fits(usage)) {
+    // Take back the new elements, and retry with a new shard.
+    shard->instruments.resize(num_instruments);
+    shard->samples.resize(num_samples);
+    const bool empty_shard = shard->presets.empty() &&
+        shard->instruments.empty() && shard->samples.empty();
+    if (!empty_shard) {
+      shards.emplace_back();
+      shard = &shards.back();
+      usage = Usage();
+      add(shards.size() - 1, *shard, usage);
+    }
+
+    if (empty_shard || !Fits(usage)) {
+      std::ostringstream message_builder;
+      message_builder << description << " does not fit in a SoundFont file.";
+      throw std::length_error(message_builder.str());
+    }
+  }
+  shard->usage = usage;
+}
+
+/// Returns true if the specified usage fits in a file.
+bool SoundFontSharder::Fits(const Usage & usage) const noexcept {
+  // Every record count includes a terminator record.
+  const size_type num_records[] = {
+    usage.num_presets, usage.num_preset_zones,
+    usage.num_preset_modulators, usage.num_preset_generators,
+    usage.num_instruments, usage.num_instrument_zones,
+    usage.num_instrument_modulators, usage.num_instrument_generators,
+    usage.num_samples
+  };
+  for (const size_type num_record : num_records) {
+    if (num_record + 1 > UINT16_MAX) {
+      return false;
+    }
+  }
+
+  if (usage.sample_pool_size > UINT32_MAX) {
+    return false;
+  }
+
+  // The RIFF header counts every byte after its first 8 bytes.
+  const size_type file_size = empty_file_size_ + usage.sample_pool_size +
+      SFRIFFPhdrChunk::kItemSize * usage.num_presets +
+      SFRIFFPbagChunk::kItemSize * usage.num_preset_zones +
+      SFRIFFPmodChunk::kItemSize * usage.num_preset_modulators +
+      SFRIFFPgenChunk::kItemSize * usage.num_preset_generators +
+      SFRIFFInstChunk::kItemSize * usage.num_instruments +
+      SFRIFFIbagChunk::kItemSize * usage.num_instrument_zones +
+      SFRIFFImodChunk::kItemSize * usage.num_instrument_modulators +
+      SFRIFFIgenChunk::kItemSize * usage.num_instrument_generators +
+      SFRIFFShdrChunk::kItemSize * usage.num_samples;
+  return file_size - 8 <= UINT32_MAX;
+}
+
+/// Builds a shard.
+SoundFont SoundFontSharder::MakeShard(Shard & shard) {
+  SoundFont shard_file;
+  CopyInfo(shard_file);
+
+  // Keep the original order of the elements.
+  std::sort(shard.instruments.begin(), shard.instruments.end());
+  std::sort(shard.samples.begin(), shard.samples.end());
+
+  // Copy the samples, sharing their data with the original.
+  for (const size_t sample_index : shard.samples) {
+    const auto sample = std::make_shared<SFSample>(*file().samples()[sample_index]);
+    sample_copies_[sample_index] = sample;
+    shard_file.AddSample(sample);
+  }
+  for (const size_t sample_index : shard.samples) {
+    const auto & sample = sample_copies_[sample_index];
+    if (sample->has_link()) {
+      const std::shared_ptr<SFSample> link = sample->link();
+      if (Contains(*link)) {
+        sample->set_link(sample_copies_[link->file_index_]);
+      }
+    }
+  }
+
+  // Copy the instruments, pointing to the copied samples.
+  for (const size_t instrument_index : shard.instruments) {
+    const auto instrument = std::make_shared<SFInstrument>(*file().instruments()[instrument_index]);
+    for (const auto & zone : instrument->zones()) {
+      if (zone->has_sample()) {
+        zone->set_sample(sample_copies_[zone->sample()->file_index_]);
+      }
+    }
+    instrument_copies_[instrument_index] = instrument;
+    shard_file.AddInstrument(instrument);
+  }
+
+  // Copy the presets, pointing to the copied instruments.
+  for (const size_t preset_index : shard.presets) {
+    const auto preset = std::make_shared<SFPreset>(*file().presets()[preset_index]);
+    for (const auto & zone : preset->zones()) {
+      if (zone->has_instrument()) {
+        zone->set_instrument(instrument_copies_[zone->instrument()->file_index_]);
+      }
+    }
+    shard_file.AddPreset(preset);
+  }
+
+  // Release the copies, which are owned by the shard from now on.
+  for (const size_t sample_index : shard.samples) {
+    sample_copies_[sample_index].reset();
+  }
+  for (const size_t instrument_index : shard.instruments) {
+    instrument_copies_[instrument_index].reset();
+  }
+  return shard_file;
+}
+
+/// Copies the INFO fields of the SoundFont.
+void SoundFontSharder::CopyInfo(SoundFont & shard) const {
+  shard.set_sound_engine(file().sound_engine());
+  shard.set_bank_name(file().bank_name());
+  if (file().has_rom_name()) {
+    shard.set_rom_name(file().rom_name());
+  }
+  if (file().has_rom_version()) {
+    shard.set_rom_version(file().rom_version());
+  }
+  if (file().has_creation_date()) {
+    shard.set_creation_date(file().creation_date());
+  }
+  if (file().has_engineers()) {
+    shard.set_engineers(file().engineers());
+  }
+  if (file().has_product()) {
+    shard.set_product(file().product());
+  }
+  if (file().has_copyright()) {
+    shard.set_copyright(file().copyright());
+  }
+  if (file().has_comment()) {
+    shard.set_comment(file().comment());
+  }
+  if (file().has_software()) {
+    shard.set_software(file().software());
+  }
+}
+
+/// Returns true if the specified sample belongs to the SoundFont.
+bool SoundFontSharder::Contains(const SFSample & sample) const noexcept {
+  return sample.has_parent_file() && &sample.parent_file() == file_ &&
+      file().samples()[sample.file_index_].get() == &sample;
+}
+
+/// Returns true if the specified instrument belongs to the SoundFont.
+bool SoundFontSharder::Contains(const SFInstrument & instrument) const noexcept {
+  return instrument.has_parent_file() && &instrument.parent_file() == file_ &&
+      file().instruments()[instrument.file_index_].get() == &instrument;
+}
+
+} // namespace sf2cute
@@ -0,0 +1,203 @@
+/// @file
+/// SoundFont 2 File sharder class header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_FILE_SHARDER_HPP_
+#define SF2CUTE_FILE_SHARDER_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sf2cute {
+
+class SFSample;
+class SFInstrument;
+class SFPreset;
+class SoundFont;
+
+/// The SoundFontSharder class splits a SoundFont into SoundFonts that fit in a file.
+///
+/// The presets are packed into shards in order. Each shard receives a copy
+/// of the instruments and samples (including linked stereo samples) that its
+/// presets refer to, so that every shard is a self-contained SoundFont. A shard
+/// is closed when the next preset would exceed the 16-bit record count of a
+/// pdta subchunk, or the 32-bit size of the sample pool or of the file.
+/// The copies share their sample data with the original SoundFont.
+/// Instruments and samples that no preset refers to are added after the
+/// presets, to the last shard or to new shards when it is full.
+class SoundFontSharder {
+public:
+  /// Unsigned integer type for the record counts and sizes.
+  using size_type = uint64_t;
+
+  /// Constructs a new SoundFontSharder using specified file.
+  /// @param file the SoundFont to split.
+  explicit SoundFontSharder(const SoundFont & file);
+
+  /// Returns the SoundFont to split.
+  /// @return the SoundFont to split.
+  const SoundFont & file() const noexcept {
+    return *file_;
+  }
+
+  /// Splits the SoundFont.
+  /// @return the shards, in the order of their presets in the original SoundFont.
+  /// @throws std::length_error A preset, or an instrument or a sample that no
+  /// preset refers to, does not fit in a file by itself.
+  /// @throws std::out_of_range A zone points to an element that is not in the file.
+  std::vector<SoundFont> Split();
+
+  /// Returns the name of a shard file.
+  /// @param filename the name of the SoundFont file, such as "bank.sf2".
+  /// @param shard_index the index of the shard.
+  /// @return the name of the shard file, such as "bank-1.sf2" for the first shard.
+  static std::string ShardFilename(const std::string & filename, size_t shard_index);
+
+private:
+  /// The Usage struct represents the records and bytes used by a shard.
+  struct Usage {
+    /// Constructs a new empty Usage.
+    Usage() noexcept;
+
+    /// Adds the specified usage.
+    /// @param other the usage to add.
+    /// @return this usage.
+    Usage & operator+=(const Usage & other) noexcept;
+
+    /// The number of presets.
+    size_type num_presets;
+
+    /// The number of preset zones.
+    size_type num_preset_zones;
+
+    /// The number of preset modulators.
+    size_type num_preset_modulators;
+
+    /// The number of preset generators.
+    size_type num_preset_generators;
+
+    /// The number of instruments.
+    size_type num_instruments;
+
+    /// The number of instrument zones.
+    size_type num_instrument_zones;
+
+    /// The number of instrument modulators.
+    size_type num_instrument_modulators;
+
+    /// The number of instrument generators.
+    size_type num_instrument_generators;
+
+    /// The number of samples.
+    size_type num_samples;
+
+    /// The size of the sample pool, in terms of bytes.
+    size_type sample_pool_size;
+  };
+
+  /// The Shard struct represents the planned contents of a shard.
+  struct Shard {
+    /// The indices of the presets.
+    std::vector<size_t> presets;
+
+    /// The indices of the instruments.
+    std::vector<size_t> instruments;
+
+    /// The indices of the samples.
+    std::vector<size_t> samples;
+
+    /// The records and bytes used by the shard.
+    Usage usage;
+  };
+
+  /// Measures what a preset adds to a shard, and assigns its new elements to the shard.
+  /// @param preset the preset.
+  /// @param shard_index the index of the shard.
+  /// @param shard the shard, which receives the indices of the new elements.
+  /// @return the records and bytes added by the preset.
+  /// @throws std::out_of_range A zone points to an element that is not in the file.
+  Usage AddPreset(const SFPreset & preset, size_t shard_index, Shard & shard);
+
+  /// Assigns an instrument and its samples to a shard, unless already assigned.
+  /// @param instrument the instrument.
+  /// @param shard_index the index of the shard.
+  /// @param shard the shard, which receives the indices of the new elements.
+  /// @param usage the usage, which receives the records and bytes of the new elements.
+  /// @throws std::out_of_range A zone points to a sample that is not in the file.
+  void AddInstrument(const SFInstrument & instrument,
+      size_t shard_index,
+      Shard & shard,
+      Usage & usage);
+
+  /// Assigns a sample and its linked samples to a shard, unless already assigned.
+  /// @param sample the sample.
+  /// @param shard_index the index of the shard.
+  /// @param shard the shard, which receives the indices of the new samples.
+  /// @param usage the usage, which receives the records and bytes of the new samples.
+  /// @throws std::out_of_range The sample is not in the file.
+  void AddSample(const std::shared_ptr<SFSample> & sample,
+      size_t shard_index,
+      Shard & shard,
+      Usage & usage);
+
+  /// Assigns an element that no preset refers to to the last shard, or to a new shard if it is full.
+  /// @param shards the shards planned so far.
+  /// @param description the kind and the name of the element, for the error message.
+  /// @param add the function that assigns the element to a shard, called
+  /// with the shard index, the shard and the usage to add to.
+  /// @throws std::length_error The element does not fit in a file by itself.
+  template <typename Function>
+  void AddUnreferenced(std::vector<Shard> & shards,
+      const std::string & description,
+      Function add);
+
+  /// Returns true if the specified usage fits in a file.
+  /// @param usage the records and bytes used by a shard.
+  /// @return true if the usage is within every limit of a SoundFont file.
+  bool Fits(const Usage & usage) const noexcept;
+
+  /// Builds a shard.
+  /// @param shard the planned contents of the shard.
+  /// @return the shard.
+  SoundFont MakeShard(Shard & shard);
+
+  /// Copies the INFO fields of the SoundFont.
+  /// @param shard the SoundFont that receives the fields.
+  void CopyInfo(SoundFont & shard) const;
+
+  /// Returns true if the specified sample belongs to the SoundFont.
+  /// @param sample the sample.
+  /// @return true if the sample is in the sample list of the SoundFont.
+  bool Contains(const SFSample & sample) const noexcept;
+
+  /// Returns true if the specified instrument belongs to the SoundFont.
+  /// @param instrument the instrument.
+  /// @return true if the instrument is in the instrument list of the SoundFont.
+  bool Contains(const SFInstrument & instrument) const noexcept;
+
+  /// The SoundFont to split.
+  const SoundFont * file_;
+
+  /// The size of a file without presets, instruments and samples, in terms of bytes.
+  size_type empty_file_size_;
+
+  /// The index of the last shard that each instrument is assigned to.
+  std::vector<size_t> instrument_shards_;
+
+  /// The index of the last shard that each sample is assigned to.
+  std::vector<size_t> sample_shards_;
+
+  /// The copies of the instruments in the shard being built, indexed like the original list.
+  std::vector<std::shared_ptr<SFInstrument>> instrument_copies_;
+
+  /// The copies of the samples in the shard being built, indexed like the original list.
+  std::vector<std::shared_ptr<SFSample>> sample_copies_;
+};
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_FILE_SHARDER_HPP_
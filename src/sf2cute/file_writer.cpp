@@ -7,14 +7,22 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 #include <unordered_map>
 #include <fstream>
+#include <sstream>
 #include <stdexcept>
+#include <thread>
+#include <exception>
 
 #include <sf2cute/file.hpp>
+#include <sf2cute/sample.hpp>
 
 #include "byteio.hpp"
 #include "riff.hpp"
+#include "file_layout.hpp"
+#include "parallel.hpp"
+#include "positional_file.hpp"
 #include "riff_smpl_chunk.hpp"
 #include "riff_phdr_chunk.hpp"
 #include "riff_pbag_chunk.hpp"
@@ -38,8 +46,19 @@ SoundFontWriter::SoundFontWriter(const SoundFont & file) :
     file_(&file) {
 }
 
+/// Constructs a new SoundFontWriter using specified file and options.
+SoundFontWriter::SoundFontWriter(const SoundFont & file, SFWriteOptions options) :
+    file_(&file),
+    options_(std::move(options)) {
+}
+
 /// Writes the SoundFont to a file.
 void SoundFontWriter::Write(const std::string & filename) {
+  if (options().positional_write && PositionalFile::IsSupported()) {
+    WritePositional(filename, ResolveNumThreads(options().num_threads));
+    return;
+  }
+
   std::ofstream out;
 
   out.exceptions(std::ios::badbit | std::ios::failbit);
@@ -50,11 +69,16 @@ void SoundFontWriter::Write(const std::string & filename) {
 
 /// Writes the SoundFont to an output stream.
 void SoundFontWriter::Write(std::ostream & out) {
-  RIFF riff("sfbk");
-  riff.AddChunk(MakeInfoListChunk());
-  riff.AddChunk(MakeSdtaListChunk());
-  riff.AddChunk(MakePdtaListChunk());
-  riff.Write(out);
+  SoundFontLayout layout;
+  const std::unique_ptr<RIFF> riff = MakeRIFF(layout);
+
+  const unsigned int num_threads = ResolveNumThreads(options().num_threads);
+  if (num_threads > 1) {
+    WriteParallel(*riff, out, num_threads);
+  }
+  else {
+    riff->Write(out);
+  }
 }
 
 /// Writes the SoundFont to an output stream.
@@ -62,13 +86,223 @@ void SoundFontWriter::Write(std::ostream && out) {
   Write(out);
 }
 
+/// Returns the length of the SoundFont file.
+size_t SoundFontWriter::GetWriteSize() {
+  SoundFontLayout layout;
+  return MakeRIFF(layout)->size();
+}
+
+/// Writes the SoundFont to a buffer.
+size_t SoundFontWriter::WriteTo(char * buffer, size_t size) {
+  SoundFontLayout layout;
+  const std::unique_ptr<RIFF> riff = MakeRIFF(layout);
+  if (riff->size() > size) {
+    throw std::length_error("The buffer is too small for the SoundFont.");
+  }
+
+  riff->WriteTo(buffer);
+  return riff->size();
+}
+
+/// Writes the SoundFont to a new vector.
+std::vector<char> SoundFontWriter::WriteToVector() {
+  SoundFontLayout layout;
+  const std::unique_ptr<RIFF> riff = MakeRIFF(layout);
+
+  // The size is exact, so the vector is allocated once and never grows.
+  std::vector<char> buffer(riff->size());
+  riff->WriteTo(buffer.data());
+  return buffer;
+}
+
+/// Writes a RIFF structure, serializing the pdta subchunks in parallel.
+void SoundFontWriter::WriteParallel(const RIFF & riff, std::ostream & out, unsigned int num_threads) {
+  // The last chunk is the pdta chunk, whose subchunks are independent.
+  const RIFFListChunk & pdta = static_cast<const RIFFListChunk &>(*riff.chunks().back());
+  const auto & subchunks = pdta.subchunks();
+  std::vector<std::vector<char>> buffers(subchunks.size());
+
+  // Serialize the subchunks on the worker threads, while the calling
+  // thread writes the preceding chunks including the sample pool.
+  std::exception_ptr error;
+  std::thread serializer([&]() {
+    try {
+      ParallelFor(subchunks.size(), num_threads - 1, [&](size_t index) {
+        buffers[index].resize(subchunks[index]->size());
+        subchunks[index]->WriteTo(buffers[index].data());
+      });
+    }
+    catch (...) {
+      error = std::current_exception();
+    }
+  });
+
+  // Save exception bits of output stream.
+  const std::ios_base::iostate old_exception_bits = out.exceptions();
+
+  try {
+    // Set exception bits to get output error as an exception.
+    out.exceptions(std::ios::badbit | std::ios::failbit);
+
+    // Write the RIFF header and the chunks before the pdta chunk.
+    RIFF::WriteHeader(out, riff.name(), riff.size() - 8);
+    for (size_t index = 0; index + 1 < riff.chunks().size(); index++) {
+      riff.chunks()[index]->Write(out);
+    }
+  }
+  catch (...) {
+    // The serializer must be joined before it is destroyed, whatever was thrown.
+    serializer.join();
+
+    // Recover exception bits of output stream.
+    out.exceptions(old_exception_bits);
+
+    // Rethrow the exception.
+    throw;
+  }
+
+  // Splice the serialized subchunks in order.
+  serializer.join();
+  try {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+
+    RIFFListChunk::WriteHeader(out, pdta.name(), pdta.size() - 8);
+    for (const auto & buffer : buffers) {
+      out.write(buffer.data(), std::streamsize(buffer.size()));
+    }
+  }
+  catch (...) {
+    // Recover exception bits of output stream.
+    out.exceptions(old_exception_bits);
+
+    // Rethrow the exception.
+    throw;
+  }
+
+  // Recover exception bits of output stream.
+  out.exceptions(old_exception_bits);
+}
+
+/// Writes the SoundFont to a file with positional writes.
+void SoundFontWriter::WritePositional(const std::string & filename, unsigned int num_threads) {
+  SoundFontLayout layout;
+  const std::unique_ptr<RIFF> riff = MakeRIFF(layout);
+
+  // The file is zero-filled, so the terminator samples and the padding
+  // bytes need not be written.
+  const std::unique_ptr<PositionalFile> file = PositionalFile::Create(filename, riff->size());
+
+  const RIFFListChunk & sdta = static_cast<const RIFFListChunk &>(*riff->chunks()[1]);
+  const RIFFListChunk & pdta = static_cast<const RIFFListChunk &>(*riff->chunks()[2]);
+  const SFRIFFSmplChunk & smpl = static_cast<const SFRIFFSmplChunk &>(*sdta.subchunks().front());
+
+  // Split the sample pool into slices of at most kSliceLength datapoints.
+  // An encoded sample is written as a single slice.
+  constexpr size_t kSliceLength = 1024 * 1024;
+  struct Slice {
+    const SFSampleData * data;
+    size_t start;
+    size_t length;
+    PositionalFile::size_type offset;
+    const std::vector<char> * stream;
+  };
+  std::vector<Slice> slices;
+  PositionalFile::size_type sample_offset = layout.chunk_location("smpl").offset + 8;
+  if (smpl.encoded_samples() != nullptr) {
+    for (const auto & stream : *smpl.encoded_samples()) {
+      slices.push_back(Slice{ nullptr, 0, 0, sample_offset, &stream });
+      sample_offset += stream.size();
+    }
+  }
+  else {
+    for (const auto & sample : smpl.samples()) {
+      const SFSampleData & data = sample->data();
+      for (size_t start = 0; start < data.size(); start += kSliceLength) {
+        const size_t length = std::min(data.size() - start, kSliceLength);
+        slices.push_back(Slice{ &data, start, length, sample_offset + sizeof(int16_t) * start, nullptr });
+      }
+      sample_offset += sizeof(int16_t) * (data.size() + SFSample::kTerminatorSampleLength);
+    }
+  }
+
+  // Task 0 writes the headers, the next tasks write each pdta subchunk,
+  // and the rest write each slice of the sample pool.
+  const size_t num_subchunks = pdta.subchunks().size();
+  ParallelFor(1 + num_subchunks + slices.size(), num_threads, [&](size_t index) {
+    if (index == 0) {
+      std::ostringstream headers;
+      RIFF::WriteHeader(headers, riff->name(), riff->size() - 8);
+      riff->chunks()[0]->Write(headers);
+      RIFFListChunk::WriteHeader(headers, sdta.name(), sdta.size() - 8);
+      RIFFChunk::WriteHeader(headers, smpl.name(), smpl.data_size());
+      const std::string data = headers.str();
+
+      // The RIFF header and INFO chunk are followed by the sdta and smpl headers.
+      const size_t info_end = 12 + riff->chunks()[0]->size();
+      file->WriteAt(data.data(), info_end, 0);
+      file->WriteAt(data.data() + info_end, data.size() - info_end,
+        layout.chunk_location("sdta").offset);
+
+      headers.str(std::string());
+      RIFFListChunk::WriteHeader(headers, pdta.name(), pdta.size() - 8);
+      file->WriteAt(headers.str().data(), 12, layout.chunk_location("pdta").offset);
+    }
+    else if (index <= num_subchunks) {
+      const RIFFChunkInterface & subchunk = *pdta.subchunks()[index - 1];
+      std::vector<char> data(subchunk.size());
+      subchunk.WriteTo(data.data());
+      file->WriteAt(data.data(), data.size(), layout.chunk_location(subchunk.name()).offset);
+    }
+    else {
+      const Slice & slice = slices[index - 1 - num_subchunks];
+      if (slice.stream != nullptr) {
+        file->WriteAt(slice.stream->data(), slice.stream->size(), slice.offset);
+      }
+      else if (IsLittleEndianHost() && !slice.data->is_streamed()) {
+        file->WriteAt(slice.data->data() + slice.start, sizeof(int16_t) * slice.length, slice.offset);
+      }
+      else {
+        // Streamed slices are pulled into a buffer of a slice at most.
+        std::vector<int16_t> buffer(slice.length);
+        slice.data->Read(slice.start, buffer.data(), slice.length);
+        if (!IsLittleEndianHost()) {
+          for (size_t datapoint = 0; datapoint < slice.length; datapoint++) {
+            const uint16_t value = static_cast<uint16_t>(buffer[datapoint]);
+            buffer[datapoint] = static_cast<int16_t>((value >> 8) | (value << 8));
+          }
+        }
+        file->WriteAt(buffer.data(), sizeof(int16_t) * slice.length, slice.offset);
+      }
+    }
+  });
+}
+
+/// Plans the layout of the SoundFont and builds its RIFF structure.
+std::unique_ptr<RIFF> SoundFontWriter::MakeRIFF(SoundFontLayout & layout) {
+  // Walk the object graph once to count every record.
+  layout = SoundFontLayout(file(), options());
+
+  // Build the chunks from the planned counts, and locate them.
+  std::unique_ptr<RIFF> riff = std::make_unique<RIFF>("sfbk");
+  riff->AddChunk(MakeInfoListChunk());
+  riff->AddChunk(MakeSdtaListChunk(layout));
+  riff->AddChunk(MakePdtaListChunk(layout));
+  layout.Locate(*riff);
+  return riff;
+}
+
 /// Make an INFO chunk.
 std::unique_ptr<RIFFChunkInterface> SoundFontWriter::MakeInfoListChunk() {
   std::unique_ptr<RIFFListChunk> info = std::make_unique<RIFFListChunk>("INFO");
 
   // Mandatory chunks:
 
-  info->AddSubchunk(MakeVersionChunk("ifil", SFVersionTag(2, 1)));
+  // An SF3 file has compressed samples.
+  const SFVersionTag version = options().sample_encoder != nullptr ?
+      SFVersionTag(3, 1) : SFVersionTag(2, 1);
+  info->AddSubchunk(MakeVersionChunk("ifil", version));
 
   info->AddSubchunk(MakeZSTRChunk("isng", file().sound_engine().substr(0, SoundFont::kInfoTextMaxLength)));
 
@@ -112,37 +346,47 @@ std::unique_ptr<RIFFChunkInterface> SoundFontWriter::MakeInfoListChunk() {
 }
 
 /// Make a sdta chunk.
-std::unique_ptr<RIFFChunkInterface> SoundFontWriter::MakeSdtaListChunk() {
+std::unique_ptr<RIFFChunkInterface> SoundFontWriter::MakeSdtaListChunk(const SoundFontLayout & layout) {
   std::unique_ptr<RIFFListChunk> sdta = std::make_unique<RIFFListChunk>("sdta");
-  sdta->AddSubchunk(std::make_unique<SFRIFFSmplChunk>(file().samples()));
+  const auto & samples = layout.deduplicates_samples() ? layout.pooled_samples() : file().samples();
+  std::unique_ptr<SFRIFFSmplChunk> smpl =
+    std::make_unique<SFRIFFSmplChunk>(samples, layout.sample_pool_size());
+  if (layout.encodes_samples()) {
+    smpl->set_encoded_samples(&layout.encoded_samples());
+  }
+  sdta->AddSubchunk(std::move(smpl));
   return std::move(sdta);
 }
 
 /// Make a pdta chunk.
-std::unique_ptr<RIFFChunkInterface> SoundFontWriter::MakePdtaListChunk() {
-  // Constructs a map for indexing each instruments.
-  std::unordered_map<const SFInstrument *, uint16_t> instrument_index_map;
-  for (uint16_t index = 0; index < file().instruments().size(); index++) {
-    instrument_index_map.insert(std::make_pair(file().instruments().at(index).get(), index));
-  }
-
-  // Constructs a map for indexing each samples.
-  std::unordered_map<const SFSample *, uint16_t> sample_index_map;
-  for (uint16_t index = 0; index < file().samples().size(); index++) {
-    sample_index_map.insert(std::make_pair(file().samples().at(index).get(), index));
-  }
-
+std::unique_ptr<RIFFChunkInterface> SoundFontWriter::MakePdtaListChunk(const SoundFontLayout & layout) {
   // Constructs the pdta chunk and its subchunks.
   std::unique_ptr<RIFFListChunk> pdta = std::make_unique<RIFFListChunk>("pdta");
-  pdta->AddSubchunk(std::make_unique<SFRIFFPhdrChunk>(file().presets()));
-  pdta->AddSubchunk(std::make_unique<SFRIFFPbagChunk>(file().presets()));
-  pdta->AddSubchunk(std::make_unique<SFRIFFPmodChunk>(file().presets()));
-  pdta->AddSubchunk(std::make_unique<SFRIFFPgenChunk>(file().presets(), instrument_index_map));
-  pdta->AddSubchunk(std::make_unique<SFRIFFInstChunk>(file().instruments()));
-  pdta->AddSubchunk(std::make_unique<SFRIFFIbagChunk>(file().instruments()));
-  pdta->AddSubchunk(std::make_unique<SFRIFFImodChunk>(file().instruments()));
-  pdta->AddSubchunk(std::make_unique<SFRIFFIgenChunk>(file().instruments(), sample_index_map));
-  pdta->AddSubchunk(std::make_unique<SFRIFFShdrChunk>(file().samples(), sample_index_map));
+  pdta->AddSubchunk(std::make_unique<SFRIFFPhdrChunk>(file().presets(),
+    layout.num_preset_items()));
+  pdta->AddSubchunk(std::make_unique<SFRIFFPbagChunk>(file().presets(),
+    layout.num_preset_zone_items()));
+  pdta->AddSubchunk(std::make_unique<SFRIFFPmodChunk>(file().presets(),
+    layout.num_preset_modulator_items()));
+  pdta->AddSubchunk(std::make_unique<SFRIFFPgenChunk>(file().presets(),
+    file().instruments(), layout.num_preset_generator_items()));
+  pdta->AddSubchunk(std::make_unique<SFRIFFInstChunk>(file().instruments(),
+    layout.num_instrument_items()));
+  pdta->AddSubchunk(std::make_unique<SFRIFFIbagChunk>(file().instruments(),
+    layout.num_instrument_zone_items()));
+  pdta->AddSubchunk(std::make_unique<SFRIFFImodChunk>(file().instruments(),
+    layout.num_instrument_modulator_items()));
+  pdta->AddSubchunk(std::make_unique<SFRIFFIgenChunk>(file().instruments(),
+    file().samples(), layout.num_instrument_generator_items()));
+  std::unique_ptr<SFRIFFShdrChunk> shdr = std::make_unique<SFRIFFShdrChunk>(file().samples(),
+    layout.num_sample_items());
+  if (layout.deduplicates_samples() || layout.encodes_samples()) {
+    shdr->set_sample_starts(&layout.sample_starts());
+  }
+  if (layout.encodes_samples()) {
+    shdr->set_sample_ends(&layout.sample_ends());
+  }
+  pdta->AddSubchunk(std::move(shdr));
   return std::move(pdta);
 }
 
@@ -6,13 +6,16 @@
 #ifndef SF2CUTE_FILE_WRITER_HPP_
 #define SF2CUTE_FILE_WRITER_HPP_
 
+#include <stddef.h>
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <vector>
 #include <ostream>
 
 #include <sf2cute/types.hpp>
 #include <sf2cute/modulator.hpp>
+#include <sf2cute/write_options.hpp>
 
 namespace sf2cute {
 
@@ -24,6 +27,8 @@ class SFPreset;
 class SoundFont;
 
 class RIFFChunkInterface;
+class RIFF;
+class SoundFontLayout;
 
 /// The SoundFontWriter class represents a SoundFont writer.
 class SoundFontWriter {
@@ -35,6 +40,11 @@ public:
   /// @param file the input SoundFont object.
   SoundFontWriter(const SoundFont & file);
 
+  /// Constructs a new SoundFontWriter using specified file and options.
+  /// @param file the input SoundFont object.
+  /// @param options the options for writing.
+  SoundFontWriter(const SoundFont & file, SFWriteOptions options);
+
   /// Constructs a new copy of specified SoundFontWriter.
   /// @param origin a SoundFontWriter object.
   SoundFontWriter(const SoundFontWriter & origin) = default;
@@ -66,6 +76,18 @@ public:
     file_ = &file;
   }
 
+  /// Returns the options for writing.
+  /// @return the options for writing.
+  const SFWriteOptions & options() const noexcept {
+    return options_;
+  }
+
+  /// Sets the options for writing.
+  /// @param options the options for writing.
+  void set_options(SFWriteOptions options) noexcept {
+    options_ = std::move(options);
+  }
+
   /// Writes the SoundFont to a file.
   /// @param filename the name of the file to write to.
   void Write(const std::string & filename);
@@ -77,18 +99,53 @@ public:
   /// @copydoc SoundFontWriter::Write(std::ostream &)
   void Write(std::ostream && out);
 
+  /// Returns the length of the SoundFont file.
+  /// @return the length of the file, in terms of bytes.
+  /// @throws std::length_error The SoundFont has too many elements for a SoundFont file.
+  size_t GetWriteSize();
+
+  /// Writes the SoundFont to a buffer.
+  /// @param buffer a pointer to the buffer to write to.
+  /// @param size the length of the buffer, in terms of bytes.
+  /// @return the length of the written file, in terms of bytes.
+  /// @throws std::length_error The buffer is too small for the file.
+  size_t WriteTo(char * buffer, size_t size);
+
+  /// Writes the SoundFont to a new vector.
+  /// @return the file image.
+  std::vector<char> WriteToVector();
+
+  /// Plans the layout of the SoundFont and builds its RIFF structure.
+  /// @param layout the layout to be planned.
+  /// @return the RIFF structure, ready to be written.
+  /// @throws std::length_error The SoundFont has too many elements for a SoundFont file.
+  std::unique_ptr<RIFF> MakeRIFF(SoundFontLayout & layout);
+
 private:
+  /// Writes a RIFF structure, serializing the pdta subchunks in parallel.
+  /// @param riff the RIFF structure built by MakeRIFF.
+  /// @param out the output stream to write to.
+  /// @param num_threads the number of threads.
+  static void WriteParallel(const RIFF & riff, std::ostream & out, unsigned int num_threads);
+
+  /// Writes the SoundFont to a file with positional writes.
+  /// @param filename the name of the file to write to.
+  /// @param num_threads the number of threads.
+  void WritePositional(const std::string & filename, unsigned int num_threads);
+
   /// Make an INFO chunk.
   /// @return the INFO chunk.
   std::unique_ptr<RIFFChunkInterface> MakeInfoListChunk();
 
   /// Make a sdta chunk.
+  /// @param layout the planned layout.
   /// @return the sdta chunk.
-  std::unique_ptr<RIFFChunkInterface> MakeSdtaListChunk();
+  std::unique_ptr<RIFFChunkInterface> MakeSdtaListChunk(const SoundFontLayout & layout);
 
   /// Make a pdta chunk.
+  /// @param layout the planned layout.
   /// @return the pdta chunk.
-  std::unique_ptr<RIFFChunkInterface> MakePdtaListChunk();
+  std::unique_ptr<RIFFChunkInterface> MakePdtaListChunk(const SoundFontLayout & layout);
 
   /// Make a chunk with a version number.
   /// @param name the name of the chunk.
@@ -102,6 +159,9 @@ private:
 
   /// The input SoundFont object.
   const SoundFont * file_;
+
+  /// The options for writing.
+  SFWriteOptions options_;
 };
 
 } // namespace sf2cute
@@ -0,0 +1,65 @@
+/// @file
+/// SoundFont 2 Generator set class implementation.
+///
+/// @author gocha <https://github.com/gocha>
+
+#include <sf2cute/generator_set.hpp>
+
+#include <stdint.h>
+#include <array>
+#include <stdexcept>
+
+namespace sf2cute {
+
+/// The generator types in the order required by the generator chunk.
+///
+/// keyRange and velRange come first, instrument and sampleID come last,
+/// and the rest follow in ascending order (see SFGeneratorItem::Compare).
+const std::array<uint8_t, SFGeneratorSet::kCapacity> SFGeneratorSet::kCanonicalOrder{ {
+  43, 44, 0, 1, 2, 3, 4, 5, 6, 7,
+  8, 9, 10, 11, 12, 13, 14, 15, 16, 17,
+  18, 19, 20, 21, 22, 23, 24, 25, 26, 27,
+  28, 29, 30, 31, 32, 33, 34, 35, 36, 37,
+  38, 39, 40, 42, 45, 46, 47, 48, 49, 50,
+  51, 52, 54, 55, 56, 57, 58, 59, 41, 53
+} };
+
+/// The position of each generator type in kCanonicalOrder.
+const std::array<uint8_t, SFGeneratorSet::kCapacity> SFGeneratorSet::kCanonicalPosition{ {
+  2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+  12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
+  22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+  32, 33, 34, 35, 36, 37, 38, 39, 40, 41,
+  42, 58, 43, 0, 1, 44, 45, 46, 47, 48,
+  49, 50, 51, 59, 52, 53, 54, 55, 56, 57
+} };
+
+/// Constructs a new empty SFGeneratorSet.
+SFGeneratorSet::SFGeneratorSet() noexcept :
+    mask_(0) {
+}
+
+/// Returns the number of generators.
+SFGeneratorSet::size_type SFGeneratorSet::size() const noexcept {
+#if defined(__GNUC__)
+  return static_cast<size_type>(__builtin_popcountll(mask_));
+#else
+  size_type count = 0;
+  for (uint64_t mask = mask_; mask != 0; mask &= mask - 1) {
+    count++;
+  }
+  return count;
+#endif
+}
+
+/// Sets a generator, overwriting an existing generator of the same type.
+void SFGeneratorSet::Set(const SFGeneratorItem & generator) {
+  if (!IsValid(generator.op())) {
+    throw std::invalid_argument("Unknown generator type.");
+  }
+
+  mask_ |= Bit(generator.op());
+  amounts_[static_cast<size_type>(generator.op())] = generator.amount();
+}
+
+} // namespace sf2cute
@@ -19,13 +19,15 @@ namespace sf2cute {
 
 /// Constructs a new empty instrument.
 SFInstrument::SFInstrument() :
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
 }
 
 /// Constructs a new empty SFInstrument using the specified name.
 SFInstrument::SFInstrument(std::string name) :
     name_(std::move(name)),
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
 }
 
 /// Constructs a new SFInstrument using the specified name and zones.
@@ -34,7 +36,8 @@ SFInstrument::SFInstrument(std::string name,
     name_(std::move(name)),
     zones_(),
     global_zone_(nullptr),
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
   // Set instrument zones.
   zones_.reserve(zones.size());
   for (auto && zone : zones) {
@@ -52,7 +55,8 @@ SFInstrument::SFInstrument(std::string name,
     name_(std::move(name)),
     zones_(),
     global_zone_(std::make_unique<SFInstrumentZone>(std::move(global_zone))),
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
   // Set instrument zones.
   zones_.reserve(zones.size());
   for (auto && zone : zones) {
@@ -68,7 +72,8 @@ SFInstrument::SFInstrument(const SFInstrument & origin) :
     name_(origin.name_),
     zones_(),
     global_zone_(nullptr),
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
   // Copy global zone.
   if (origin.has_global_zone()) {
     global_zone_ = std::make_unique<SFInstrumentZone>(origin.global_zone());
@@ -99,9 +104,15 @@ SFInstrument & SFInstrument::operator=(const SFInstrument & origin) {
     zones_.push_back(std::make_unique<SFInstrumentZone>(*zone));
   }
 
-  // Copy other fields.
-  name_ = origin.name_;
-  parent_file_ = nullptr;
+  // Copy other fields. The instrument stays in its file, under the new name.
+  std::string name = origin.name_;
+  if (parent_file_ != nullptr) {
+    parent_file_->UnindexElement(*this);
+  }
+  name_ = std::move(name);
+  if (parent_file_ != nullptr) {
+    parent_file_->IndexElement(*this);
+  }
 
   // Repair references.
   SetBackwardReferences();
@@ -114,17 +125,23 @@ SFInstrument::SFInstrument(SFInstrument && origin) noexcept :
     name_(std::move(origin.name_)),
     zones_(std::move(origin.zones_)),
     global_zone_(std::move(origin.global_zone_)),
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
   SetBackwardReferences();
 }
 
 /// Move-assigns a new value to the SFInstrument, replacing its current contents.
 SFInstrument & SFInstrument::operator=(SFInstrument && origin) noexcept {
-  // Copy fields.
+  // Copy fields. The instrument stays in its file, under the new name.
+  if (parent_file_ != nullptr) {
+    parent_file_->UnindexElement(*this);
+  }
   name_ = std::move(origin.name_);
   zones_ = std::move(origin.zones_);
   global_zone_ = std::move(origin.global_zone_);
-  parent_file_ = nullptr;
+  if (parent_file_ != nullptr) {
+    parent_file_->IndexElement(*this);
+  }
 
   // Repair references.
   SetBackwardReferences();
@@ -132,6 +149,17 @@ SFInstrument & SFInstrument::operator=(SFInstrument && origin) noexcept {
   return *this;
 }
 
+/// Sets the name of this instrument.
+void SFInstrument::set_name(std::string name) {
+  if (parent_file_ != nullptr) {
+    parent_file_->UnindexElement(*this);
+  }
+  name_ = std::move(name);
+  if (parent_file_ != nullptr) {
+    parent_file_->IndexElement(*this);
+  }
+}
+
 /// Adds an instrument zone to the instrument.
 void SFInstrument::AddZone(SFInstrumentZone zone) {
   // Check the parent instrument of the zone.
@@ -156,7 +184,8 @@ void SFInstrument::AddZone(SFInstrumentZone zone) {
     }
   }
 
-  // Add the zone to the list.
+  // Add the zone to the list, from the arena of the parent file if any.
+  SFArena::Scope scope(has_parent_file() ? parent_file().arena() : SFArena::current());
   zones_.push_back(std::make_unique<SFInstrumentZone>(std::move(zone)));
 }
 
@@ -192,6 +221,7 @@ void SFInstrument::set_global_zone(SFInstrumentZone global_zone) {
   global_zone.set_parent_instrument(*this);
 
   // Set the global zone to this instrument.
+  SFArena::Scope scope(has_parent_file() ? parent_file().arena() : SFArena::current());
   global_zone_ = std::make_unique<SFInstrumentZone>(std::move(global_zone));
 }
 
@@ -0,0 +1,158 @@
+/// @file
+/// Read-only memory-mapped file class implementation.
+///
+/// @author gocha <https://github.com/gocha>
+
+#include "mapped_file.hpp"
+
+#include <stddef.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ios>
+#include <fstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SF2CUTE_HAVE_MMAP
+#endif
+
+namespace sf2cute {
+
+/// Constructs a new empty MappedFile.
+MappedFile::MappedFile() noexcept :
+    data_(nullptr),
+    size_(0),
+    handle_(nullptr) {
+}
+
+#if defined(_WIN32)
+
+/// Maps the specified file into memory.
+std::shared_ptr<MappedFile> MappedFile::Open(const std::string & filename) {
+  std::shared_ptr<MappedFile> file(new MappedFile());
+
+  HANDLE file_handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+    nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file_handle == INVALID_HANDLE_VALUE) {
+    throw std::ios_base::failure("Unable to open \"" + filename + "\".");
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file_handle, &size)) {
+    CloseHandle(file_handle);
+    throw std::ios_base::failure("Unable to get the size of \"" + filename + "\".");
+  }
+
+  // An empty file cannot be mapped, and needs no mapping.
+  if (size.QuadPart != 0) {
+    HANDLE mapping = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file_handle);
+    if (mapping == nullptr) {
+      throw std::ios_base::failure("Unable to map \"" + filename + "\".");
+    }
+
+    const void * view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+      CloseHandle(mapping);
+      throw std::ios_base::failure("Unable to map \"" + filename + "\".");
+    }
+
+    file->data_ = static_cast<const char *>(view);
+    file->size_ = static_cast<size_type>(size.QuadPart);
+    file->handle_ = mapping;
+  }
+  else {
+    CloseHandle(file_handle);
+  }
+
+  return file;
+}
+
+/// Unmaps the file.
+MappedFile::~MappedFile() {
+  if (handle_ != nullptr) {
+    UnmapViewOfFile(data_);
+    CloseHandle(static_cast<HANDLE>(handle_));
+  }
+}
+
+#elif defined(SF2CUTE_HAVE_MMAP)
+
+/// Maps the specified file into memory.
+std::shared_ptr<MappedFile> MappedFile::Open(const std::string & filename) {
+  std::shared_ptr<MappedFile> file(new MappedFile());
+
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw std::ios_base::failure("Unable to open \"" + filename + "\".");
+  }
+
+  struct stat status;
+  if (fstat(fd, &status) != 0) {
+    close(fd);
+    throw std::ios_base::failure("Unable to get the size of \"" + filename + "\".");
+  }
+
+  // An empty file cannot be mapped, and needs no mapping.
+  if (status.st_size != 0) {
+    void * view = mmap(nullptr, static_cast<size_t>(status.st_size),
+      PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) {
+      throw std::ios_base::failure("Unable to map \"" + filename + "\".");
+    }
+
+    file->data_ = static_cast<const char *>(view);
+    file->size_ = static_cast<size_type>(status.st_size);
+    file->handle_ = view;
+  }
+  else {
+    close(fd);
+  }
+
+  return file;
+}
+
+/// Unmaps the file.
+MappedFile::~MappedFile() {
+  if (handle_ != nullptr) {
+    munmap(handle_, size_);
+  }
+}
+
+#else
+
+/// Maps the specified file into memory.
+std::shared_ptr<MappedFile> MappedFile::Open(const std::string & filename) {
+  std::shared_ptr<MappedFile> file(new MappedFile());
+
+  std::ifstream in;
+  in.exceptions(std::ios::badbit | std::ios::failbit);
+  in.open(filename, std::ios::binary);
+
+  // Load the whole file at once.
+  in.seekg(0, std::ios::end);
+  const std::streamoff size = in.tellg();
+  in.seekg(0, std::ios::beg);
+
+  file->buffer_.resize(static_cast<size_type>(size));
+  in.read(file->buffer_.data(), std::streamsize(file->buffer_.size()));
+
+  file->data_ = file->buffer_.data();
+  file->size_ = file->buffer_.size();
+  return file;
+}
+
+/// Unmaps the file.
+MappedFile::~MappedFile() {
+}
+
+#endif
+
+} // namespace sf2cute
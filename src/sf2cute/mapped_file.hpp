@@ -0,0 +1,68 @@
+/// @file
+/// Read-only memory-mapped file class header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_MAPPED_FILE_HPP_
+#define SF2CUTE_MAPPED_FILE_HPP_
+
+#include <stddef.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sf2cute {
+
+/// The MappedFile class represents a whole file mapped into memory for reading.
+///
+/// On platforms without memory-mapped file support, the file is loaded
+/// into a heap buffer instead, so that callers need no special handling.
+class MappedFile {
+public:
+  /// Unsigned integer type for the file size.
+  using size_type = size_t;
+
+  /// Maps the specified file into memory.
+  /// @param filename the name of the file to map.
+  /// @return the mapped file.
+  /// @throws std::ios_base::failure The file cannot be opened or mapped.
+  static std::shared_ptr<MappedFile> Open(const std::string & filename);
+
+  /// Unmaps the file.
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile & operator=(const MappedFile &) = delete;
+
+  /// Returns a pointer to the beginning of the file image.
+  /// @return a pointer to the beginning of the file image.
+  const char * data() const noexcept {
+    return data_;
+  }
+
+  /// Returns the length of the file image.
+  /// @return the length of the file image, in terms of bytes.
+  size_type size() const noexcept {
+    return size_;
+  }
+
+private:
+  /// Constructs a new empty MappedFile.
+  MappedFile() noexcept;
+
+  /// A pointer to the beginning of the file image.
+  const char * data_;
+
+  /// The length of the file image, in terms of bytes.
+  size_type size_;
+
+  /// The platform handle of the mapping, if any.
+  void * handle_;
+
+  /// The file image, when the file is loaded instead of mapped.
+  std::vector<char> buffer_;
+};
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_MAPPED_FILE_HPP_
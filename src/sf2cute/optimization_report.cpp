@@ -0,0 +1,144 @@
+/// @file
+/// SoundFont 2 Optimization report class implementation.
+///
+/// @author gocha <https://github.com/gocha>
+
+#include <sf2cute/optimization_report.hpp>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <stdexcept>
+
+namespace sf2cute {
+
+namespace {
+
+/// Writes the type and the amount of a generator, separated by a tab.
+/// @param out the output stream to write to.
+/// @param op the type of the generator.
+/// @param amount the amount of the generator.
+void WriteGenerator(std::ostream & out, SFGenerator op, GenAmountType amount) {
+  out << static_cast<uint16_t>(op) << '\t';
+  if (op == SFGenerator::kKeyRange || op == SFGenerator::kVelRange) {
+    out << unsigned(amount.range.lo) << '-' << unsigned(amount.range.hi);
+  }
+  else {
+    out << amount.value;
+  }
+}
+
+} // namespace
+
+/// Returns the number of generators removed from presets.
+size_t SFOptimizationReport::num_preset_generators() const noexcept {
+  return CountGenerators(Element::kPreset);
+}
+
+/// Returns the number of generators removed from instruments.
+size_t SFOptimizationReport::num_instrument_generators() const noexcept {
+  return CountGenerators(Element::kInstrument);
+}
+
+/// Returns the number of global zones removed.
+size_t SFOptimizationReport::num_global_zones() const noexcept {
+  size_t count = 0;
+  for (const auto & entry : entries_) {
+    if (entry.reason == Reason::kEmptyGlobalZone) {
+      count++;
+    }
+  }
+  return count;
+}
+
+/// Returns the number of records saved by every change.
+size_t SFOptimizationReport::num_records_saved() const noexcept {
+  size_t count = 0;
+  for (const auto & entry : entries_) {
+    count += entry.num_records;
+  }
+  return count;
+}
+
+/// Appends a change.
+void SFOptimizationReport::AddEntry(Entry entry) {
+  entries_.push_back(std::move(entry));
+}
+
+/// Writes the report as tab-separated text.
+void SFOptimizationReport::Write(std::ostream & out) const {
+  // Save exception bits of output stream.
+  const std::ios_base::iostate old_exception_bits = out.exceptions();
+  // Set exception bits to get output error as an exception.
+  out.exceptions(std::ios::badbit | std::ios::failbit);
+
+  try {
+    out << "element\tindex\tname\tzone\tgenerator\tamount\treason\trecords\n";
+    for (const auto & entry : entries_) {
+      out << (entry.element == Element::kPreset ? "preset" : "instrument") << '\t'
+        << entry.element_index << '\t' << entry.element_name << '\t';
+      if (entry.zone_index == kGlobalZone) {
+        out << "global";
+      }
+      else {
+        out << entry.zone_index;
+      }
+
+      switch (entry.reason) {
+      case Reason::kDefault:
+        out << '\t';
+        WriteGenerator(out, entry.op, entry.amount);
+        out << "\tdefault";
+        break;
+
+      case Reason::kGlobalZone:
+        out << '\t';
+        WriteGenerator(out, entry.op, entry.amount);
+        out << "\tglobal";
+        break;
+
+      case Reason::kEmptyGlobalZone:
+        out << "\t\t\tempty";
+        break;
+
+      case Reason::kHoistedGenerator:
+        out << '\t';
+        WriteGenerator(out, entry.op, entry.amount);
+        out << "\thoisted";
+        break;
+
+      case Reason::kHoistedModulator:
+        out << '\t' << static_cast<uint16_t>(entry.op) << '\t' << entry.amount.value << "\thoisted-modulator";
+        break;
+      }
+      out << '\t' << entry.num_records << '\n';
+    }
+  }
+  catch (const std::exception &) {
+    // Recover exception bits of output stream.
+    out.exceptions(old_exception_bits);
+
+    // Rethrow the exception.
+    throw;
+  }
+
+  // Recover exception bits of output stream.
+  out.exceptions(old_exception_bits);
+}
+
+/// Returns the number of removed generators of the specified kind of element.
+size_t SFOptimizationReport::CountGenerators(Element element) const noexcept {
+  size_t count = 0;
+  for (const auto & entry : entries_) {
+    if (entry.element == element &&
+        (entry.reason == Reason::kDefault || entry.reason == Reason::kGlobalZone)) {
+      count++;
+    }
+  }
+  return count;
+}
+
+} // namespace sf2cute
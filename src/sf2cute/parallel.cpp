@@ -0,0 +1,71 @@
+/// @file
+/// Parallel task helper implementation.
+///
+/// @author gocha <https://github.com/gocha>
+
+#include "parallel.hpp"
+
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace sf2cute {
+
+/// Returns the number of threads to be used for the specified request.
+unsigned int ResolveNumThreads(unsigned int num_threads) noexcept {
+  if (num_threads == 0) {
+    num_threads = std::thread::hardware_concurrency();
+  }
+  return num_threads != 0 ? num_threads : 1;
+}
+
+/// Runs tasks on a pool of threads, and waits for all of them.
+void ParallelFor(size_t num_tasks,
+    unsigned int num_threads,
+    const std::function<void(size_t)> & task) {
+  std::vector<std::exception_ptr> errors(num_tasks);
+  std::atomic<size_t> next_task(0);
+
+  // Each thread takes the next pending task until none is left.
+  auto worker = [&]() {
+    for (size_t index = next_task++; index < num_tasks; index = next_task++) {
+      try {
+        task(index);
+      }
+      catch (...) {
+        errors[index] = std::current_exception();
+      }
+    }
+  };
+
+  // The calling thread works as one of the threads.
+  std::vector<std::thread> threads;
+  const size_t num_workers = std::min<size_t>(ResolveNumThreads(num_threads), num_tasks);
+  for (size_t index = 1; index < num_workers; index++) {
+    try {
+      threads.emplace_back(worker);
+    }
+    catch (const std::system_error &) {
+      // Continue with the threads that could be started.
+      break;
+    }
+  }
+  worker();
+  for (auto & thread : threads) {
+    thread.join();
+  }
+
+  // Rethrow the first error.
+  for (const auto & error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+} // namespace sf2cute
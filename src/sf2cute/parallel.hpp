@@ -0,0 +1,31 @@
+/// @file
+/// Parallel task helper header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_PARALLEL_HPP_
+#define SF2CUTE_PARALLEL_HPP_
+
+#include <stddef.h>
+#include <functional>
+
+namespace sf2cute {
+
+/// Returns the number of threads to be used for the specified request.
+/// @param num_threads the requested number of threads, or 0 for the number of hardware threads.
+/// @return the number of threads, at least 1.
+unsigned int ResolveNumThreads(unsigned int num_threads) noexcept;
+
+/// Runs tasks on a pool of threads, and waits for all of them.
+/// @param num_tasks the number of tasks.
+/// @param num_threads the maximum number of threads, including the calling thread.
+/// @param task the task function, called once for every index in [0, num_tasks).
+/// @throws any exception thrown by a task, after every thread has finished.
+/// The exception of the task with the lowest index is rethrown.
+void ParallelFor(size_t num_tasks,
+    unsigned int num_threads,
+    const std::function<void(size_t)> & task);
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_PARALLEL_HPP_
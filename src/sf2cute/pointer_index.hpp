@@ -0,0 +1,94 @@
+/// @file
+/// Pointer index class template header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_POINTER_INDEX_HPP_
+#define SF2CUTE_POINTER_INDEX_HPP_
+
+#include <stddef.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace sf2cute {
+
+/// The PointerIndex class template maps the elements of a list to their positions.
+///
+/// The index is a vector of positions sorted by the owner of each element,
+/// so a lookup is a binary search over contiguous memory. Unlike a hash
+/// map keyed by std::shared_ptr, building and querying the index neither
+/// hashes nor touches any reference count, and a std::weak_ptr can be
+/// looked up without locking it.
+///
+/// @tparam T the type of the elements.
+/// @remarks The index refers to the list, which must outlive the index
+/// and must not be modified while the index is in use.
+template <typename T>
+class PointerIndex {
+public:
+  /// Unsigned integer type for the positions.
+  using size_type = size_t;
+
+  /// The position returned for an element that is not in the list.
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+  /// Constructs a new PointerIndex of the specified list.
+  /// @param items the list of elements.
+  explicit PointerIndex(const std::vector<std::shared_ptr<T>> & items) :
+      items_(&items) {
+    positions_.reserve(items.size());
+    for (size_type position = 0; position < items.size(); position++) {
+      positions_.push_back(position);
+    }
+    std::sort(positions_.begin(), positions_.end(),
+      [&items](size_type x, size_type y) {
+        return items[x].owner_before(items[y]);
+      });
+  }
+
+  /// Finds the position of the specified element.
+  /// @param item the element.
+  /// @return the position of the element in the list, or npos if not found.
+  template <typename Pointer>
+  size_type Find(const Pointer & item) const noexcept {
+    const std::vector<std::shared_ptr<T>> & items = *items_;
+    const auto it = std::lower_bound(positions_.begin(), positions_.end(), item,
+      [&items](size_type position, const Pointer & key) {
+        return items[position].owner_before(key);
+      });
+    if (it != positions_.end() && !item.owner_before(items[*it])) {
+      return *it;
+    }
+    return static_cast<size_type>(-1);
+  }
+
+  /// Finds the position of the specified element, trying a guess first.
+  /// @param item the element.
+  /// @param hint the guessed position; the position after it is also tried
+  /// before falling back to a binary search.
+  /// @return the position of the element in the list, or npos if not found.
+  /// @remarks Neighbouring references usually point to the same or the next
+  /// element, so passing the previous result as the hint makes most lookups O(1).
+  template <typename Pointer>
+  size_type Find(const Pointer & item, size_type hint) const noexcept {
+    const std::vector<std::shared_ptr<T>> & items = *items_;
+    for (size_type position = hint; position < items.size() && position <= hint + 1; position++) {
+      if (!items[position].owner_before(item) && !item.owner_before(items[position])) {
+        return position;
+      }
+    }
+    return Find(item);
+  }
+
+private:
+  /// The list of elements.
+  const std::vector<std::shared_ptr<T>> * items_;
+
+  /// The positions of the elements, sorted by the owner of each element.
+  std::vector<size_type> positions_;
+};
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_POINTER_INDEX_HPP_
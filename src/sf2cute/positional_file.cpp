@@ -0,0 +1,161 @@
+/// @file
+/// Positional-write file class implementation.
+///
+/// @author gocha <https://github.com/gocha>
+
+#include "positional_file.hpp"
+
+#include <stdint.h>
+#include <errno.h>
+#include <memory>
+#include <string>
+#include <ios>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SF2CUTE_HAVE_PWRITE
+#endif
+
+namespace sf2cute {
+
+/// Constructs a new PositionalFile.
+PositionalFile::PositionalFile(intptr_t handle) noexcept :
+    handle_(handle) {
+}
+
+#if defined(_WIN32)
+
+/// Returns true if positional writes are supported on this platform.
+bool PositionalFile::IsSupported() noexcept {
+  return true;
+}
+
+/// Creates a file of the specified size, replacing an existing file.
+std::unique_ptr<PositionalFile> PositionalFile::Create(const std::string & filename, size_type size) {
+  HANDLE handle = CreateFileA(filename.c_str(), GENERIC_WRITE, 0,
+    nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    throw std::ios_base::failure("Unable to create \"" + filename + "\".");
+  }
+
+  std::unique_ptr<PositionalFile> file(new PositionalFile(reinterpret_cast<intptr_t>(handle)));
+
+  // Extend the file; the extended region reads as zeros.
+  LARGE_INTEGER end;
+  end.QuadPart = static_cast<LONGLONG>(size);
+  if (!SetFilePointerEx(handle, end, nullptr, FILE_BEGIN) || !SetEndOfFile(handle)) {
+    throw std::ios_base::failure("Unable to allocate \"" + filename + "\".");
+  }
+
+  return file;
+}
+
+/// Closes the file.
+PositionalFile::~PositionalFile() {
+  CloseHandle(reinterpret_cast<HANDLE>(handle_));
+}
+
+/// Writes data at the specified offset.
+void PositionalFile::WriteAt(const void * data, size_type size, size_type offset) const {
+  const char * source = static_cast<const char *>(data);
+  while (size != 0) {
+    const DWORD length = size < 0x40000000 ? static_cast<DWORD>(size) : 0x40000000;
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+    DWORD written;
+    if (!WriteFile(reinterpret_cast<HANDLE>(handle_), source, length, &written, &overlapped)) {
+      throw std::ios_base::failure("Unable to write the file.");
+    }
+
+    source += written;
+    size -= written;
+    offset += written;
+  }
+}
+
+#elif defined(SF2CUTE_HAVE_PWRITE)
+
+/// Returns true if positional writes are supported on this platform.
+bool PositionalFile::IsSupported() noexcept {
+  return true;
+}
+
+/// Creates a file of the specified size, replacing an existing file.
+std::unique_ptr<PositionalFile> PositionalFile::Create(const std::string & filename, size_type size) {
+  const int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (fd == -1) {
+    throw std::ios_base::failure("Unable to create \"" + filename + "\".");
+  }
+
+  std::unique_ptr<PositionalFile> file(new PositionalFile(fd));
+
+  // Extend the file; the extended region reads as zeros.
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    throw std::ios_base::failure("Unable to allocate \"" + filename + "\".");
+  }
+#if defined(__linux__)
+  // Reserve the blocks up front where the file system supports it,
+  // so that a full disk is reported here rather than by a later write.
+  const int error = posix_fallocate(fd, 0, static_cast<off_t>(size));
+  if (error != 0 && error != EOPNOTSUPP && error != EINVAL) {
+    throw std::ios_base::failure("Unable to allocate \"" + filename + "\".");
+  }
+#endif
+
+  return file;
+}
+
+/// Closes the file.
+PositionalFile::~PositionalFile() {
+  close(static_cast<int>(handle_));
+}
+
+/// Writes data at the specified offset.
+void PositionalFile::WriteAt(const void * data, size_type size, size_type offset) const {
+  const char * source = static_cast<const char *>(data);
+  while (size != 0) {
+    const ssize_t written = pwrite(static_cast<int>(handle_), source,
+      static_cast<size_t>(size), static_cast<off_t>(offset));
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::ios_base::failure("Unable to write the file.");
+    }
+
+    source += written;
+    size -= static_cast<size_type>(written);
+    offset += static_cast<size_type>(written);
+  }
+}
+
+#else
+
+/// Returns true if positional writes are supported on this platform.
+bool PositionalFile::IsSupported() noexcept {
+  return false;
+}
+
+/// Creates a file of the specified size, replacing an existing file.
+std::unique_ptr<PositionalFile> PositionalFile::Create(const std::string & filename, size_type size) {
+  throw std::ios_base::failure("Positional writes are not supported.");
+}
+
+/// Closes the file.
+PositionalFile::~PositionalFile() {
+}
+
+/// Writes data at the specified offset.
+void PositionalFile::WriteAt(const void * data, size_type size, size_type offset) const {
+  throw std::ios_base::failure("Positional writes are not supported.");
+}
+
+#endif
+
+} // namespace sf2cute
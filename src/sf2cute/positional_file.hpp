@@ -0,0 +1,59 @@
+/// @file
+/// Positional-write file class header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_POSITIONAL_FILE_HPP_
+#define SF2CUTE_POSITIONAL_FILE_HPP_
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+
+namespace sf2cute {
+
+/// The PositionalFile class represents a preallocated file written at explicit offsets.
+///
+/// WriteAt does not use a shared file position, so independent regions
+/// can be written from multiple threads at the same time.
+class PositionalFile {
+public:
+  /// Unsigned integer type for the file size and offsets.
+  using size_type = uint64_t;
+
+  /// Returns true if positional writes are supported on this platform.
+  /// @return true if Create can be used.
+  static bool IsSupported() noexcept;
+
+  /// Creates a file of the specified size, replacing an existing file.
+  /// @param filename the name of the file to create.
+  /// @param size the length of the file, in terms of bytes.
+  /// @return the created file, filled with zeros.
+  /// @throws std::ios_base::failure The file cannot be created or preallocated.
+  static std::unique_ptr<PositionalFile> Create(const std::string & filename, size_type size);
+
+  /// Closes the file.
+  ~PositionalFile();
+
+  PositionalFile(const PositionalFile &) = delete;
+  PositionalFile & operator=(const PositionalFile &) = delete;
+
+  /// Writes data at the specified offset.
+  /// @param data a pointer to the data.
+  /// @param size the length of the data, in terms of bytes.
+  /// @param offset the offset from the beginning of the file, in terms of bytes.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  void WriteAt(const void * data, size_type size, size_type offset) const;
+
+private:
+  /// Constructs a new PositionalFile.
+  /// @param handle the platform file handle.
+  explicit PositionalFile(intptr_t handle) noexcept;
+
+  /// The platform file handle.
+  intptr_t handle_;
+};
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_POSITIONAL_FILE_HPP_
@@ -24,7 +24,8 @@ SFPreset::SFPreset() :
     library_(0),
     genre_(0),
     morphology_(0),
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
 }
 
 /// Constructs a new empty SFPreset using the specified name.
@@ -35,7 +36,8 @@ SFPreset::SFPreset(std::string name) :
     library_(0),
     genre_(0),
     morphology_(0),
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
 }
 
 /// Constructs a new SFPreset using the specified name and preset numbers.
@@ -46,7 +48,8 @@ SFPreset::SFPreset(std::string name, uint16_t preset_number, uint16_t bank) :
     library_(0),
     genre_(0),
     morphology_(0),
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
 }
 
 /// Constructs a new SFPreset using the specified name, preset numbers and zones.
@@ -62,7 +65,8 @@ SFPreset::SFPreset(std::string name,
     morphology_(0),
     zones_(),
     global_zone_(nullptr),
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
   // Set preset zones.
   zones_.reserve(zones.size());
   for (auto && zone : zones) {
@@ -87,7 +91,8 @@ SFPreset::SFPreset(std::string name,
     morphology_(0),
     zones_(),
     global_zone_(std::make_unique<SFPresetZone>(std::move(global_zone))),
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
   // Set preset zones.
   zones_.reserve(zones.size());
   for (auto && zone : zones) {
@@ -108,7 +113,8 @@ SFPreset::SFPreset(const SFPreset & origin) :
     morphology_(origin.morphology_),
     zones_(),
     global_zone_(nullptr),
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
   // Copy global zone.
   if (origin.has_global_zone()) {
     global_zone_ = std::make_unique<SFPresetZone>(origin.global_zone());
@@ -139,14 +145,20 @@ SFPreset & SFPreset::operator=(const SFPreset & origin) {
     zones_.push_back(std::make_unique<SFPresetZone>(*zone));
   }
 
-  // Copy other fields.
-  name_ = origin.name_;
+  // Copy other fields. The preset stays in its file, under the new name and numbers.
+  std::string name = origin.name_;
+  if (parent_file_ != nullptr) {
+    parent_file_->UnindexElement(*this);
+  }
+  name_ = std::move(name);
   preset_number_ = origin.preset_number_;
   bank_ = origin.bank_;
   library_ = origin.library_;
   genre_ = origin.genre_;
   morphology_ = origin.morphology_;
-  parent_file_ = nullptr;
+  if (parent_file_ != nullptr) {
+    parent_file_->IndexElement(*this);
+  }
 
   // Repair references.
   SetBackwardReferences();
@@ -163,12 +175,17 @@ SFPreset::SFPreset(SFPreset && origin) noexcept :
     morphology_(std::move(origin.morphology_)),
     zones_(std::move(origin.zones_)),
     global_zone_(std::move(origin.global_zone_)),
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
   SetBackwardReferences();
 }
 
 /// Move-assigns a new value to the SFPreset, replacing its current contents.
 SFPreset & SFPreset::operator=(SFPreset && origin) noexcept {
+  // The preset stays in its file, under the new name and numbers.
+  if (parent_file_ != nullptr) {
+    parent_file_->UnindexElement(*this);
+  }
   name_ = std::move(origin.name_);
   preset_number_ = std::move(origin.preset_number_);
   bank_ = std::move(origin.bank_);
@@ -177,11 +194,46 @@ SFPreset & SFPreset::operator=(SFPreset && origin) noexcept {
   morphology_ = std::move(origin.morphology_);
   zones_ = std::move(origin.zones_);
   global_zone_ = std::move(origin.global_zone_);
-  parent_file_ = nullptr;
+  if (parent_file_ != nullptr) {
+    parent_file_->IndexElement(*this);
+  }
   SetBackwardReferences();
   return *this;
 }
 
+/// Sets the name of this preset.
+void SFPreset::set_name(std::string name) {
+  if (parent_file_ != nullptr) {
+    parent_file_->UnindexElement(*this);
+  }
+  name_ = std::move(name);
+  if (parent_file_ != nullptr) {
+    parent_file_->IndexElement(*this);
+  }
+}
+
+/// Sets the preset number.
+void SFPreset::set_preset_number(uint16_t preset_number) {
+  if (parent_file_ != nullptr) {
+    parent_file_->UnindexElement(*this);
+  }
+  preset_number_ = std::move(preset_number);
+  if (parent_file_ != nullptr) {
+    parent_file_->IndexElement(*this);
+  }
+}
+
+/// Sets the bank number.
+void SFPreset::set_bank(uint16_t bank) {
+  if (parent_file_ != nullptr) {
+    parent_file_->UnindexElement(*this);
+  }
+  bank_ = std::move(bank);
+  if (parent_file_ != nullptr) {
+    parent_file_->IndexElement(*this);
+  }
+}
+
 /// Adds a preset zone to the preset.
 void SFPreset::AddZone(SFPresetZone zone) {
   // Check the parent preset of the zone.
@@ -206,7 +258,8 @@ void SFPreset::AddZone(SFPresetZone zone) {
     }
   }
 
-  // Add the zone to the list.
+  // Add the zone to the list, from the arena of the parent file if any.
+  SFArena::Scope scope(has_parent_file() ? parent_file().arena() : SFArena::current());
   zones_.push_back(std::make_unique<SFPresetZone>(std::move(zone)));
 }
 
@@ -242,6 +295,7 @@ void SFPreset::set_global_zone(SFPresetZone global_zone) {
   global_zone.set_parent_preset(*this);
 
   // Set the global zone to this preset.
+  SFArena::Scope scope(has_parent_file() ? parent_file().arena() : SFArena::current());
   global_zone_ = std::make_unique<SFPresetZone>(std::move(global_zone));
 }
 
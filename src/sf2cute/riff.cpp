@@ -8,6 +8,7 @@
 #include "riff.hpp"
 
 #include <stdint.h>
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -19,6 +20,32 @@
 
 namespace sf2cute {
 
+/// Writes this chunk to the specified output stream.
+void RIFFChunkInterface::Write(std::ostream & out) const {
+  // Serialize the whole chunk first, since the buffer needs no checks per store.
+  std::vector<char> buffer(size());
+  WriteTo(buffer.data());
+
+  // Save exception bits of output stream.
+  const std::ios_base::iostate old_exception_bits = out.exceptions();
+  // Set exception bits to get output error as an exception.
+  out.exceptions(std::ios::badbit | std::ios::failbit);
+
+  try {
+    out.write(buffer.data(), std::streamsize(buffer.size()));
+  }
+  catch (const std::exception &) {
+    // Recover exception bits of output stream.
+    out.exceptions(old_exception_bits);
+
+    // Rethrow the exception.
+    throw;
+  }
+
+  // Recover exception bits of output stream.
+  out.exceptions(old_exception_bits);
+}
+
 /// Constructs a new empty RIFFChunk.
 RIFFChunk::RIFFChunk() :
     name_("    ") {
@@ -48,32 +75,19 @@ void RIFFChunk::set_name(std::string name) {
   name_ = std::move(name);
 }
 
-/// Writes this chunk to the specified output stream.
-void RIFFChunk::Write(std::ostream & out) const {
-  // Save exception bits of output stream.
-  const std::ios_base::iostate old_exception_bits = out.exceptions();
-  // Set exception bits to get output error as an exception.
-  out.exceptions(std::ios::badbit | std::ios::failbit);
-
-  try {
-    // Write the chunk header.
-    WriteHeader(out, name(), data_.size());
+/// Writes this chunk to the specified buffer.
+char * RIFFChunk::WriteTo(char * out) const {
+  // Write the chunk header.
+  out = WriteHeader(out, name(), data_.size());
 
-    // Write the chunk data.
-    out.write(reinterpret_cast<const char *>(data_.data()), data_.size());
+  // Write the chunk data.
+  out = std::copy(data_.begin(), data_.end(), out);
 
-    // Write a padding byte if necessary.
-    if (data_.size() % 2 != 0) {
-      InsertInt8(out, 0);
-    }
-  }
-  catch (const std::exception &) {
-    // Recover exception bits of output stream.
-    out.exceptions(old_exception_bits);
-
-    // Rethrow the exception.
-    throw;
+  // Write a padding byte if necessary.
+  if (data_.size() % 2 != 0) {
+    out = WriteInt8(out, 0);
   }
+  return out;
 }
 
 /// Writes a chunk header to the specified output stream.
@@ -108,13 +122,33 @@ void RIFFChunk::WriteHeader(std::ostream & out,
   }
 }
 
+/// Writes a chunk header to the specified buffer.
+char * RIFFChunk::WriteHeader(char * out,
+    const std::string & name,
+    size_type size) {
+  // Throw exception if the chunk size exceeds the maximum.
+  if (size > UINT32_MAX) {
+    std::ostringstream message_builder;
+    message_builder << "RIFF chunk \"" << name << "\" size too large.";
+    throw std::length_error(message_builder.str());
+  }
+
+  // Write the chunk name.
+  out = std::copy(name.begin(), name.end(), out);
+
+  // Write the chunk size.
+  return WriteInt32L(out, static_cast<uint32_t>(size));
+}
+
 /// Constructs a new empty RIFFListChunk.
 RIFFListChunk::RIFFListChunk() :
-    name_("    ") {
+    name_("    "),
+    subchunks_size_(0) {
 }
 
 /// Constructs a new empty RIFFListChunk using the specified list type.
-RIFFListChunk::RIFFListChunk(std::string name) {
+RIFFListChunk::RIFFListChunk(std::string name) :
+    subchunks_size_(0) {
   set_name(std::move(name));
 }
 
@@ -133,12 +167,14 @@ void RIFFListChunk::set_name(std::string name) {
 
 /// Appends the specified RIFFChunkInterface to this chunk.
 void RIFFListChunk::AddSubchunk(std::unique_ptr<RIFFChunkInterface> && subchunk) {
+  subchunks_size_ += subchunk->size();
   subchunks_.push_back(std::move(subchunk));
 }
 
 /// Removes all subchunks from this chunk.
 void RIFFListChunk::ClearSubchunks() {
   subchunks_.clear();
+  subchunks_size_ = 0;
 }
 
 /// Writes this chunk to the specified output stream.
@@ -152,6 +188,18 @@ void RIFFListChunk::Write(std::ostream & out) const {
   }
 }
 
+/// Writes this chunk to the specified buffer.
+char * RIFFListChunk::WriteTo(char * out) const {
+  // Write the chunk header.
+  out = WriteHeader(out, name(), size() - 8);
+
+  // Write each subchunks.
+  for (const auto & subchunk : subchunks_) {
+    out = subchunk->WriteTo(out);
+  }
+  return out;
+}
+
 /// Writes a "LIST" chunk header to the specified output stream.
 void RIFFListChunk::WriteHeader(std::ostream & out,
     const std::string & name,
@@ -187,6 +235,27 @@ void RIFFListChunk::WriteHeader(std::ostream & out,
   }
 }
 
+/// Writes a "LIST" chunk header to the specified buffer.
+char * RIFFListChunk::WriteHeader(char * out,
+    const std::string & name,
+    size_type size) {
+  // Throw exception if the chunk size exceeds the maximum.
+  if (size > UINT32_MAX) {
+    std::ostringstream message_builder;
+    message_builder << "RIFF chunk \"" << name << "\" size too large.";
+    throw std::length_error(message_builder.str());
+  }
+
+  // Write the chunk ID "LIST".
+  out = std::copy_n("LIST", 4, out);
+
+  // Write the chunk size.
+  out = WriteInt32L(out, static_cast<uint32_t>(size));
+
+  // Write the list type.
+  return std::copy(name.begin(), name.end(), out);
+}
+
 /// Constructs a new empty RIFF.
 RIFF::RIFF() :
     name_("    ") {
@@ -235,6 +304,18 @@ void RIFF::Write(std::ostream & out) const {
   }
 }
 
+/// Writes this RIFF to the specified buffer.
+char * RIFF::WriteTo(char * out) const {
+  // Write the RIFF header.
+  out = WriteHeader(out, name(), size() - 8);
+
+  // Write each chunks.
+  for (const auto & chunk : chunks_) {
+    out = chunk->WriteTo(out);
+  }
+  return out;
+}
+
 /// Writes a "RIFF" chunk header to the specified output stream.
 void RIFF::WriteHeader(std::ostream & out,
     const std::string & name,
@@ -268,4 +349,23 @@ void RIFF::WriteHeader(std::ostream & out,
   }
 }
 
+/// Writes a "RIFF" chunk header to the specified buffer.
+char * RIFF::WriteHeader(char * out,
+    const std::string & name,
+    size_type size) {
+  // Throw exception if the RIFF file size exceeds the maximum.
+  if (size > UINT32_MAX) {
+    throw std::length_error("RIFF file size too large.");
+  }
+
+  // Write the ID "RIFF".
+  out = std::copy_n("RIFF", 4, out);
+
+  // Write the file size.
+  out = WriteInt32L(out, static_cast<uint32_t>(size));
+
+  // Write the form type.
+  return std::copy(name.begin(), name.end(), out);
+}
+
 } // namespace sf2cute
@@ -37,7 +37,15 @@ public:
   /// @param out the output stream.
   /// @throws std::length_error The chunk size exceeds the maximum.
   /// @throws std::ios_base::failure An I/O error occurred.
-  virtual void Write(std::ostream & out) const = 0;
+  /// @remarks The default implementation serializes the chunk with
+  /// WriteTo into a buffer of size() bytes, and writes the buffer at once.
+  virtual void Write(std::ostream & out) const;
+
+  /// Writes this chunk to the specified buffer.
+  /// @param out a pointer to the buffer, which must have room for size() bytes.
+  /// @return a pointer past the written chunk.
+  /// @throws std::length_error The chunk size exceeds the maximum.
+  virtual char * WriteTo(char * out) const = 0;
 };
 
 /// The RIFFChunk class represents a RIFF chunk.
@@ -111,11 +119,8 @@ public:
     return 8 + chunk_size;
   }
 
-  /// Writes this chunk to the specified output stream.
-  /// @param out the output stream.
-  /// @throws std::length_error The chunk size exceeds the maximum.
-  /// @throws std::ios_base::failure An I/O error occurred.
-  virtual void Write(std::ostream & out) const override;
+  /// @copydoc RIFFChunkInterface::WriteTo()
+  virtual char * WriteTo(char * out) const override;
 
   /// Writes a chunk header to the specified output stream.
   /// @param out the output stream.
@@ -127,6 +132,16 @@ public:
       const std::string & name,
       size_type size);
 
+  /// Writes a chunk header to the specified buffer.
+  /// @param out a pointer to the buffer.
+  /// @param name the name of the chunk (FourCC).
+  /// @param size the length of the chunk data, in terms of bytes.
+  /// @return a pointer past the written header.
+  /// @throws std::length_error The chunk size exceeds the maximum.
+  static char * WriteHeader(char * out,
+      const std::string & name,
+      size_type size);
+
 private:
   /// The name of the chunk.
   std::string name_;
@@ -188,6 +203,8 @@ public:
 
   /// Appends the specified RIFFChunkInterface to this chunk.
   /// @param subchunk a pointer to RIFFChunkInterface object.
+  /// @remarks The size of the subchunk is accumulated when it is added,
+  /// so it must not change afterwards.
   void AddSubchunk(std::unique_ptr<RIFFChunkInterface> && subchunk);
 
   /// Removes all subchunks from this chunk.
@@ -196,11 +213,7 @@ public:
   /// Returns the whole length of this chunk.
   /// @return the length of this chunk including a chunk header, in terms of bytes.
   virtual size_type size() const noexcept override {
-    size_type chunk_size = 0;
-    for (const auto & subchunk : subchunks_) {
-      chunk_size += subchunk->size();
-    }
-    return 12 + chunk_size;
+    return 12 + subchunks_size_;
   }
 
   /// Writes this chunk to the specified output stream.
@@ -209,6 +222,9 @@ public:
   /// @throws std::ios_base::failure An I/O error occurred.
   virtual void Write(std::ostream & out) const override;
 
+  /// @copydoc RIFFChunkInterface::WriteTo()
+  virtual char * WriteTo(char * out) const override;
+
   /// Writes a "LIST" chunk header to the specified output stream.
   /// @param out the output stream.
   /// @param name the list type of the chunk (FourCC).
@@ -219,12 +235,25 @@ public:
       const std::string & name,
       size_type size);
 
+  /// Writes a "LIST" chunk header to the specified buffer.
+  /// @param out a pointer to the buffer.
+  /// @param name the list type of the chunk (FourCC).
+  /// @param size the length of the chunk data, in terms of bytes.
+  /// @return a pointer past the written header.
+  /// @throws std::length_error The chunk size exceeds the maximum.
+  static char * WriteHeader(char * out,
+      const std::string & name,
+      size_type size);
+
 private:
   /// The name of the chunk.
   std::string name_;
 
   /// A collection of pointers to each RIFFChunkInterface objects.
   std::vector<std::unique_ptr<RIFFChunkInterface>> subchunks_;
+
+  /// The total length of the subchunks, in terms of bytes.
+  size_type subchunks_size_;
 };
 
 /// The RIFF class represents a RIFF file.
@@ -304,6 +333,12 @@ public:
   /// @throws std::ios_base::failure An I/O error occurred.
   void Write(std::ostream & out) const;
 
+  /// Writes this RIFF to the specified buffer.
+  /// @param out a pointer to the buffer, which must have room for size() bytes.
+  /// @return a pointer past the written RIFF.
+  /// @throws std::length_error The chunk size exceeds the maximum.
+  char * WriteTo(char * out) const;
+
   /// Writes a "RIFF" chunk header to the specified output stream.
   /// @param out the output stream.
   /// @param name the form type of the chunk (FourCC).
@@ -314,6 +349,16 @@ public:
       const std::string & name,
       size_type size);
 
+  /// Writes a "RIFF" chunk header to the specified buffer.
+  /// @param out a pointer to the buffer.
+  /// @param name the form type of the chunk (FourCC).
+  /// @param size the length of the chunk data, in terms of bytes.
+  /// @return a pointer past the written header.
+  /// @throws std::length_error The chunk size exceeds the maximum.
+  static char * WriteHeader(char * out,
+      const std::string & name,
+      size_type size);
+
 private:
   /// The form type of the chunk.
   std::string name_;
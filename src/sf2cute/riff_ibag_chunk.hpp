@@ -36,6 +36,13 @@ public:
   SFRIFFIbagChunk(
       const std::vector<std::shared_ptr<SFInstrument>> & instruments);
 
+  /// Constructs a new SFRIFFIbagChunk using the specified instruments and the planned number of items.
+  /// @param instruments The instruments of the chunk.
+  /// @param num_items the number of items, including the terminator.
+  SFRIFFIbagChunk(
+      const std::vector<std::shared_ptr<SFInstrument>> & instruments,
+      size_type num_items);
+
   /// Constructs a new copy of specified SFRIFFIbagChunk.
   /// @param origin a SFRIFFIbagChunk object.
   SFRIFFIbagChunk(const SFRIFFIbagChunk & origin) = default;
@@ -82,11 +89,9 @@ public:
     return 8 + size_;
   }
 
-  /// Writes this chunk to the specified output stream.
-  /// @param out the output stream.
+  /// @copydoc RIFFChunkInterface::WriteTo()
   /// @throws std::length_error The chunk size exceeds the maximum.
-  /// @throws std::ios_base::failure An I/O error occurred.
-  virtual void Write(std::ostream & out) const override;
+  virtual char * WriteTo(char * out) const override;
 
 private:
   /// Returns the number of instrument zone items.
@@ -95,12 +100,11 @@ private:
   uint16_t NumItems() const;
 
   /// Writes an item of ibag chunk.
-  /// @param out the output stream.
+  /// @param out a pointer to the buffer.
   /// @param generator_index the generator index starting from 0.
   /// @param modulator_index the modulator index starting from 0.
-  /// @return the output stream.
-  /// @throws std::ios_base::failure An I/O error occurred.
-  static std::ostream & WriteItem(std::ostream & out,
+  /// @return a pointer past the written item.
+  static char * WriteItem(char * out,
       uint16_t generator_index,
       uint16_t modulator_index);
 
@@ -10,7 +10,6 @@
 #include <memory>
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <ostream>
 
 #include <sf2cute/types.hpp>
@@ -37,11 +36,20 @@ public:
 
   /// Constructs a new SFRIFFIgenChunk using the specified instruments.
   /// @param instruments The instruments of the chunk.
-  /// @param sample_index_map the map containing the samples as keys and their indices as map values.
+  /// @param samples the samples referenced by the zones, in the order of their indices.
   /// @throws std::length_error Too many instrument generators.
   SFRIFFIgenChunk(
       const std::vector<std::shared_ptr<SFInstrument>> & instruments,
-      std::unordered_map<const SFSample *, uint16_t> sample_index_map);
+      const std::vector<std::shared_ptr<SFSample>> & samples);
+
+  /// Constructs a new SFRIFFIgenChunk using the specified instruments and the planned number of items.
+  /// @param instruments The instruments of the chunk.
+  /// @param samples the samples referenced by the zones, in the order of their indices.
+  /// @param num_items the number of items, including the terminator.
+  SFRIFFIgenChunk(
+      const std::vector<std::shared_ptr<SFInstrument>> & instruments,
+      const std::vector<std::shared_ptr<SFSample>> & samples,
+      size_type num_items);
 
   /// Constructs a new copy of specified SFRIFFIgenChunk.
   /// @param origin a SFRIFFIgenChunk object.
@@ -83,18 +91,16 @@ public:
     size_ = kItemSize * NumItems();
   }
 
-  /// Returns the map containing the samples as keys and their indices as map values.
-  /// @return the map containing the samples as keys and their indices as map values.
-  const std::unordered_map<const SFSample *, uint16_t> &
-      sample_index_map() const {
-    return sample_index_map_;
+  /// Returns the samples referenced by the zones.
+  /// @return the samples referenced by the zones, in the order of their indices.
+  const std::vector<std::shared_ptr<SFSample>> & samples() const {
+    return *samples_;
   }
 
-  /// Sets the map containing the samples as keys and their indices as map values.
-  /// @param sample_index_map the map containing the samples as keys and their indices as map values.
-  void set_sample_index_map(
-      std::unordered_map<const SFSample *, uint16_t> sample_index_map) {
-    sample_index_map_ = std::move(sample_index_map);
+  /// Sets the samples referenced by the zones.
+  /// @param samples the samples referenced by the zones, in the order of their indices.
+  void set_samples(const std::vector<std::shared_ptr<SFSample>> & samples) {
+    samples_ = &samples;
   }
 
   /// Returns the whole length of this chunk.
@@ -103,14 +109,12 @@ public:
     return 8 + size_;
   }
 
-  /// Writes this chunk to the specified output stream.
-  /// @param out the output stream.
+  /// @copydoc RIFFChunkInterface::WriteTo()
   /// @throws std::invalid_argument Global instrument zone has a sample.
   /// @throws std::invalid_argument Instrument zone does not have a sample.
   /// @throws std::length_error The chunk size exceeds the maximum.
   /// @throws std::out_of_range Instrument zone points to an unknown sample.
-  /// @throws std::ios_base::failure An I/O error occurred.
-  virtual void Write(std::ostream & out) const override;
+  virtual char * WriteTo(char * out) const override;
 
 private:
   /// Returns the number of instrument generator items.
@@ -119,29 +123,22 @@ private:
   uint16_t NumItems() const;
 
   /// Writes an item of igen chunk.
-  /// @param out the output stream.
+  /// @param out a pointer to the buffer.
   /// @param op the type of the generator.
   /// @param amount the amount of the generator.
-  /// @return the output stream.
-  /// @throws std::ios_base::failure An I/O error occurred.
-  static std::ostream & WriteItem(std::ostream & out,
+  /// @return a pointer past the written item.
+  static char * WriteItem(char * out,
       SFGenerator op,
       GenAmountType amount);
 
-  /// Sort generators based on the ordering requirements of the generator chunk.
-  /// @param generators the generators.
-  /// @return the sorted collection of the generator pointers.
-  static std::vector<SFGeneratorItem *> SortGenerators(
-      const std::vector<std::unique_ptr<SFGeneratorItem>> & generators);
-
   /// The size of the chunk (excluding header).
   size_type size_;
 
   /// The instruments of the chunk.
   const std::vector<std::shared_ptr<SFInstrument>> * instruments_;
 
-  /// The map containing the samples as keys and their indices as map values.
-  std::unordered_map<const SFSample *, uint16_t> sample_index_map_;
+  /// The samples referenced by the zones.
+  const std::vector<std::shared_ptr<SFSample>> * samples_;
 };
 
 } // namespace sf2cute
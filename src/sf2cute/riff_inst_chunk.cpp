@@ -10,7 +10,6 @@
 #include <memory>
 #include <string>
 #include <sstream>
-#include <ostream>
 #include <stdexcept>
 
 #include <sf2cute/instrument.hpp>
@@ -32,49 +31,45 @@ SFRIFFInstChunk::SFRIFFInstChunk(
   size_ = kItemSize * NumItems();
 }
 
-/// Writes this chunk to the specified output stream.
-void SFRIFFInstChunk::Write(std::ostream & out) const {
-  // Save exception bits of output stream.
-  const std::ios_base::iostate old_exception_bits = out.exceptions();
-  // Set exception bits to get output error as an exception.
-  out.exceptions(std::ios::badbit | std::ios::failbit);
-
-  try {
-    // Write the chunk header.
-    RIFFChunk::WriteHeader(out, name(), size_);
-
-    // Instruments:
-    size_t inst_bag_index = 0;
-    for (const auto & instrument : instruments()) {
-      // Write the instrument header.
-      WriteItem(out, instrument->name(), uint16_t(inst_bag_index));
-
-      // Count the number of instrument zones.
-      size_t num_zones = 0;
-      if (instrument->has_global_zone()) {
-        num_zones++;
-      }
-      num_zones += instrument->zones().size();
-
-      // Increment the instrument bag index.
-      inst_bag_index += num_zones;
-    }
-
-    // Write the last terminator item.
-    WriteItem(out, "EOI", uint16_t(inst_bag_index));
+/// Constructs a new SFRIFFInstChunk using the specified instruments and the planned number of items.
+SFRIFFInstChunk::SFRIFFInstChunk(
+    const std::vector<std::shared_ptr<SFInstrument>> & instruments,
+    size_type num_items) :
+    size_(kItemSize * num_items),
+    instruments_(&instruments) {
+}
 
-    // Write a padding byte if necessary.
-    if (size_ % 2 != 0) {
-      InsertInt8(out, 0);
+/// Writes this chunk to the specified buffer.
+char * SFRIFFInstChunk::WriteTo(char * out) const {
+  // Write the chunk header.
+  out = RIFFChunk::WriteHeader(out, name(), size_);
+
+  // Instruments:
+  size_t inst_bag_index = 0;
+  for (const auto & instrument : instruments()) {
+    // Write the instrument header.
+    out = WriteItem(out, instrument->name(), uint16_t(inst_bag_index));
+
+    // Count the number of instrument zones.
+    size_t num_zones = 0;
+    if (instrument->has_global_zone()) {
+      num_zones++;
     }
+    num_zones += instrument->zones().size();
+
+    // Increment the instrument bag index.
+    inst_bag_index += num_zones;
   }
-  catch (const std::exception &) {
-    // Recover exception bits of output stream.
-    out.exceptions(old_exception_bits);
 
-    // Rethrow the exception.
-    throw;
+  // Write the last terminator item.
+  out = WriteItem(out, "EOI", uint16_t(inst_bag_index));
+
+  // Write a padding byte if necessary.
+  if (size_ % 2 != 0) {
+    out = WriteInt8(out, 0);
   }
+
+  return out;
 }
 
 /// Returns the number of instrument items.
@@ -87,19 +82,18 @@ uint16_t SFRIFFInstChunk::NumItems() const {
 }
 
 /// Writes an item of inst chunk.
-std::ostream & SFRIFFInstChunk::WriteItem(std::ostream & out,
+char * SFRIFFInstChunk::WriteItem(char * out,
     const std::string & name,
     uint16_t inst_bag_index) {
   // struct sfInst:
   // char achInstName[20];
-  std::string instrument_name(name.substr(0, SFInstrument::kMaxNameLength));
-  out.write(instrument_name.data(), instrument_name.size());
-  for (std::string::size_type i = 0; i < SFInstrument::kMaxNameLength + 1 - instrument_name.size(); i++) {
-    out.put(0);
-  }
+  const std::string::size_type name_length =
+      name.size() < SFInstrument::kMaxNameLength ? name.size() : SFInstrument::kMaxNameLength;
+  out = std::copy_n(name.data(), name_length, out);
+  out = std::fill_n(out, SFInstrument::kMaxNameLength + 1 - name_length, '\0');
 
   // uint16_t wInstBagNdx;
-  InsertInt16L(out, inst_bag_index);
+  out = WriteInt16L(out, inst_bag_index);
 
   return out;
 }
@@ -36,6 +36,13 @@ public:
   SFRIFFInstChunk(
       const std::vector<std::shared_ptr<SFInstrument>> & instruments);
 
+  /// Constructs a new SFRIFFInstChunk using the specified instruments and the planned number of items.
+  /// @param instruments The instruments of the chunk.
+  /// @param num_items the number of items, including the terminator.
+  SFRIFFInstChunk(
+      const std::vector<std::shared_ptr<SFInstrument>> & instruments,
+      size_type num_items);
+
   /// Constructs a new copy of specified SFRIFFInstChunk.
   /// @param origin a SFRIFFInstChunk object.
   SFRIFFInstChunk(const SFRIFFInstChunk & origin) = default;
@@ -82,11 +89,9 @@ public:
     return 8 + size_;
   }
 
-  /// Writes this chunk to the specified output stream.
-  /// @param out the output stream.
+  /// @copydoc RIFFChunkInterface::WriteTo()
   /// @throws std::length_error The chunk size exceeds the maximum.
-  /// @throws std::ios_base::failure An I/O error occurred.
-  virtual void Write(std::ostream & out) const override;
+  virtual char * WriteTo(char * out) const override;
 
 private:
   /// Returns the number of instrument items.
@@ -95,12 +100,11 @@ private:
   uint16_t NumItems() const;
 
   /// Writes an item of inst chunk.
-  /// @param out the output stream.
+  /// @param out a pointer to the buffer.
   /// @param name the name of instrument.
   /// @param inst_bag_index the instrument bag index starting from 0.
-  /// @return the output stream.
-  /// @throws std::ios_base::failure An I/O error occurred.
-  static std::ostream & WriteItem(std::ostream & out,
+  /// @return a pointer past the written item.
+  static char * WriteItem(char * out,
       const std::string & name,
       uint16_t inst_bag_index);
 
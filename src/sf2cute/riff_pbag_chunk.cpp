@@ -6,10 +6,10 @@
 #include "riff_pbag_chunk.hpp"
 
 #include <stdint.h>
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <sstream>
-#include <ostream>
 #include <stdexcept>
 
 #include <sf2cute/preset.hpp>
@@ -32,57 +32,53 @@ SFRIFFPbagChunk::SFRIFFPbagChunk(
   size_ = kItemSize * NumItems();
 }
 
-/// Writes this chunk to the specified output stream.
-void SFRIFFPbagChunk::Write(std::ostream & out) const {
-  // Save exception bits of output stream.
-  const std::ios_base::iostate old_exception_bits = out.exceptions();
-  // Set exception bits to get output error as an exception.
-  out.exceptions(std::ios::badbit | std::ios::failbit);
-
-  try {
-    // Write the chunk header.
-    RIFFChunk::WriteHeader(out, name(), size_);
-
-    // Presets:
-    size_t generator_index = 0;
-    size_t modulator_index = 0;
-    for (const auto & preset : presets()) {
-      // Global preset zone:
-      if (preset->has_global_zone()) {
-        // Write the global zone.
-        WriteItem(out, uint16_t(generator_index), uint16_t(modulator_index));
-
-        // Increment the generator index and the modulator index.
-        generator_index += preset->global_zone().generators().size();
-        modulator_index += preset->global_zone().modulators().size();
-      }
-
-      // Preset zones:
-      for (const auto & zone : preset->zones()) {
-        // Write the preset zone.
-        WriteItem(out, uint16_t(generator_index), uint16_t(modulator_index));
-
-        // Increment the generator index and the modulator index.
-        generator_index += (zone->has_instrument() ? 1 : 0) + zone->generators().size();
-        modulator_index += zone->modulators().size();
-      }
+/// Constructs a new SFRIFFPbagChunk using the specified presets and the planned number of items.
+SFRIFFPbagChunk::SFRIFFPbagChunk(
+    const std::vector<std::shared_ptr<SFPreset>> & presets,
+    size_type num_items) :
+    size_(kItemSize * num_items),
+    presets_(&presets) {
+}
+
+/// Writes this chunk to the specified buffer.
+char * SFRIFFPbagChunk::WriteTo(char * out) const {
+  // Write the chunk header.
+  out = RIFFChunk::WriteHeader(out, name(), size_);
+
+  // Presets:
+  size_t generator_index = 0;
+  size_t modulator_index = 0;
+  for (const auto & preset : presets()) {
+    // Global preset zone:
+    if (preset->has_global_zone()) {
+      // Write the global zone.
+      out = WriteItem(out, uint16_t(generator_index), uint16_t(modulator_index));
+
+      // Increment the generator index and the modulator index.
+      generator_index += preset->global_zone().generators().size();
+      modulator_index += preset->global_zone().modulators().size();
     }
 
-    // Write the last terminator item.
-    WriteItem(out, uint16_t(generator_index), uint16_t(modulator_index));
+    // Preset zones:
+    for (const auto & zone : preset->zones()) {
+      // Write the preset zone.
+      out = WriteItem(out, uint16_t(generator_index), uint16_t(modulator_index));
 
-    // Write a padding byte if necessary.
-    if (size_ % 2 != 0) {
-      InsertInt8(out, 0);
+      // Increment the generator index and the modulator index.
+      generator_index += (zone->has_instrument() ? 1 : 0) + zone->generators().size();
+      modulator_index += zone->modulators().size();
     }
   }
-  catch (const std::exception &) {
-    // Recover exception bits of output stream.
-    out.exceptions(old_exception_bits);
 
-    // Rethrow the exception.
-    throw;
+  // Write the last terminator item.
+  out = WriteItem(out, uint16_t(generator_index), uint16_t(modulator_index));
+
+  // Write a padding byte if necessary.
+  if (size_ % 2 != 0) {
+    out = WriteInt8(out, 0);
   }
+
+  return out;
 }
 
 /// Returns the number of preset zone items.
@@ -106,15 +102,15 @@ uint16_t SFRIFFPbagChunk::NumItems() const {
 }
 
 /// Writes an item of pbag chunk.
-std::ostream & SFRIFFPbagChunk::WriteItem(std::ostream & out,
+char * SFRIFFPbagChunk::WriteItem(char * out,
     uint16_t generator_index,
     uint16_t modulator_index) {
   // struct sfPresetBag:
   // uint16_t wGenNdx;
-  InsertInt16L(out, generator_index);
+  out = WriteInt16L(out, generator_index);
 
   // uint16_t wModNdx;
-  InsertInt16L(out, modulator_index);
+  out = WriteInt16L(out, modulator_index);
 
   return out;
 }
@@ -36,6 +36,13 @@ public:
   SFRIFFPbagChunk(
       const std::vector<std::shared_ptr<SFPreset>> & presets);
 
+  /// Constructs a new SFRIFFPbagChunk using the specified presets and the planned number of items.
+  /// @param presets The presets of the chunk.
+  /// @param num_items the number of items, including the terminator.
+  SFRIFFPbagChunk(
+      const std::vector<std::shared_ptr<SFPreset>> & presets,
+      size_type num_items);
+
   /// Constructs a new copy of specified SFRIFFPbagChunk.
   /// @param origin a SFRIFFPbagChunk object.
   SFRIFFPbagChunk(const SFRIFFPbagChunk & origin) = default;
@@ -82,11 +89,9 @@ public:
     return 8 + size_;
   }
 
-  /// Writes this chunk to the specified output stream.
-  /// @param out the output stream.
+  /// @copydoc RIFFChunkInterface::WriteTo()
   /// @throws std::length_error The chunk size exceeds the maximum.
-  /// @throws std::ios_base::failure An I/O error occurred.
-  virtual void Write(std::ostream & out) const override;
+  virtual char * WriteTo(char * out) const override;
 
 private:
   /// Returns the number of preset zone items.
@@ -95,12 +100,11 @@ private:
   uint16_t NumItems() const;
 
   /// Writes an item of pbag chunk.
-  /// @param out the output stream.
+  /// @param out a pointer to the buffer.
   /// @param generator_index the generator index starting from 0.
   /// @param modulator_index the modulator index starting from 0.
-  /// @return the output stream.
-  /// @throws std::ios_base::failure An I/O error occurred.
-  static std::ostream & WriteItem(std::ostream & out,
+  /// @return a pointer past the written item.
+  static char * WriteItem(char * out,
       uint16_t generator_index,
       uint16_t modulator_index);
 
@@ -6,10 +6,10 @@
 #include "riff_phdr_chunk.hpp"
 
 #include <stdint.h>
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <sstream>
-#include <ostream>
 #include <stdexcept>
 
 #include <sf2cute/preset.hpp>
@@ -31,51 +31,47 @@ SFRIFFPhdrChunk::SFRIFFPhdrChunk(
   size_ = kItemSize * NumItems();
 }
 
-/// Writes this chunk to the specified output stream.
-void SFRIFFPhdrChunk::Write(std::ostream & out) const {
-  // Save exception bits of output stream.
-  const std::ios_base::iostate old_exception_bits = out.exceptions();
-  // Set exception bits to get output error as an exception.
-  out.exceptions(std::ios::badbit | std::ios::failbit);
-
-  try {
-    // Write the chunk header.
-    RIFFChunk::WriteHeader(out, name(), size_);
-
-    // Presets:
-    size_t preset_bag_index = 0;
-    for (const auto & preset : presets()) {
-      // Write the preset header.
-      WriteItem(out, preset->name(),
-        preset->preset_number(), preset->bank(), uint16_t(preset_bag_index),
-        preset->library(), preset->genre(), preset->morphology());
-
-      // Count the number of preset zones.
-      size_t num_zones = 0;
-      if (preset->has_global_zone()) {
-        num_zones++;
-      }
-      num_zones += preset->zones().size();
-
-      // Increment the preset bag index.
-      preset_bag_index += num_zones;
-    }
-
-    // Write the last terminator item.
-    WriteItem(out, "EOP", 0, 0, uint16_t(preset_bag_index), 0, 0, 0);
+/// Constructs a new SFRIFFPhdrChunk using the specified presets and the planned number of items.
+SFRIFFPhdrChunk::SFRIFFPhdrChunk(
+    const std::vector<std::shared_ptr<SFPreset>> & presets,
+    size_type num_items) :
+    size_(kItemSize * num_items),
+    presets_(&presets) {
+}
 
-    // Write a padding byte if necessary.
-    if (size_ % 2 != 0) {
-      InsertInt8(out, 0);
+/// Writes this chunk to the specified buffer.
+char * SFRIFFPhdrChunk::WriteTo(char * out) const {
+  // Write the chunk header.
+  out = RIFFChunk::WriteHeader(out, name(), size_);
+
+  // Presets:
+  size_t preset_bag_index = 0;
+  for (const auto & preset : presets()) {
+    // Write the preset header.
+    out = WriteItem(out, preset->name(),
+      preset->preset_number(), preset->bank(), uint16_t(preset_bag_index),
+      preset->library(), preset->genre(), preset->morphology());
+
+    // Count the number of preset zones.
+    size_t num_zones = 0;
+    if (preset->has_global_zone()) {
+      num_zones++;
     }
+    num_zones += preset->zones().size();
+
+    // Increment the preset bag index.
+    preset_bag_index += num_zones;
   }
-  catch (const std::exception &) {
-    // Recover exception bits of output stream.
-    out.exceptions(old_exception_bits);
 
-    // Rethrow the exception.
-    throw;
+  // Write the last terminator item.
+  out = WriteItem(out, "EOP", 0, 0, uint16_t(preset_bag_index), 0, 0, 0);
+
+  // Write a padding byte if necessary.
+  if (size_ % 2 != 0) {
+    out = WriteInt8(out, 0);
   }
+
+  return out;
 }
 
 /// Returns the number of preset items.
@@ -88,7 +84,7 @@ uint16_t SFRIFFPhdrChunk::NumItems() const {
 }
 
 /// Writes an item of phdr chunk.
-std::ostream & SFRIFFPhdrChunk::WriteItem(std::ostream & out,
+char * SFRIFFPhdrChunk::WriteItem(char * out,
     const std::string & name,
     uint16_t preset_number,
     uint16_t bank,
@@ -98,29 +94,28 @@ std::ostream & SFRIFFPhdrChunk::WriteItem(std::ostream & out,
     uint32_t morphology) {
   // struct sfPresetHeader:
   // char achPresetName[20];
-  std::string preset_name(name.substr(0, SFPreset::kMaxNameLength));
-  out.write(preset_name.data(), preset_name.size());
-  for (std::string::size_type i = 0; i < SFPreset::kMaxNameLength + 1 - preset_name.size(); i++) {
-    out.put(0);
-  }
+  const std::string::size_type name_length =
+      name.size() < SFPreset::kMaxNameLength ? name.size() : SFPreset::kMaxNameLength;
+  out = std::copy_n(name.data(), name_length, out);
+  out = std::fill_n(out, SFPreset::kMaxNameLength + 1 - name_length, '\0');
 
   // uint16_t wPreset;
-  InsertInt16L(out, preset_number);
+  out = WriteInt16L(out, preset_number);
 
   // uint16_t wBank;
-  InsertInt16L(out, bank);
+  out = WriteInt16L(out, bank);
 
   // uint16_t wPresetBagNdx;
-  InsertInt16L(out, preset_bag_index);
+  out = WriteInt16L(out, preset_bag_index);
 
   // uint32_t dwLibrary;
-  InsertInt32L(out, library);
+  out = WriteInt32L(out, library);
 
   // uint32_t dwGenre;
-  InsertInt32L(out, genre);
+  out = WriteInt32L(out, genre);
 
   // uint32_t dwMorphology;
-  InsertInt32L(out, morphology);
+  out = WriteInt32L(out, morphology);
 
   return out;
 }
@@ -36,6 +36,13 @@ public:
   SFRIFFPhdrChunk(
       const std::vector<std::shared_ptr<SFPreset>> & presets);
 
+  /// Constructs a new SFRIFFPhdrChunk using the specified presets and the planned number of items.
+  /// @param presets The presets of the chunk.
+  /// @param num_items the number of items, including the terminator.
+  SFRIFFPhdrChunk(
+      const std::vector<std::shared_ptr<SFPreset>> & presets,
+      size_type num_items);
+
   /// Constructs a new copy of specified SFRIFFPhdrChunk.
   /// @param origin a SFRIFFPhdrChunk object.
   SFRIFFPhdrChunk(const SFRIFFPhdrChunk & origin) = default;
@@ -82,11 +89,9 @@ public:
     return 8 + size_;
   }
 
-  /// Writes this chunk to the specified output stream.
-  /// @param out the output stream.
+  /// @copydoc RIFFChunkInterface::WriteTo()
   /// @throws std::length_error The chunk size exceeds the maximum.
-  /// @throws std::ios_base::failure An I/O error occurred.
-  virtual void Write(std::ostream & out) const override;
+  virtual char * WriteTo(char * out) const override;
 
 private:
   /// Returns the number of preset items.
@@ -95,7 +100,7 @@ private:
   uint16_t NumItems() const;
 
   /// Writes an item of phdr chunk.
-  /// @param out the output stream.
+  /// @param out a pointer to the buffer.
   /// @param name the name of preset.
   /// @param preset_number the preset number.
   /// @param bank the bank number.
@@ -103,9 +108,8 @@ private:
   /// @param library the library.
   /// @param genre the genre.
   /// @param morphology the morphology.
-  /// @return the output stream.
-  /// @throws std::ios_base::failure An I/O error occurred.
-  static std::ostream & WriteItem(std::ostream & out,
+  /// @return a pointer past the written item.
+  static char * WriteItem(char * out,
       const std::string & name,
       uint16_t preset_number,
       uint16_t bank,
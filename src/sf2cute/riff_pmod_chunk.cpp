@@ -6,10 +6,10 @@
 #include "riff_pmod_chunk.hpp"
 
 #include <stdint.h>
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <sstream>
-#include <ostream>
 #include <stdexcept>
 
 #include <sf2cute/preset.hpp>
@@ -32,53 +32,49 @@ SFRIFFPmodChunk::SFRIFFPmodChunk(
   size_ = kItemSize * NumItems();
 }
 
-/// Writes this chunk to the specified output stream.
-void SFRIFFPmodChunk::Write(std::ostream & out) const {
-  // Save exception bits of output stream.
-  const std::ios_base::iostate old_exception_bits = out.exceptions();
-  // Set exception bits to get output error as an exception.
-  out.exceptions(std::ios::badbit | std::ios::failbit);
-
-  try {
-    // Write the chunk header.
-    RIFFChunk::WriteHeader(out, name(), size_);
-
-    // Presets:
-    for (const auto & preset : presets()) {
-      // Global zone:
-      if (preset->has_global_zone()) {
-        // Write all the modulators in the global zone.
-        for (const auto & modulator : preset->global_zone().modulators()) {
-          WriteItem(out, modulator->source_op(), modulator->destination_op(),
-            modulator->amount(), modulator->amount_source_op(), modulator->transform_op());
-        }
-      }
+/// Constructs a new SFRIFFPmodChunk using the specified presets and the planned number of items.
+SFRIFFPmodChunk::SFRIFFPmodChunk(
+    const std::vector<std::shared_ptr<SFPreset>> & presets,
+    size_type num_items) :
+    size_(kItemSize * num_items),
+    presets_(&presets) {
+}
 
-      // Preset zones:
-      for (const auto & zone : preset->zones()) {
-        // Write all the modulators in the preset zone.
-        for (const auto & modulator : zone->modulators()) {
-          WriteItem(out, modulator->source_op(), modulator->destination_op(),
-            modulator->amount(), modulator->amount_source_op(), modulator->transform_op());
-        }
+/// Writes this chunk to the specified buffer.
+char * SFRIFFPmodChunk::WriteTo(char * out) const {
+  // Write the chunk header.
+  out = RIFFChunk::WriteHeader(out, name(), size_);
+
+  // Presets:
+  for (const auto & preset : presets()) {
+    // Global zone:
+    if (preset->has_global_zone()) {
+      // Write all the modulators in the global zone.
+      for (const auto & modulator : preset->global_zone().modulators()) {
+        out = WriteItem(out, modulator->source_op(), modulator->destination_op(),
+          modulator->amount(), modulator->amount_source_op(), modulator->transform_op());
       }
     }
 
-    // Write the last terminator item.
-    WriteItem(out, SFModulator(0), SFGenerator(0), 0, SFModulator(0), SFTransform(0));
-
-    // Write a padding byte if necessary.
-    if (size_ % 2 != 0) {
-      InsertInt8(out, 0);
+    // Preset zones:
+    for (const auto & zone : preset->zones()) {
+      // Write all the modulators in the preset zone.
+      for (const auto & modulator : zone->modulators()) {
+        out = WriteItem(out, modulator->source_op(), modulator->destination_op(),
+          modulator->amount(), modulator->amount_source_op(), modulator->transform_op());
+      }
     }
   }
-  catch (const std::exception &) {
-    // Recover exception bits of output stream.
-    out.exceptions(old_exception_bits);
 
-    // Rethrow the exception.
-    throw;
+  // Write the last terminator item.
+  out = WriteItem(out, SFModulator(0), SFGenerator(0), 0, SFModulator(0), SFTransform(0));
+
+  // Write a padding byte if necessary.
+  if (size_ % 2 != 0) {
+    out = WriteInt8(out, 0);
   }
+
+  return out;
 }
 
 /// Returns the number of preset modulator items.
@@ -105,7 +101,7 @@ uint16_t SFRIFFPmodChunk::NumItems() const {
 }
 
 /// Writes an item of pmod chunk.
-std::ostream & SFRIFFPmodChunk::WriteItem(std::ostream & out,
+char * SFRIFFPmodChunk::WriteItem(char * out,
     SFModulator source_op,
     SFGenerator destination_op,
     int16_t amount,
@@ -113,19 +109,19 @@ std::ostream & SFRIFFPmodChunk::WriteItem(std::ostream & out,
     SFTransform transform_op) {
   // struct sfModList:
   // SFModulator sfModSrcOper;
-  InsertInt16L(out, uint16_t(source_op));
+  out = WriteInt16L(out, uint16_t(source_op));
 
   // SFGenerator sfModDestOper;
-  InsertInt16L(out, uint16_t(destination_op));
+  out = WriteInt16L(out, uint16_t(destination_op));
 
   // int16_t modAmount;
-  InsertInt16L(out, amount);
+  out = WriteInt16L(out, amount);
 
   // SFModulator sfModAmtSrcOper;
-  InsertInt16L(out, uint16_t(amount_source_op));
+  out = WriteInt16L(out, uint16_t(amount_source_op));
 
   // SFTransform sfModTransOper;
-  InsertInt16L(out, uint16_t(transform_op));
+  out = WriteInt16L(out, uint16_t(transform_op));
 
   return out;
 }
@@ -39,6 +39,13 @@ public:
   SFRIFFPmodChunk(
       const std::vector<std::shared_ptr<SFPreset>> & presets);
 
+  /// Constructs a new SFRIFFPmodChunk using the specified presets and the planned number of items.
+  /// @param presets The presets of the chunk.
+  /// @param num_items the number of items, including the terminator.
+  SFRIFFPmodChunk(
+      const std::vector<std::shared_ptr<SFPreset>> & presets,
+      size_type num_items);
+
   /// Constructs a new copy of specified SFRIFFPmodChunk.
   /// @param origin a SFRIFFPmodChunk object.
   SFRIFFPmodChunk(const SFRIFFPmodChunk & origin) = default;
@@ -85,11 +92,9 @@ public:
     return 8 + size_;
   }
 
-  /// Writes this chunk to the specified output stream.
-  /// @param out the output stream.
+  /// @copydoc RIFFChunkInterface::WriteTo()
   /// @throws std::length_error The chunk size exceeds the maximum.
-  /// @throws std::ios_base::failure An I/O error occurred.
-  virtual void Write(std::ostream & out) const override;
+  virtual char * WriteTo(char * out) const override;
 
 private:
   /// Returns the number of preset modulator items.
@@ -98,15 +103,14 @@ private:
   uint16_t NumItems() const;
 
   /// Writes an item of pmod chunk.
-  /// @param out the output stream.
+  /// @param out a pointer to the buffer.
   /// @param source_op the source of data for the modulator.
   /// @param destination_op the destination of the modulator.
   /// @param amount the degree to which the source modulates the destination.
   /// @param amount_source_op the modulation source to be applied to the modulation amount.
   /// @param transform_op the transform type to be applied to the modulation source.
-  /// @return the output stream.
-  /// @throws std::ios_base::failure An I/O error occurred.
-  static std::ostream & WriteItem(std::ostream & out,
+  /// @return a pointer past the written item.
+  static char * WriteItem(char * out,
       SFModulator source_op,
       SFGenerator destination_op,
       int16_t amount,
@@ -6,11 +6,11 @@
 #ifndef SF2CUTE_RIFF_SHDR_CHUNK_HPP_
 #define SF2CUTE_RIFF_SHDR_CHUNK_HPP_
 
+#include <stdint.h>
 #include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <ostream>
 
 #include <sf2cute/types.hpp>
@@ -31,15 +31,22 @@ public:
   /// The item size of shdr chunk, in terms of bytes.
   static constexpr size_type kItemSize = 46;
 
+  /// The flag of the sample type for a compressed sample of an SF3 file.
+  static constexpr uint16_t kCompressedSampleFlag = 0x10;
+
   /// Constructs a new empty SFRIFFShdrChunk.
   SFRIFFShdrChunk();
 
   /// Constructs a new SFRIFFShdrChunk using the specified samples.
   /// @param samples The samples of the chunk.
-  /// @param sample_index_map the map containing the samples as keys and their indices as map values.
   /// @throws std::length_error Too many samples.
+  explicit SFRIFFShdrChunk(const std::vector<std::shared_ptr<SFSample>> & samples);
+
+  /// Constructs a new SFRIFFShdrChunk using the specified samples and the planned number of items.
+  /// @param samples The samples of the chunk.
+  /// @param num_items the number of items, including the terminator.
   SFRIFFShdrChunk(const std::vector<std::shared_ptr<SFSample>> & samples,
-      std::unordered_map<const SFSample *, uint16_t> sample_index_map);
+      size_type num_items);
 
   /// Constructs a new copy of specified SFRIFFShdrChunk.
   /// @param origin a SFRIFFShdrChunk object.
@@ -79,16 +86,35 @@ public:
     size_ = kItemSize * NumItems();
   }
 
-  /// Returns the map containing the samples as keys and their indices as map values.
-  /// @return the map containing the samples as keys and their indices as map values.
-  const std::unordered_map<const SFSample *, uint16_t> & sample_index_map() const {
-    return sample_index_map_;
+  /// Returns the positions of the samples in the sample pool.
+  /// @return the index of the first datapoint of each sample, or nullptr if
+  /// the samples are stored one after another in the order of the list.
+  const std::vector<size_type> * sample_starts() const noexcept {
+    return sample_starts_;
+  }
+
+  /// Sets the positions of the samples in the sample pool.
+  /// @param sample_starts the index of the first datapoint of each sample,
+  /// or nullptr if the samples are stored one after another in the order of the list.
+  void set_sample_starts(const std::vector<size_type> * sample_starts) noexcept {
+    sample_starts_ = sample_starts;
+  }
+
+  /// Returns the ends of the encoded samples in the sample pool.
+  /// @return the offset past the encoded stream of each sample, in terms of
+  /// bytes, or nullptr if the sample pool holds datapoints.
+  const std::vector<size_type> * sample_ends() const noexcept {
+    return sample_ends_;
   }
 
-  /// Sets the map containing the samples as keys and their indices as map values.
-  /// @param sample_index_map the map containing the samples as keys and their indices as map values.
-  void set_sample_index_map(std::unordered_map<const SFSample *, uint16_t> sample_index_map) {
-    sample_index_map_ = std::move(sample_index_map);
+  /// Sets the ends of the encoded samples in the sample pool.
+  /// @param sample_ends the offset past the encoded stream of each sample,
+  /// or nullptr if the sample pool holds datapoints.
+  /// @remarks With encoded samples, the sample starts are byte offsets, the
+  /// loop points are relative to the sample and the samples are flagged as
+  /// compressed, as SF3 files require.
+  void set_sample_ends(const std::vector<size_type> * sample_ends) noexcept {
+    sample_ends_ = sample_ends;
   }
 
   /// Returns the whole length of this chunk.
@@ -97,12 +123,10 @@ public:
     return 8 + size_;
   }
 
-  /// Writes this chunk to the specified output stream.
-  /// @param out the output stream.
+  /// @copydoc RIFFChunkInterface::WriteTo()
   /// @throws std::length_error The chunk size exceeds the maximum.
   /// @throws std::out_of_range Sample has a link to an unknown sample.
-  /// @throws std::ios_base::failure An I/O error occurred.
-  virtual void Write(std::ostream & out) const override;
+  virtual char * WriteTo(char * out) const override;
 
 private:
   /// Returns the number of sample header items.
@@ -111,7 +135,7 @@ private:
   uint16_t NumItems() const;
 
   /// Writes an item of shdr chunk.
-  /// @param out the output stream.
+  /// @param out a pointer to the buffer.
   /// @param name the name of sample.
   /// @param start the beginning index of the sample, in sample data points, inclusive.
   /// @param end the ending index of the sample, in sample data points, exclusive.
@@ -122,9 +146,8 @@ private:
   /// @param correction the pitch correction that should be applied to the sample, in cents.
   /// @param link the associated right or left stereo sample. nullptr is allowed.
   /// @param type both the type of sample and the whether the sample is located in RAM or ROM memory.
-  /// @return the output stream.
-  /// @throws std::ios_base::failure An I/O error occurred.
-  static std::ostream & WriteItem(std::ostream & out,
+  /// @return a pointer past the written item.
+  static char * WriteItem(char * out,
       const std::string & name, uint32_t start, uint32_t end,
       uint32_t start_loop, uint32_t end_loop, uint32_t sample_rate,
       uint8_t original_key, int8_t correction, uint16_t link, SFSampleLink type);
@@ -135,8 +158,11 @@ private:
   /// The samples of the chunk.
   const std::vector<std::shared_ptr<SFSample>> * samples_;
 
-  /// The map containing the samples as keys and their indices as map values.
-  std::unordered_map<const SFSample *, uint16_t> sample_index_map_;
+  /// The positions of the samples in the sample pool.
+  const std::vector<size_type> * sample_starts_;
+
+  /// The ends of the encoded samples in the sample pool.
+  const std::vector<size_type> * sample_ends_;
 };
 
 } // namespace sf2cute
@@ -6,8 +6,11 @@
 #include "riff_smpl_chunk.hpp"
 
 #include <stdint.h>
+#include <string.h>
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <vector>
 #include <ostream>
 #include <stdexcept>
 
@@ -20,16 +23,27 @@ namespace sf2cute {
 /// Constructs a new empty SFRIFFSmplChunk.
 SFRIFFSmplChunk::SFRIFFSmplChunk() :
     size_(0),
-    samples_(nullptr) {
+    samples_(nullptr),
+    encoded_samples_(nullptr) {
 }
 
 /// Constructs a new SFRIFFSmplChunk using the specified samples.
 SFRIFFSmplChunk::SFRIFFSmplChunk(
     const std::vector<std::shared_ptr<SFSample>> & samples) :
-    samples_(&samples) {
+    samples_(&samples),
+    encoded_samples_(nullptr) {
   size_ = GetSamplePoolSize();
 }
 
+/// Constructs a new SFRIFFSmplChunk using the specified samples and the planned pool size.
+SFRIFFSmplChunk::SFRIFFSmplChunk(
+    const std::vector<std::shared_ptr<SFSample>> & samples,
+    size_type pool_size) :
+    size_(pool_size),
+    samples_(&samples),
+    encoded_samples_(nullptr) {
+}
+
 /// Writes this chunk to the specified output stream.
 void SFRIFFSmplChunk::Write(std::ostream & out) const {
   // Save exception bits of output stream.
@@ -42,15 +56,21 @@ void SFRIFFSmplChunk::Write(std::ostream & out) const {
     RIFFChunk::WriteHeader(out, name(), size_);
 
     // Write the chunk data.
-    for (const auto & sample : samples()) {
-      // Write the samples.
-      for (int16_t value : sample->data()) {
-        InsertInt16L(out, value);
+    if (encoded_samples_ != nullptr) {
+      // Write the encoded streams, which need no terminator samples.
+      for (const auto & stream : *encoded_samples_) {
+        out.write(stream.data(), std::streamsize(stream.size()));
       }
+    }
+    else {
+      static const char kTerminator[sizeof(int16_t) * SFSample::kTerminatorSampleLength] = {};
+      std::vector<uint16_t> buffer;
+      for (const auto & sample : samples()) {
+        // Write the samples.
+        WriteSampleData(out, sample->data(), buffer);
 
-      // Write terminator samples.
-      for (uint32_t index = 0; index < SFSample::kTerminatorSampleLength; index++) {
-        InsertInt16L(out, 0);
+        // Write terminator samples.
+        out.write(kTerminator, sizeof(kTerminator));
       }
     }
 
@@ -68,6 +88,96 @@ void SFRIFFSmplChunk::Write(std::ostream & out) const {
   }
 }
 
+/// Writes this chunk to the specified buffer.
+char * SFRIFFSmplChunk::WriteTo(char * out) const {
+  // Write the chunk header.
+  out = RIFFChunk::WriteHeader(out, name(), size_);
+
+  // Write the chunk data.
+  if (encoded_samples_ != nullptr) {
+    // Write the encoded streams, which need no terminator samples.
+    for (const auto & stream : *encoded_samples_) {
+      out = std::copy(stream.begin(), stream.end(), out);
+    }
+  }
+  else {
+    std::vector<uint16_t> buffer;
+    for (const auto & sample : samples()) {
+      // Write the samples.
+      out = WriteSampleData(out, sample->data(), buffer);
+
+      // Write terminator samples.
+      out = std::fill_n(out, sizeof(int16_t) * SFSample::kTerminatorSampleLength, '\0');
+    }
+  }
+
+  // Write a padding byte if necessary.
+  if (size_ % 2 != 0) {
+    out = WriteInt8(out, 0);
+  }
+  return out;
+}
+
+/// Writes sample datapoints in little-endian order.
+void SFRIFFSmplChunk::WriteSampleData(std::ostream & out,
+    const SFSampleData & data,
+    std::vector<uint16_t> & buffer) {
+  // The in-memory representation is already the file representation
+  // on little-endian hosts, so the whole buffer can be written at once.
+  if (IsLittleEndianHost() && !data.is_streamed()) {
+    out.write(reinterpret_cast<const char *>(data.data()),
+      std::streamsize(sizeof(int16_t) * data.size()));
+    return;
+  }
+
+  // Otherwise pull and swap the datapoints block by block, reusing the
+  // staging buffer, so that a streamed sample is never resident as a whole.
+  buffer.resize(kWriteBlockLength);
+  for (size_type offset = 0; offset < data.size(); offset += kWriteBlockLength) {
+    const size_type remaining = data.size() - offset;
+    const size_type length = remaining < kWriteBlockLength ? remaining : kWriteBlockLength;
+    ReadBlock(data, offset, length, buffer);
+    out.write(reinterpret_cast<const char *>(buffer.data()),
+      std::streamsize(sizeof(uint16_t) * length));
+  }
+}
+
+/// Writes sample datapoints in little-endian order.
+char * SFRIFFSmplChunk::WriteSampleData(char * out,
+    const SFSampleData & data,
+    std::vector<uint16_t> & buffer) {
+  if (IsLittleEndianHost() && !data.is_streamed()) {
+    if (!data.empty()) {
+      memcpy(out, data.data(), sizeof(int16_t) * data.size());
+    }
+    return out + sizeof(int16_t) * data.size();
+  }
+
+  buffer.resize(kWriteBlockLength);
+  for (size_type offset = 0; offset < data.size(); offset += kWriteBlockLength) {
+    const size_type remaining = data.size() - offset;
+    const size_type length = remaining < kWriteBlockLength ? remaining : kWriteBlockLength;
+    ReadBlock(data, offset, length, buffer);
+    memcpy(out, buffer.data(), sizeof(uint16_t) * length);
+    out += sizeof(uint16_t) * length;
+  }
+  return out;
+}
+
+/// Pulls a block of sample datapoints, and converts them to little-endian order.
+void SFRIFFSmplChunk::ReadBlock(const SFSampleData & data,
+    size_type offset,
+    size_type length,
+    std::vector<uint16_t> & buffer) {
+  data.Read(offset, reinterpret_cast<int16_t *>(buffer.data()), length);
+  if (!IsLittleEndianHost()) {
+    for (size_type index = 0; index < length; index++) {
+      const uint16_t value = buffer[index];
+      buffer[index] = static_cast<uint16_t>((value >> 8) | (value << 8));
+    }
+  }
+}
+
 /// Returns the total sample pool size.
 SFRIFFSmplChunk::size_type SFRIFFSmplChunk::GetSamplePoolSize() const {
   SFRIFFSmplChunk::size_type size = 0;
@@ -6,6 +6,7 @@
 #ifndef SF2CUTE_RIFF_SMPL_CHUNK_HPP_
 #define SF2CUTE_RIFF_SMPL_CHUNK_HPP_
 
+#include <stdint.h>
 #include <memory>
 #include <string>
 #include <vector>
@@ -16,6 +17,7 @@
 namespace sf2cute {
 
 class SFSample;
+class SFSampleData;
 
 /// The SFRIFFSmplChunk class represents a SoundFont 2 "smpl" chunk.
 class SFRIFFSmplChunk : public RIFFChunkInterface {
@@ -23,6 +25,9 @@ public:
   /// Unsigned integer type for the chunk size.
   using size_type = RIFFChunkInterface::size_type;
 
+  /// The number of sample datapoints written to the stream at once.
+  static constexpr size_type kWriteBlockLength = 32768;
+
   /// Constructs a new empty SFRIFFSmplChunk.
   SFRIFFSmplChunk();
 
@@ -31,6 +36,12 @@ public:
   /// @throws std::length_error The sample pool size exceeds the maximum.
   SFRIFFSmplChunk(const std::vector<std::shared_ptr<SFSample>> & samples);
 
+  /// Constructs a new SFRIFFSmplChunk using the specified samples and the planned pool size.
+  /// @param samples The samples of the chunk.
+  /// @param pool_size the total sample pool size, in terms of bytes.
+  SFRIFFSmplChunk(const std::vector<std::shared_ptr<SFSample>> & samples,
+      size_type pool_size);
+
   /// Constructs a new copy of specified SFRIFFSmplChunk.
   /// @param origin a SFRIFFSmplChunk object.
   SFRIFFSmplChunk(const SFRIFFSmplChunk & origin) = default;
@@ -69,10 +80,31 @@ public:
     size_ = GetSamplePoolSize();
   }
 
+  /// Returns the encoded samples of this chunk.
+  /// @return the encoded stream of each sample, or nullptr if the datapoints are written.
+  const std::vector<std::vector<char>> * encoded_samples() const noexcept {
+    return encoded_samples_;
+  }
+
+  /// Sets the encoded samples of this chunk.
+  /// @param encoded_samples the encoded stream of each sample, written in
+  /// place of the datapoints, or nullptr to write the datapoints.
+  /// @remarks The size of the chunk is not updated; it must be the planned pool size.
+  void set_encoded_samples(const std::vector<std::vector<char>> * encoded_samples) noexcept {
+    encoded_samples_ = encoded_samples;
+  }
+
+  /// Returns the length of the chunk data, as written in the chunk header.
+  /// @return the size of the sample pool without the padding byte, in terms of bytes.
+  size_type data_size() const noexcept {
+    return size_;
+  }
+
   /// Returns the whole length of this chunk.
   /// @return the length of this chunk including a chunk header, in terms of bytes.
   virtual size_type size() const noexcept override {
-    return 8 + size_;
+    // An encoded sample pool may have an odd size.
+    return 8 + size_ + (size_ % 2);
   }
 
   /// Writes this chunk to the specified output stream.
@@ -81,7 +113,43 @@ public:
   /// @throws std::ios_base::failure An I/O error occurred.
   virtual void Write(std::ostream & out) const override;
 
+  /// @copydoc RIFFChunkInterface::WriteTo()
+  /// @throws std::ios_base::failure An I/O error occurred while reading a sample source.
+  virtual char * WriteTo(char * out) const override;
+
 private:
+  /// Writes sample datapoints in little-endian order.
+  /// @param out the output stream.
+  /// @param data the sample datapoints.
+  /// @param buffer the staging buffer used for streamed datapoints and
+  /// for the byte-swap on big-endian hosts.
+  /// @throws std::ios_base::failure An I/O error occurred.
+  static void WriteSampleData(std::ostream & out,
+      const SFSampleData & data,
+      std::vector<uint16_t> & buffer);
+
+  /// Writes sample datapoints in little-endian order.
+  /// @param out a pointer to the buffer.
+  /// @param data the sample datapoints.
+  /// @param buffer the staging buffer used for streamed datapoints and
+  /// for the byte-swap on big-endian hosts.
+  /// @return a pointer past the written datapoints.
+  /// @throws std::ios_base::failure An I/O error occurred while reading a sample source.
+  static char * WriteSampleData(char * out,
+      const SFSampleData & data,
+      std::vector<uint16_t> & buffer);
+
+  /// Pulls a block of sample datapoints, and converts them to little-endian order.
+  /// @param data the sample datapoints.
+  /// @param offset the index of the first datapoint of the block.
+  /// @param length the number of datapoints in the block.
+  /// @param buffer the staging buffer, with room for length datapoints.
+  /// @throws std::ios_base::failure An I/O error occurred while reading a sample source.
+  static void ReadBlock(const SFSampleData & data,
+      size_type offset,
+      size_type length,
+      std::vector<uint16_t> & buffer);
+
   /// Returns the total sample pool size.
   /// @return the total sample pool size.
   /// @throws std::length_error The sample pool size exceeds the maximum.
@@ -92,6 +160,9 @@ private:
 
   /// The samples of the chunk.
   const std::vector<std::shared_ptr<SFSample>> * samples_;
+
+  /// The encoded streams of the samples.
+  const std::vector<std::vector<char>> * encoded_samples_;
 };
 
 } // namespace sf2cute
@@ -9,8 +9,11 @@
 #include <memory>
 #include <algorithm>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <sf2cute/file.hpp>
+
 namespace sf2cute {
 
 /// Constructs a new empty SFSample.
@@ -22,7 +25,8 @@ SFSample::SFSample() :
     correction_(0),
     link_(),
     type_(SFSampleLink::kMonoSample),
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
 }
 
 /// Constructs a new empty SFSample using the specified name.
@@ -35,12 +39,13 @@ SFSample::SFSample(std::string name) :
     correction_(0),
     link_(),
     type_(SFSampleLink::kMonoSample),
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
 }
 
 /// Constructs a new SFSample.
 SFSample::SFSample(std::string name,
-    std::vector<int16_t> data,
+    SFSampleData data,
     uint32_t start_loop,
     uint32_t end_loop,
     uint32_t sample_rate,
@@ -55,12 +60,13 @@ SFSample::SFSample(std::string name,
     correction_(std::move(correction)),
     link_(),
     type_(SFSampleLink::kMonoSample),
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
 }
 
 /// Constructs a new SFSample with a sample link.
 SFSample::SFSample(std::string name,
-    std::vector<int16_t> data,
+    SFSampleData data,
     uint32_t start_loop,
     uint32_t end_loop,
     uint32_t sample_rate,
@@ -77,7 +83,8 @@ SFSample::SFSample(std::string name,
     correction_(std::move(correction)),
     link_(std::move(link)),
     type_(std::move(type)),
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
 }
 
 /// Constructs a new copy of specified SFSample.
@@ -91,12 +98,18 @@ SFSample::SFSample(const SFSample & origin) :
     correction_(origin.correction_),
     link_(origin.link_),
     type_(origin.type_),
-    parent_file_(nullptr) {
+    parent_file_(nullptr),
+    file_index_(0) {
 }
 
 /// Copy-assigns a new value to the SFSample, replacing its current contents.
 SFSample & SFSample::operator=(const SFSample & origin) {
-  name_ = origin.name_;
+  // The sample stays in its file, under the new name.
+  std::string name = origin.name_;
+  if (parent_file_ != nullptr) {
+    parent_file_->UnindexElement(*this);
+  }
+  name_ = std::move(name);
   data_ = origin.data_;
   start_loop_ = origin.start_loop_;
   end_loop_ = origin.end_loop_;
@@ -105,8 +118,57 @@ SFSample & SFSample::operator=(const SFSample & origin) {
   correction_ = origin.correction_;
   link_ = origin.link_;
   type_ = origin.type_;
-  parent_file_ = nullptr;
+  if (parent_file_ != nullptr) {
+    parent_file_->IndexElement(*this);
+  }
+  return *this;
+}
+
+/// Acquires the contents of specified SFSample.
+SFSample::SFSample(SFSample && origin) noexcept :
+    name_(std::move(origin.name_)),
+    start_loop_(std::move(origin.start_loop_)),
+    end_loop_(std::move(origin.end_loop_)),
+    sample_rate_(std::move(origin.sample_rate_)),
+    original_key_(std::move(origin.original_key_)),
+    correction_(std::move(origin.correction_)),
+    link_(std::move(origin.link_)),
+    type_(std::move(origin.type_)),
+    data_(std::move(origin.data_)),
+    parent_file_(nullptr),
+    file_index_(0) {
+}
+
+/// Move-assigns a new value to the SFSample, replacing its current contents.
+SFSample & SFSample::operator=(SFSample && origin) noexcept {
+  // The sample stays in its file, under the new name.
+  if (parent_file_ != nullptr) {
+    parent_file_->UnindexElement(*this);
+  }
+  name_ = std::move(origin.name_);
+  data_ = std::move(origin.data_);
+  start_loop_ = std::move(origin.start_loop_);
+  end_loop_ = std::move(origin.end_loop_);
+  sample_rate_ = std::move(origin.sample_rate_);
+  original_key_ = std::move(origin.original_key_);
+  correction_ = std::move(origin.correction_);
+  link_ = std::move(origin.link_);
+  type_ = std::move(origin.type_);
+  if (parent_file_ != nullptr) {
+    parent_file_->IndexElement(*this);
+  }
   return *this;
 }
 
+/// Sets the name of this sample.
+void SFSample::set_name(std::string name) {
+  if (parent_file_ != nullptr) {
+    parent_file_->UnindexElement(*this);
+  }
+  name_ = std::move(name);
+  if (parent_file_ != nullptr) {
+    parent_file_->IndexElement(*this);
+  }
+}
+
 } // namespace sf2cute
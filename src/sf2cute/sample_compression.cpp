@@ -0,0 +1,300 @@
+/// @file
+/// Lossless sample compression helper implementation.
+///
+/// @author gocha <https://github.com/gocha>
+
+#include "sample_compression.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+
+namespace sf2cute {
+
+namespace {
+
+/// The highest order of the fixed predictors.
+constexpr size_t kMaxPredictorOrder = 4;
+
+/// The method of a block stored without compression.
+constexpr uint8_t kVerbatimMethod = 0xff;
+
+/// The highest Rice parameter.
+constexpr uint32_t kMaxRiceParameter = 24;
+
+/// The unary quotient that marks a residual stored in 32 bits.
+constexpr uint32_t kEscapeQuotient = 32;
+
+/// Returns the residual of a datapoint against a fixed predictor.
+/// @param data the datapoints.
+/// @param index the index of the datapoint, at least order.
+/// @param order the order of the predictor.
+/// @return the residual.
+int32_t Residual(const int16_t * data, size_t index, size_t order) noexcept {
+  const int32_t x0 = data[index];
+  switch (order) {
+  case 0:
+    return x0;
+  case 1:
+    return x0 - data[index - 1];
+  case 2:
+    return x0 - 2 * data[index - 1] + data[index - 2];
+  case 3:
+    return x0 - 3 * data[index - 1] + 3 * data[index - 2] - data[index - 3];
+  default:
+    return x0 - 4 * data[index - 1] + 6 * data[index - 2] -
+        4 * data[index - 3] + data[index - 4];
+  }
+}
+
+/// Returns the prediction of a fixed predictor.
+/// @param data the decoded datapoints.
+/// @param index the index of the datapoint, at least order.
+/// @param order the order of the predictor.
+/// @return the predicted datapoint.
+int32_t Predict(const int16_t * data, size_t index, size_t order) noexcept {
+  switch (order) {
+  case 0:
+    return 0;
+  case 1:
+    return data[index - 1];
+  case 2:
+    return 2 * data[index - 1] - data[index - 2];
+  case 3:
+    return 3 * data[index - 1] - 3 * data[index - 2] + data[index - 3];
+  default:
+    return 4 * data[index - 1] - 6 * data[index - 2] +
+        4 * data[index - 3] - data[index - 4];
+  }
+}
+
+/// Maps a signed residual to an unsigned value, small magnitudes first.
+uint32_t ZigZagEncode(int32_t value) noexcept {
+  return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+/// Maps an unsigned value back to a signed residual.
+int32_t ZigZagDecode(uint32_t value) noexcept {
+  return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+/// The BitWriter class appends bits to a byte buffer, most significant first.
+class BitWriter {
+public:
+  /// Constructs a new BitWriter.
+  /// @param out the buffer that receives the bytes.
+  explicit BitWriter(std::vector<uint8_t> & out) noexcept :
+      out_(out),
+      bits_(0),
+      num_bits_(0) {
+  }
+
+  /// Writes the lowest bits of a value.
+  /// @param value the value.
+  /// @param num_bits the number of bits, at most 32.
+  void Write(uint32_t value, uint32_t num_bits) {
+    if (num_bits == 0) {
+      return;
+    }
+    bits_ = (bits_ << num_bits) | (value & (UINT64_MAX >> (64 - num_bits)));
+    num_bits_ += num_bits;
+    while (num_bits_ >= 8) {
+      num_bits_ -= 8;
+      out_.push_back(static_cast<uint8_t>(bits_ >> num_bits_));
+    }
+  }
+
+  /// Writes the pending bits, padded with zeros to a byte.
+  void Flush() {
+    if (num_bits_ != 0) {
+      out_.push_back(static_cast<uint8_t>(bits_ << (8 - num_bits_)));
+      num_bits_ = 0;
+    }
+  }
+
+private:
+  /// The buffer that receives the bytes.
+  std::vector<uint8_t> & out_;
+
+  /// The pending bits.
+  uint64_t bits_;
+
+  /// The number of pending bits.
+  uint32_t num_bits_;
+};
+
+/// The BitReader class reads bits from a byte buffer, most significant first.
+///
+/// Reading past the end of the buffer yields zeros.
+class BitReader {
+public:
+  /// Constructs a new BitReader.
+  /// @param data the buffer.
+  /// @param size the size of the buffer, in terms of bytes.
+  BitReader(const uint8_t * data, size_t size) noexcept :
+      data_(data),
+      end_(data + size),
+      bits_(0),
+      num_bits_(0) {
+  }
+
+  /// Reads a value.
+  /// @param num_bits the number of bits, at most 32.
+  /// @return the value.
+  uint32_t Read(uint32_t num_bits) noexcept {
+    if (num_bits == 0) {
+      return 0;
+    }
+    while (num_bits_ < num_bits) {
+      bits_ = (bits_ << 8) | (data_ != end_ ? *data_++ : 0);
+      num_bits_ += 8;
+    }
+    num_bits_ -= num_bits;
+    return static_cast<uint32_t>((bits_ >> num_bits_) & (UINT64_MAX >> (64 - num_bits)));
+  }
+
+  /// Reads a unary quotient.
+  /// @param limit the largest quotient.
+  /// @return the number of one bits before a zero bit, or limit.
+  uint32_t ReadUnary(uint32_t limit) noexcept {
+    uint32_t quotient = 0;
+    while (quotient < limit && Read(1) != 0) {
+      quotient++;
+    }
+    return quotient;
+  }
+
+private:
+  /// The next byte.
+  const uint8_t * data_;
+
+  /// The end of the buffer.
+  const uint8_t * end_;
+
+  /// The pending bits.
+  uint64_t bits_;
+
+  /// The number of pending bits.
+  uint32_t num_bits_;
+};
+
+/// Appends a datapoint in little-endian order.
+void AppendDatapoint(std::vector<uint8_t> & out, int16_t value) {
+  const uint16_t bits = static_cast<uint16_t>(value);
+  out.push_back(static_cast<uint8_t>(bits & 0xff));
+  out.push_back(static_cast<uint8_t>(bits >> 8));
+}
+
+/// Reads a datapoint in little-endian order.
+int16_t ReadDatapoint(const uint8_t * data) noexcept {
+  return static_cast<int16_t>(uint16_t(data[0]) | (uint16_t(data[1]) << 8));
+}
+
+} // namespace
+
+/// Compresses a block of datapoints, and appends it to a buffer.
+void CompressSampleBlock(const int16_t * data, size_t length, std::vector<uint8_t> & out) {
+  const size_t block_start = out.size();
+
+  // Find the predictor that leaves the smallest residuals,
+  // compared over the datapoints every predictor can predict.
+  size_t order = 0;
+  uint64_t residual_sum = UINT64_MAX;
+  if (length > kMaxPredictorOrder) {
+    for (size_t candidate = 0; candidate <= kMaxPredictorOrder; candidate++) {
+      uint64_t sum = 0;
+      for (size_t index = kMaxPredictorOrder; index < length; index++) {
+        sum += ZigZagEncode(Residual(data, index, candidate));
+      }
+      if (sum < residual_sum) {
+        order = candidate;
+        residual_sum = sum;
+      }
+    }
+  }
+
+  if (length > kMaxPredictorOrder) {
+    // Estimate the Rice parameter from the mean of the residuals.
+    const uint64_t num_residuals = length - kMaxPredictorOrder;
+    uint32_t parameter = 0;
+    while (parameter < kMaxRiceParameter && (num_residuals << (parameter + 1)) < residual_sum) {
+      parameter++;
+    }
+
+    // Write the method, the Rice parameter and the warm-up datapoints.
+    out.push_back(static_cast<uint8_t>(order));
+    out.push_back(static_cast<uint8_t>(parameter));
+    for (size_t index = 0; index < order; index++) {
+      AppendDatapoint(out, data[index]);
+    }
+
+    // Write the residuals.
+    BitWriter writer(out);
+    for (size_t index = order; index < length; index++) {
+      const uint32_t value = ZigZagEncode(Residual(data, index, order));
+      const uint32_t quotient = value >> parameter;
+      if (quotient < kEscapeQuotient) {
+        writer.Write(UINT32_MAX, quotient);
+        writer.Write(0, 1);
+        writer.Write(value, parameter);
+      }
+      else {
+        writer.Write(UINT32_MAX, kEscapeQuotient);
+        writer.Write(value, 32);
+      }
+    }
+    writer.Flush();
+
+    if (out.size() - block_start < 1 + sizeof(int16_t) * length) {
+      return;
+    }
+    out.resize(block_start);
+  }
+
+  // Store the block verbatim, since it does not shrink.
+  out.push_back(kVerbatimMethod);
+  for (size_t index = 0; index < length; index++) {
+    AppendDatapoint(out, data[index]);
+  }
+}
+
+/// Decompresses a block of datapoints.
+void DecompressSampleBlock(const uint8_t * data, size_t size, int16_t * out, size_t length) {
+  if (size == 0) {
+    std::fill_n(out, length, int16_t(0));
+    return;
+  }
+
+  const uint8_t method = data[0];
+  if (method == kVerbatimMethod) {
+    for (size_t index = 0; index < length; index++) {
+      out[index] = ReadDatapoint(data + 1 + sizeof(int16_t) * index);
+    }
+    return;
+  }
+
+  // Read the Rice parameter and the warm-up datapoints.
+  const size_t order = std::min<size_t>(method, kMaxPredictorOrder);
+  const uint32_t parameter = data[1];
+  for (size_t index = 0; index < order; index++) {
+    out[index] = ReadDatapoint(data + 2 + sizeof(int16_t) * index);
+  }
+
+  // Read the residuals, and undo the prediction.
+  const size_t header_size = 2 + sizeof(int16_t) * order;
+  BitReader reader(data + header_size, size - header_size);
+  for (size_t index = order; index < length; index++) {
+    uint32_t value;
+    const uint32_t quotient = reader.ReadUnary(kEscapeQuotient);
+    if (quotient < kEscapeQuotient) {
+      value = (quotient << parameter) | reader.Read(parameter);
+    }
+    else {
+      value = reader.Read(32);
+    }
+    out[index] = static_cast<int16_t>(Predict(out, index, order) + ZigZagDecode(value));
+  }
+}
+
+} // namespace sf2cute
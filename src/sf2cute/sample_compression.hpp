@@ -0,0 +1,40 @@
+/// @file
+/// Lossless sample compression helper header.
+///
+/// @author gocha <https://github.com/gocha>
+
+#ifndef SF2CUTE_SAMPLE_COMPRESSION_HPP_
+#define SF2CUTE_SAMPLE_COMPRESSION_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace sf2cute {
+
+/// The number of datapoints in a compressed block.
+///
+/// The sample pool is written in multiples of this length, so a block is
+/// decoded once per write.
+constexpr size_t kCompressedBlockLength = 4096;
+
+/// Compresses a block of datapoints, and appends it to a buffer.
+///
+/// Each block is predicted by the fixed polynomial predictor of order 0 to 4
+/// that leaves the smallest residuals, and the residuals are Rice coded.
+/// A block that does not shrink is stored verbatim.
+/// @param data the datapoints.
+/// @param length the number of datapoints, at most kCompressedBlockLength.
+/// @param out the buffer that receives the compressed block.
+void CompressSampleBlock(const int16_t * data, size_t length, std::vector<uint8_t> & out);
+
+/// Decompresses a block of datapoints.
+/// @param data the compressed block.
+/// @param size the size of the compressed block, in terms of bytes.
+/// @param out the buffer that receives the datapoints.
+/// @param length the number of datapoints in the block.
+void DecompressSampleBlock(const uint8_t * data, size_t size, int16_t * out, size_t length);
+
+} // namespace sf2cute
+
+#endif // SF2CUTE_SAMPLE_COMPRESSION_HPP_
@@ -0,0 +1,85 @@
+/// @file
+/// SoundFont 2 Sample data class implementation.
+///
+/// @author gocha <https://github.com/gocha>
+
+#include <sf2cute/sample_data.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <stdexcept>
+
+namespace sf2cute {
+
+/// Constructs a new empty SFSampleData.
+SFSampleData::SFSampleData() noexcept :
+    view_size_(0) {
+}
+
+/// Constructs a new SFSampleData that owns the specified datapoints.
+SFSampleData::SFSampleData(std::vector<int16_t> data) :
+    view_size_(0) {
+  if (!data.empty()) {
+    owned_ = std::make_shared<const std::vector<int16_t>>(std::move(data));
+  }
+}
+
+/// Constructs a new SFSampleData that views a read-only buffer.
+SFSampleData::SFSampleData(const int16_t * data,
+    size_type size,
+    std::shared_ptr<const void> buffer) noexcept :
+    view_(buffer, data),
+    view_size_(size) {
+}
+
+/// Constructs a new SFSampleData that views a shared vector.
+SFSampleData::SFSampleData(std::shared_ptr<const std::vector<int16_t>> data) noexcept :
+    view_(data, data != nullptr ? data->data() : nullptr),
+    view_size_(data != nullptr ? data->size() : 0) {
+}
+
+/// Constructs a new SFSampleData that streams the datapoints from a source.
+SFSampleData::SFSampleData(std::shared_ptr<const SFSampleSource> source) noexcept :
+    view_size_(0),
+    source_(std::move(source)) {
+}
+
+/// Copies datapoints to a buffer, pulling them from the source if streamed.
+void SFSampleData::Read(size_type offset, int16_t * buffer, size_type length) const {
+  if (source_) {
+    source_->Read(offset, buffer, length);
+    return;
+  }
+
+  if (offset > size() || length > size() - offset) {
+    throw std::out_of_range("The range exceeds the number of datapoints.");
+  }
+  std::copy(data() + offset, data() + offset + length, buffer);
+}
+
+/// Replaces resident datapoints with a losslessly compressed copy.
+void SFSampleData::Compress() {
+  if (source_ || empty()) {
+    return;
+  }
+
+  source_ = SFSampleSource::Compress(data(), size());
+  owned_.reset();
+  view_.reset();
+  view_size_ = 0;
+}
+
+/// Returns a copy of the datapoints.
+std::vector<int16_t> SFSampleData::ToVector() const {
+  if (source_) {
+    std::vector<int16_t> datapoints(source_->size());
+    source_->Read(0, datapoints.data(), datapoints.size());
+    return datapoints;
+  }
+  return std::vector<int16_t>(begin(), end());
+}
+
+} // namespace sf2cute
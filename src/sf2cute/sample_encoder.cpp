@@ -0,0 +1,183 @@
+/// @file
+/// SoundFont 2 Sample encoder class implementation.
+///
+/// @author gocha <https://github.com/gocha>
+
+#include <sf2cute/sample_encoder.hpp>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+#include <stdexcept>
+
+#include <sf2cute/sample.hpp>
+
+#if defined(SF2CUTE_HAVE_VORBIS)
+#include <vorbis/vorbisenc.h>
+#endif
+
+namespace sf2cute {
+
+#if defined(SF2CUTE_HAVE_VORBIS)
+
+namespace {
+
+/// The number of datapoints passed to the analysis at once.
+constexpr size_t kEncodeBlockLength = 4096;
+
+/// The VorbisEncoder class compresses samples into Ogg Vorbis streams.
+class VorbisEncoder : public SFSampleEncoder {
+public:
+  /// Constructs a new VorbisEncoder.
+  /// @param quality the variable bitrate quality.
+  explicit VorbisEncoder(float quality) noexcept :
+      quality_(quality) {
+  }
+
+  /// @copydoc SFSampleEncoder::Encode()
+  virtual std::vector<char> Encode(const SFSample & sample) const override {
+    State state;
+    if (vorbis_encode_init_vbr(&state.info, 1, long(sample.sample_rate()), quality_) != 0) {
+      throw std::runtime_error("Unable to initialize the Vorbis encoder.");
+    }
+    vorbis_analysis_init(&state.dsp, &state.info);
+    vorbis_block_init(&state.dsp, &state.block);
+
+    // Every sample is a stream of its own, so a fixed serial number keeps the output reproducible.
+    ogg_stream_init(&state.stream, 1);
+    state.initialized = true;
+
+    // Write the three header packets on pages of their own.
+    std::vector<char> output;
+    ogg_packet identification;
+    ogg_packet comment;
+    ogg_packet codebooks;
+    vorbis_analysis_headerout(&state.dsp, &state.comment, &identification, &comment, &codebooks);
+    ogg_stream_packetin(&state.stream, &identification);
+    ogg_stream_packetin(&state.stream, &comment);
+    ogg_stream_packetin(&state.stream, &codebooks);
+    ogg_page page;
+    while (ogg_stream_flush(&state.stream, &page) != 0) {
+      AppendPage(output, page);
+    }
+
+    // Feed the datapoints block by block, then mark the end of the stream.
+    const SFSampleData & data = sample.data();
+    std::vector<int16_t> buffer(kEncodeBlockLength);
+    for (size_t offset = 0; offset < data.size(); offset += kEncodeBlockLength) {
+      const size_t remaining = data.size() - offset;
+      const size_t length = remaining < kEncodeBlockLength ? remaining : kEncodeBlockLength;
+      data.Read(offset, buffer.data(), length);
+
+      float ** analysis_buffer = vorbis_analysis_buffer(&state.dsp, int(length));
+      for (size_t index = 0; index < length; index++) {
+        analysis_buffer[0][index] = buffer[index] / 32768.0f;
+      }
+      vorbis_analysis_wrote(&state.dsp, int(length));
+      Drain(state, output);
+    }
+    vorbis_analysis_wrote(&state.dsp, 0);
+    Drain(state, output);
+    return output;
+  }
+
+private:
+  /// The State struct owns the libvorbis and libogg states of an encoding.
+  struct State {
+    /// Initializes the states that need no parameters.
+    State() noexcept :
+        initialized(false) {
+      vorbis_info_init(&info);
+      vorbis_comment_init(&comment);
+    }
+
+    /// Releases every state.
+    ~State() {
+      if (initialized) {
+        ogg_stream_clear(&stream);
+        vorbis_block_clear(&block);
+        vorbis_dsp_clear(&dsp);
+      }
+      vorbis_comment_clear(&comment);
+      vorbis_info_clear(&info);
+    }
+
+    /// The encoding parameters.
+    vorbis_info info;
+
+    /// The user comments, left empty.
+    vorbis_comment comment;
+
+    /// The analysis state.
+    vorbis_dsp_state dsp;
+
+    /// The block being analyzed.
+    vorbis_block block;
+
+    /// The Ogg stream.
+    ogg_stream_state stream;
+
+    /// True if dsp, block and stream are initialized.
+    bool initialized;
+  };
+
+  /// Encodes the analyzed blocks, and appends the completed pages.
+  /// @param state the encoding state.
+  /// @param output the encoded stream.
+  static void Drain(State & state, std::vector<char> & output) {
+    while (vorbis_analysis_blockout(&state.dsp, &state.block) == 1) {
+      vorbis_analysis(&state.block, nullptr);
+      vorbis_bitrate_addblock(&state.block);
+
+      ogg_packet packet;
+      while (vorbis_bitrate_flushpacket(&state.dsp, &packet) != 0) {
+        ogg_stream_packetin(&state.stream, &packet);
+
+        ogg_page page;
+        while (ogg_stream_pageout(&state.stream, &page) != 0) {
+          AppendPage(output, page);
+        }
+      }
+    }
+  }
+
+  /// Appends an Ogg page.
+  /// @param output the encoded stream.
+  /// @param page the page.
+  static void AppendPage(std::vector<char> & output, const ogg_page & page) {
+    output.insert(output.end(), page.header, page.header + page.header_len);
+    output.insert(output.end(), page.body, page.body + page.body_len);
+  }
+
+  /// The variable bitrate quality.
+  float quality_;
+};
+
+} // namespace
+
+/// Returns true if the library is built with the Ogg Vorbis encoder.
+bool SFSampleEncoder::IsVorbisSupported() noexcept {
+  return true;
+}
+
+/// Creates an encoder that compresses samples into Ogg Vorbis streams.
+std::shared_ptr<const SFSampleEncoder> SFSampleEncoder::CreateVorbis(float quality) {
+  return std::make_shared<VorbisEncoder>(quality);
+}
+
+#else
+
+/// Returns true if the library is built with the Ogg Vorbis encoder.
+bool SFSampleEncoder::IsVorbisSupported() noexcept {
+  return false;
+}
+
+/// Creates an encoder that compresses samples into Ogg Vorbis streams.
+std::shared_ptr<const SFSampleEncoder> SFSampleEncoder::CreateVorbis(float) {
+  throw std::runtime_error("The library is built without Ogg Vorbis support.");
+}
+
+#endif
+
+} // namespace sf2cute
@@ -0,0 +1,225 @@
+/// @file
+/// SoundFont 2 Sample source class implementation.
+///
+/// @author gocha <https://github.com/gocha>
+
+#include <sf2cute/sample_source.hpp>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ios>
+#include <fstream>
+#include <stdexcept>
+
+#include "byteio.hpp"
+#include "sample_compression.hpp"
+
+namespace sf2cute {
+
+namespace {
+
+/// The FileSampleSource class reads datapoints from a range of a file.
+///
+/// The file is opened for each read, so that a bank with many sources
+/// does not hold a file descriptor for each of them.
+class FileSampleSource : public SFSampleSource {
+public:
+  /// Constructs a new FileSampleSource.
+  /// @param filename the name of the file.
+  /// @param offset the offset of the first datapoint, in terms of bytes.
+  /// @param size the number of datapoints.
+  /// @throws std::ios_base::failure The file cannot be opened.
+  FileSampleSource(const std::string & filename, uint64_t offset, size_type size) :
+      filename_(filename),
+      offset_(offset),
+      size_(size) {
+    if (!std::ifstream(filename, std::ios::binary)) {
+      throw std::ios_base::failure("Unable to open \"" + filename + "\".");
+    }
+  }
+
+  /// @copydoc SFSampleSource::size()
+  virtual size_type size() const noexcept override {
+    return size_;
+  }
+
+  /// @copydoc SFSampleSource::Read()
+  virtual void Read(size_type offset, int16_t * buffer, size_type length) const override {
+    CheckRange(offset, length);
+    if (length == 0) {
+      return;
+    }
+
+    std::ifstream in(filename_, std::ios::binary);
+    in.seekg(std::streamoff(offset_ + sizeof(int16_t) * offset));
+    in.read(reinterpret_cast<char *>(buffer), std::streamsize(sizeof(int16_t) * length));
+    if (!in) {
+      throw std::ios_base::failure("Unable to read the sample data.");
+    }
+
+    // The file stores the datapoints in little-endian order.
+    if (!IsLittleEndianHost()) {
+      for (size_type index = 0; index < length; index++) {
+        const uint16_t value = static_cast<uint16_t>(buffer[index]);
+        buffer[index] = static_cast<int16_t>((value >> 8) | (value << 8));
+      }
+    }
+  }
+
+private:
+  /// The name of the file.
+  std::string filename_;
+
+  /// The offset of the first datapoint, in terms of bytes.
+  uint64_t offset_;
+
+  /// The number of datapoints.
+  size_type size_;
+};
+
+/// The FunctionSampleSource class pulls datapoints from a function.
+class FunctionSampleSource : public SFSampleSource {
+public:
+  /// Constructs a new FunctionSampleSource.
+  /// @param size the number of datapoints.
+  /// @param read the function that reads datapoints.
+  FunctionSampleSource(size_type size, ReadFunction read) :
+      read_(std::move(read)),
+      size_(size) {
+  }
+
+  /// @copydoc SFSampleSource::size()
+  virtual size_type size() const noexcept override {
+    return size_;
+  }
+
+  /// @copydoc SFSampleSource::Read()
+  virtual void Read(size_type offset, int16_t * buffer, size_type length) const override {
+    CheckRange(offset, length);
+    if (length == 0) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    read_(offset, buffer, length);
+  }
+
+private:
+  /// The function that reads datapoints.
+  ReadFunction read_;
+
+  /// The mutex that serializes the calls to the function.
+  mutable std::mutex mutex_;
+
+  /// The number of datapoints.
+  size_type size_;
+};
+
+/// The CompressedSampleSource class holds datapoints compressed in blocks.
+class CompressedSampleSource : public SFSampleSource {
+public:
+  /// Constructs a new CompressedSampleSource.
+  /// @param data a pointer to the first datapoint.
+  /// @param size the number of datapoints.
+  CompressedSampleSource(const int16_t * data, size_type size) :
+      size_(size) {
+    const size_type num_blocks = (size + kCompressedBlockLength - 1) / kCompressedBlockLength;
+    block_offsets_.reserve(num_blocks + 1);
+    for (size_type offset = 0; offset < size; offset += kCompressedBlockLength) {
+      block_offsets_.push_back(blocks_.size());
+      CompressSampleBlock(data + offset, BlockLength(offset), blocks_);
+    }
+    block_offsets_.push_back(blocks_.size());
+
+    // The datapoints are kept for as long as the sample, so drop the spare capacity.
+    blocks_.shrink_to_fit();
+  }
+
+  /// @copydoc SFSampleSource::size()
+  virtual size_type size() const noexcept override {
+    return size_;
+  }
+
+  /// @copydoc SFSampleSource::Read()
+  virtual void Read(size_type offset, int16_t * buffer, size_type length) const override {
+    CheckRange(offset, length);
+
+    std::vector<int16_t> block;
+    const size_type end = offset + length;
+    while (offset < end) {
+      const size_type block_index = offset / kCompressedBlockLength;
+      const size_type block_start = block_index * kCompressedBlockLength;
+      const size_type block_length = BlockLength(block_start);
+      const uint8_t * block_data = blocks_.data() + block_offsets_[block_index];
+      const size_t block_size = block_offsets_[block_index + 1] - block_offsets_[block_index];
+
+      const size_type skip = offset - block_start;
+      const size_type count = std::min(block_length - skip, end - offset);
+      if (skip == 0 && count == block_length) {
+        // Decompress a whole block straight into the buffer.
+        DecompressSampleBlock(block_data, block_size, buffer, block_length);
+      }
+      else {
+        block.resize(block_length);
+        DecompressSampleBlock(block_data, block_size, block.data(), block_length);
+        std::copy_n(block.data() + skip, count, buffer);
+      }
+      buffer += count;
+      offset += count;
+    }
+  }
+
+private:
+  /// Returns the number of datapoints in the block that starts at the specified index.
+  size_type BlockLength(size_type offset) const noexcept {
+    return std::min<size_type>(size_ - offset, kCompressedBlockLength);
+  }
+
+  /// The compressed blocks.
+  std::vector<uint8_t> blocks_;
+
+  /// The offset of each block in blocks_, followed by the size of blocks_.
+  std::vector<size_t> block_offsets_;
+
+  /// The number of datapoints.
+  size_type size_;
+};
+
+} // namespace
+
+/// Creates a source that reads 16-bit little-endian datapoints from a range of a file.
+std::shared_ptr<const SFSampleSource> SFSampleSource::FromFile(const std::string & filename,
+    uint64_t offset,
+    size_type size) {
+  return std::make_shared<FileSampleSource>(filename, offset, size);
+}
+
+/// Creates a source that pulls datapoints from a function.
+std::shared_ptr<const SFSampleSource> SFSampleSource::FromFunction(size_type size,
+    ReadFunction read) {
+  if (!read) {
+    throw std::invalid_argument("The read function is empty.");
+  }
+  return std::make_shared<FunctionSampleSource>(size, std::move(read));
+}
+
+/// Creates a source that holds a losslessly compressed copy of datapoints.
+std::shared_ptr<const SFSampleSource> SFSampleSource::Compress(const int16_t * data,
+    size_type size) {
+  return std::make_shared<CompressedSampleSource>(data, size);
+}
+
+/// Checks that a range is within the source.
+void SFSampleSource::CheckRange(size_type offset, size_type length) const {
+  if (offset > size() || length > size() - offset) {
+    throw std::out_of_range("The range exceeds the length of the sample source.");
+  }
+}
+
+} // namespace sf2cute
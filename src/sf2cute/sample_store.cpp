@@ -0,0 +1,184 @@
+/// @file
+/// SoundFont 2 Sample store class implementation.
+///
+/// @author gocha <https://github.com/gocha>
+
+#include <sf2cute/sample_store.hpp>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ios>
+#include <fstream>
+#include <stdexcept>
+
+#include <sf2cute/sample_source.hpp>
+
+namespace sf2cute {
+
+/// The Source class streams the datapoints of an entry.
+class SFSampleStore::Source : public SFSampleSource {
+public:
+  /// Constructs a new Source.
+  /// @param store the store that holds the datapoints.
+  /// @param index the index of the entry.
+  /// @param size the number of datapoints.
+  Source(std::shared_ptr<SFSampleStore> store, size_t index, size_type size) noexcept :
+      store_(std::move(store)),
+      index_(index),
+      size_(size) {
+  }
+
+  /// Releases the datapoints held by the store.
+  virtual ~Source() {
+    store_->Release(index_);
+  }
+
+  /// @copydoc SFSampleSource::size()
+  virtual size_type size() const noexcept override {
+    return size_;
+  }
+
+  /// @copydoc SFSampleSource::Read()
+  virtual void Read(size_type offset, int16_t * buffer, size_type length) const override {
+    CheckRange(offset, length);
+    if (length == 0) {
+      return;
+    }
+    store_->Read(index_, offset, buffer, length);
+  }
+
+private:
+  /// The store that holds the datapoints.
+  std::shared_ptr<SFSampleStore> store_;
+
+  /// The index of the entry.
+  size_t index_;
+
+  /// The number of datapoints.
+  size_type size_;
+};
+
+/// Creates a store.
+std::shared_ptr<SFSampleStore> SFSampleStore::Create(const std::string & scratch_filename,
+    size_type memory_budget) {
+  return std::shared_ptr<SFSampleStore>(new SFSampleStore(scratch_filename, memory_budget));
+}
+
+/// Constructs a new SFSampleStore.
+SFSampleStore::SFSampleStore(std::string scratch_filename, size_type memory_budget) :
+    scratch_filename_(std::move(scratch_filename)),
+    scratch_(scratch_filename_,
+      std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc),
+    memory_budget_(memory_budget),
+    resident_size_(0),
+    spilled_size_(0),
+    oldest_resident_(0) {
+  if (!scratch_) {
+    throw std::ios_base::failure("Unable to create \"" + scratch_filename_ + "\".");
+  }
+}
+
+/// Closes and removes the scratch file.
+SFSampleStore::~SFSampleStore() {
+  scratch_.close();
+  remove(scratch_filename_.c_str());
+}
+
+/// Adds datapoints to the store.
+SFSampleData SFSampleStore::Add(std::vector<int16_t> data) {
+  const size_type size = data.size();
+  const size_type data_size = sizeof(int16_t) * size;
+
+  size_t index;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    index = entries_.size();
+    if (data_size > memory_budget_) {
+      // Datapoints larger than the budget go straight to the scratch file.
+      const uint64_t offset = Spill(data.data(), size);
+      entries_.push_back(Entry{ std::vector<int16_t>(), offset, true });
+    }
+    else {
+      SpillFor(data_size);
+      entries_.push_back(Entry{ std::move(data), 0, false });
+      resident_size_ += data_size;
+    }
+  }
+  return SFSampleData(std::make_shared<Source>(shared_from_this(), index, size));
+}
+
+/// Returns the size of the datapoints kept in memory.
+SFSampleStore::size_type SFSampleStore::resident_size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return resident_size_;
+}
+
+/// Returns the size of the datapoints spilled to the scratch file.
+uint64_t SFSampleStore::spilled_size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return spilled_size_;
+}
+
+/// Spills the oldest resident datapoints until the specified size fits in the budget.
+void SFSampleStore::SpillFor(size_type size) {
+  while (resident_size_ + size > memory_budget_ && oldest_resident_ < entries_.size()) {
+    Entry & entry = entries_[oldest_resident_++];
+    if (entry.spilled || entry.datapoints.empty()) {
+      continue;
+    }
+
+    entry.offset = Spill(entry.datapoints.data(), entry.datapoints.size());
+    entry.spilled = true;
+    resident_size_ -= sizeof(int16_t) * entry.datapoints.size();
+    std::vector<int16_t>().swap(entry.datapoints);
+  }
+}
+
+/// Appends datapoints to the scratch file.
+uint64_t SFSampleStore::Spill(const int16_t * data, size_type size) {
+  // The scratch file is read back by this store only, so the datapoints
+  // are stored in native byte order.
+  const uint64_t offset = spilled_size_;
+  scratch_.clear();
+  scratch_.seekp(std::streamoff(offset));
+  scratch_.write(reinterpret_cast<const char *>(data), std::streamsize(sizeof(int16_t) * size));
+  if (!scratch_) {
+    throw std::ios_base::failure("Unable to write \"" + scratch_filename_ + "\".");
+  }
+  spilled_size_ += sizeof(int16_t) * size;
+  return offset;
+}
+
+/// Reads the datapoints of an entry.
+void SFSampleStore::Read(size_t index, size_type offset, int16_t * buffer, size_type length) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const Entry & entry = entries_[index];
+  if (!entry.spilled) {
+    std::copy_n(entry.datapoints.data() + offset, length, buffer);
+    return;
+  }
+
+  scratch_.clear();
+  scratch_.seekg(std::streamoff(entry.offset + sizeof(int16_t) * offset));
+  scratch_.read(reinterpret_cast<char *>(buffer), std::streamsize(sizeof(int16_t) * length));
+  if (!scratch_) {
+    throw std::ios_base::failure("Unable to read \"" + scratch_filename_ + "\".");
+  }
+}
+
+/// Releases the resident datapoints of an entry that is no longer used.
+void SFSampleStore::Release(size_t index) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Entry & entry = entries_[index];
+  resident_size_ -= sizeof(int16_t) * entry.datapoints.size();
+  std::vector<int16_t>().swap(entry.datapoints);
+}
+
+} // namespace sf2cute
@@ -0,0 +1,78 @@
+/// @file
+/// SoundFont 2 Shard manifest class implementation.
+///
+/// @author gocha <https://github.com/gocha>
+
+#include <sf2cute/shard_manifest.hpp>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+
+namespace sf2cute {
+
+/// Appends a shard file.
+void SFShardManifest::AddFile(std::string filename) {
+  filenames_.push_back(std::move(filename));
+}
+
+/// Appends the location of a preset.
+void SFShardManifest::AddEntry(Entry entry) {
+  if (entry.shard >= filenames_.size()) {
+    throw std::out_of_range("The shard index is not the index of a file.");
+  }
+  entries_.push_back(std::move(entry));
+}
+
+/// Finds the shard that contains the specified preset.
+size_t SFShardManifest::Find(uint16_t bank, uint16_t preset_number) const noexcept {
+  for (const auto & entry : entries_) {
+    if (entry.bank == bank && entry.preset_number == preset_number) {
+      return entry.shard;
+    }
+  }
+  return npos;
+}
+
+/// Writes the manifest as tab-separated text.
+void SFShardManifest::Write(std::ostream & out) const {
+  // Save exception bits of output stream.
+  const std::ios_base::iostate old_exception_bits = out.exceptions();
+  // Set exception bits to get output error as an exception.
+  out.exceptions(std::ios::badbit | std::ios::failbit);
+
+  try {
+    out << "bank\tpreset\tfile\tname\n";
+    for (const auto & entry : entries_) {
+      out << entry.bank << '\t' << entry.preset_number << '\t'
+        << filenames_[entry.shard] << '\t' << entry.name << '\n';
+    }
+  }
+  catch (const std::exception &) {
+    // Recover exception bits of output stream.
+    out.exceptions(old_exception_bits);
+
+    // Rethrow the exception.
+    throw;
+  }
+
+  // Recover exception bits of output stream.
+  out.exceptions(old_exception_bits);
+}
+
+/// Writes the manifest as tab-separated text to a file.
+void SFShardManifest::Write(const std::string & filename) const {
+  std::ofstream out;
+
+  out.exceptions(std::ios::badbit | std::ios::failbit);
+  out.open(filename);
+
+  Write(out);
+}
+
+} // namespace sf2cute
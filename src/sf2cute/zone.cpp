@@ -11,6 +11,7 @@
 #include <vector>
 
 #include <sf2cute/generator_item.hpp>
+#include <sf2cute/generator_set.hpp>
 #include <sf2cute/modulator_item.hpp>
 
 namespace sf2cute {
@@ -24,7 +25,6 @@ SFZone::SFZone(
     std::vector<SFGeneratorItem> generators,
     std::vector<SFModulatorItem> modulators) {
   // Set generators.
-  generators_.reserve(generators.size());
   for (auto && generator : generators) {
     SetGenerator(std::move(generator));
   }
@@ -37,13 +37,8 @@ SFZone::SFZone(
 }
 
 /// Constructs a new copy of specified SFZone.
-SFZone::SFZone(const SFZone & origin) {
-  // Copy generators.
-  generators_.reserve(origin.generators().size());
-  for (const auto & generator : origin.generators()) {
-    generators_.push_back(std::make_unique<SFGeneratorItem>(*generator));
-  }
-
+SFZone::SFZone(const SFZone & origin) :
+    generators_(origin.generators_) {
   // Copy modulators.
   modulators_.reserve(origin.modulators().size());
   for (const auto & modulator : origin.modulators()) {
@@ -54,11 +49,7 @@ SFZone::SFZone(const SFZone & origin) {
 /// Copy-assigns a new value to the SFZone, replacing its current contents.
 SFZone & SFZone::operator=(const SFZone & origin) {
   // Copy generators.
-  generators_.clear();
-  generators_.reserve(origin.generators().size());
-  for (const auto & generator : origin.generators()) {
-    generators_.push_back(std::make_unique<SFGeneratorItem>(*generator));
-  }
+  generators_ = origin.generators_;
 
   // Copy modulators.
   modulators_.clear();
@@ -72,38 +63,21 @@ SFZone & SFZone::operator=(const SFZone & origin) {
 
 /// Sets a generator to the zone.
 void SFZone::SetGenerator(SFGeneratorItem generator) {
-  // Find the generator.
-  const auto it = FindGenerator(generator.op());
-  if (it == generators_.end()) {
-    generators_.push_back(std::make_unique<SFGeneratorItem>(std::move(generator)));
-  }
-  else {
-    const std::unique_ptr<SFGeneratorItem> & old_generator = *it;
-    *old_generator = std::move(generator);
-  }
-}
-
-/// Finds the generator which is the specified type.
-const std::vector<std::unique_ptr<SFGeneratorItem>>::const_iterator
-    SFZone::FindGenerator(SFGenerator op) const {
-  return std::find_if(generators_.begin(), generators_.end(),
-    [&op](const std::unique_ptr<SFGeneratorItem> & generator) {
-      return generator->op() == op;
-    });
+  generators_.Set(generator);
 }
 
 /// Removes generators from the zone.
 void SFZone::RemoveGeneratorIf(
-    std::function<bool(const std::unique_ptr<SFGeneratorItem> &)> predicate) {
-  generators_.erase(std::remove_if(generators_.begin(), generators_.end(),
-    [&predicate](const std::unique_ptr<SFGeneratorItem> & generator) -> bool {
+    std::function<bool(const SFGeneratorItem &)> predicate) {
+  auto it = generators_.begin();
+  while (it != generators_.end()) {
+    // Copy the generator before advancing, since the iterator caches it.
+    const SFGeneratorItem generator = *it;
+    ++it;
     if (predicate(generator)) {
-      return true;
+      generators_.Remove(generator.op());
     }
-    else {
-      return false;
-    }
-  }), generators_.end());
+  }
 }
 
 /// Sets a modulator to the zone.